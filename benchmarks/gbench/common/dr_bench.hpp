@@ -101,6 +101,7 @@ extern std::size_t stencil_steps;
 extern std::size_t num_rows;
 extern std::size_t num_columns;
 extern bool check_results;
+extern std::string sparse_matrix_file;
 
 #endif
 
@@ -0,0 +1,61 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+using T = double;
+
+static void GenerateRandom_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> a(default_vector_size);
+  std::uniform_real_distribution<T> dist(0, 100);
+  Stats stats(state, 0, sizeof(T) * a.size());
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::generate_random(a, dist, i);
+    }
+  }
+  T value = a[a.size() / 2];
+  if (check_results && (value < 0 || value >= 100)) {
+    state.SkipWithError("generate_random: value out of range");
+  }
+}
+
+DR_BENCHMARK(GenerateRandom_DR);
+
+static void GenerateRandomNormal_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> a(default_vector_size);
+  std::normal_distribution<T> dist(0, 1);
+  Stats stats(state, 0, sizeof(T) * a.size());
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::generate_random(a, dist, i);
+    }
+  }
+}
+
+DR_BENCHMARK(GenerateRandomNormal_DR);
+
+// Serial fill of a local vector, as the benchmarks used to do
+static void GenerateRandom_Serial(benchmark::State &state) {
+  std::vector<T> a(default_vector_size);
+  std::mt19937 gen(0);
+  std::uniform_real_distribution<T> dist(0, 100);
+  Stats stats(state, 0, sizeof(T) * a.size());
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      for (auto &x : a) {
+        x = dist(gen);
+      }
+      benchmark::DoNotOptimize(a.data());
+    }
+  }
+}
+
+DR_BENCHMARK(GenerateRandom_Serial);
@@ -19,13 +19,7 @@ protected:
 public:
   void SetUp(::benchmark::State &) {
     a = new xhp::distributed_vector<T>(default_vector_size);
-    std::vector<T> local(default_vector_size);
-    fill_random(local);
-#ifdef BENCH_SHP
-    xhp::copy(local.begin(), local.end(), rng::begin(*a));
-#else
-    xhp::copy(local, rng::begin(*a));
-#endif
+    xhp::generate_random(*a, std::uniform_real_distribution<T>(0, 100), 0);
   }
 
   void TearDown(::benchmark::State &) { delete a; }
@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+#include <random>
+
+using T = double;
+
+// Every rank makes default_vector_size / ranks updates. The number of
+// destinations controls how often updates conflict.
+static void AccumulateAt(benchmark::State &state, std::size_t destinations) {
+  xhp::distributed_vector<T> dv(destinations);
+  xhp::fill(dv, 0);
+  std::vector<std::size_t> indices(default_vector_size / ranks);
+  std::vector<T> values(indices.size(), 1);
+  std::mt19937_64 gen(comm_rank);
+  std::uniform_int_distribution<std::size_t> dist(0, destinations - 1);
+  for (auto &index : indices) {
+    index = dist(gen);
+  }
+
+  Stats stats(state, sizeof(T) * indices.size() * ranks,
+              sizeof(T) * indices.size() * ranks);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::accumulate_at(dv, indices, values);
+    }
+  }
+}
+
+static void AccumulateAt_Sparse_DR(benchmark::State &state) {
+  AccumulateAt(state, default_vector_size);
+}
+
+DR_BENCHMARK(AccumulateAt_Sparse_DR);
+
+static void AccumulateAt_Dense_DR(benchmark::State &state) {
+  AccumulateAt(state, std::max(default_vector_size / 1000, std::size_t(100)));
+}
+
+DR_BENCHMARK(AccumulateAt_Dense_DR);
+
+static void Histogram_DR(benchmark::State &state) {
+  int nbins = 1000;
+  xhp::distributed_vector<int> dv(default_vector_size);
+  xhp::iota(dv, 0);
+  xhp::for_each(dv, [=](auto &v) { v = v % nbins * 7919 % nbins; });
+  xhp::distributed_vector<int> bins(nbins);
+
+  Stats stats(state, sizeof(int) * dv.size(), sizeof(int) * bins.size());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::fill(bins, 0);
+      xhp::histogram(dv, bins);
+    }
+  }
+
+  if (check_results && xhp::reduce(bins) != int(dv.size())) {
+    state.SkipWithError("histogram: wrong total count");
+  }
+}
+
+DR_BENCHMARK(Histogram_DR);
@@ -125,3 +125,52 @@ static void ChunkTransformFlatten_ForEach_Serial(benchmark::State &state) {
 }
 
 DR_BENCHMARK(ChunkTransformFlatten_ForEach_Serial);
+
+// Same operation as Chunk_2DLoop_Serial, with md_for_each on the
+// local tiles of distributed mdarrays
+static void Chunk_MdForEach_DR(benchmark::State &state) {
+  std::array<std::size_t, 2> shape = {num_rows, num_columns};
+  xhp::distributed_mdarray<T, 2> a(shape), b(shape);
+  xhp::fill(a, init_val);
+  auto op = [](auto v) {
+    auto &[in, out] = v;
+    out = in * 2.0;
+  };
+
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * b.size());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::for_each(op, a, b);
+    }
+  }
+  if (check_results && T(b[0]) != 2 * init_val) {
+    state.SkipWithError("md for_each: wrong result");
+  }
+}
+
+DR_BENCHMARK(Chunk_MdForEach_DR);
+
+// Same operation, with the global index of every element
+static void Chunk_MdForEachIndexed_DR(benchmark::State &state) {
+  std::array<std::size_t, 2> shape = {num_rows, num_columns};
+  xhp::distributed_mdarray<T, 2> a(shape), b(shape);
+  xhp::fill(a, init_val);
+  auto op = [](auto index, auto v) {
+    auto &[in, out] = v;
+    out = in * 2.0 + T(index[1]);
+  };
+
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * b.size());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::for_each(op, a, b);
+    }
+  }
+  if (check_results && T(b[1]) != 2 * init_val + 1) {
+    state.SkipWithError("md for_each: wrong result");
+  }
+}
+
+DR_BENCHMARK(Chunk_MdForEachIndexed_DR);
@@ -0,0 +1,51 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+using T = double;
+
+// Half of the elements are kept, so most of the output moves to
+// another rank
+static void CopyIf_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> a(default_vector_size), b(default_vector_size);
+  xhp::iota(a, 0);
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * a.size() / 2);
+  auto even = [](T x) { return std::int64_t(x) % 2 == 0; };
+
+  std::size_t count = 0;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      count = xhp::copy_if(a, b.begin(), even) - b.begin();
+      benchmark::DoNotOptimize(count);
+    }
+  }
+  if (check_results && count != (a.size() + 1) / 2) {
+    state.SkipWithError("copy_if: wrong result");
+  }
+}
+
+DR_BENCHMARK(CopyIf_DR);
+
+static void Partition_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> a(default_vector_size);
+  xhp::iota(a, 0);
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * a.size());
+  auto even = [](T x) { return std::int64_t(x) % 2 == 0; };
+
+  std::size_t count = 0;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      count = xhp::partition(a, even) - a.begin();
+      benchmark::DoNotOptimize(count);
+    }
+  }
+  if (check_results && count != (a.size() + 1) / 2) {
+    state.SkipWithError("partition: wrong result");
+  }
+}
+
+DR_BENCHMARK(Partition_DR);
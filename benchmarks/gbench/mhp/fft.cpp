@@ -0,0 +1,43 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+using T = std::complex<double>;
+
+static void Fft3D_DR(benchmark::State &state) {
+  // Cube with about default_vector_size elements
+  std::size_t n = std::max(
+      std::size_t(std::cbrt(double(default_vector_size))), std::size_t(2));
+  std::array<std::size_t, 3> shape = {n, n, n};
+  xhp::distributed_mdarray<T, 3> a(shape), b(shape);
+  xhp::fill(a, T(1, 0));
+
+  double elements = double(n) * n * n;
+  // A forward and a backward transform, each reads and writes every
+  // element twice, and 5 N log2(N) flops per transform
+  Stats stats(state, 4 * sizeof(T) * a.size(), 4 * sizeof(T) * a.size(),
+              std::size_t(10 * elements * std::log2(elements)));
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::fft(a, b);
+      xhp::fft(b, a, false);
+    }
+  }
+
+  if (check_results) {
+    auto ma = a.mdspan();
+    for (std::size_t i = 0; i < n; i += 3) {
+      for (std::size_t j = 0; j < n; j += 5) {
+        if (std::abs(T(ma(i, j, 0)) - T(1, 0)) > 1e-9) {
+          state.SkipWithError("fft: wrong result");
+          return;
+        }
+      }
+    }
+  }
+}
+
+DR_BENCHMARK(Fft3D_DR);
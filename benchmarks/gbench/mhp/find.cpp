@@ -0,0 +1,52 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+using T = double;
+
+// The only match is in the first segment, so the other ranks can stop
+// early
+static void AnyOf_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> a(default_vector_size);
+  xhp::iota(a, 0);
+  Stats stats(state, sizeof(T) * a.size(), 0);
+  auto hit = [](T x) { return x == 10; };
+
+  bool found = false;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      found = xhp::any_of(a, hit);
+      benchmark::DoNotOptimize(found);
+    }
+  }
+  if (check_results && !found) {
+    state.SkipWithError("any_of: wrong result");
+  }
+}
+
+DR_BENCHMARK(AnyOf_DR);
+
+// Same search with a reduce, which tests every element
+static void AnyOf_Reduce_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> a(default_vector_size);
+  xhp::iota(a, 0);
+  Stats stats(state, sizeof(T) * a.size(), 0);
+  auto hit = [](T x) { return x == 10 ? 1 : 0; };
+
+  int found = 0;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      found = xhp::reduce(a | xhp::views::transform(hit), 0);
+      benchmark::DoNotOptimize(found);
+    }
+  }
+  if (check_results && !found) {
+    state.SkipWithError("any_of: wrong result");
+  }
+}
+
+DR_BENCHMARK(AnyOf_Reduce_DR);
@@ -0,0 +1,111 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+#include <random>
+
+using T = double;
+
+// Random indices into the whole table. Every rank does an equal share
+// of the lookups.
+static auto random_indices(std::size_t n) {
+  std::vector<std::size_t> indices(n / ranks);
+  std::mt19937_64 gen(comm_rank);
+  std::uniform_int_distribution<std::size_t> dist(0, n - 1);
+  for (auto &index : indices) {
+    index = dist(gen);
+  }
+  return indices;
+}
+
+static void Gather_Random_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> table(default_vector_size);
+  xhp::iota(table, 0);
+  auto indices = random_indices(default_vector_size);
+  std::vector<T> values(indices.size());
+
+  Stats stats(state, sizeof(T) * indices.size() * ranks,
+              sizeof(T) * indices.size() * ranks);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::gather(table, indices, values.begin());
+    }
+  }
+
+  if (check_results) {
+    for (std::size_t i = 0; i < indices.size(); i++) {
+      if (values[i] != T(indices[i])) {
+        state.SkipWithError("gather: wrong value");
+        break;
+      }
+    }
+  }
+}
+
+DR_BENCHMARK(Gather_Random_DR);
+
+static void Scatter_Random_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> table(default_vector_size);
+  auto indices = random_indices(default_vector_size);
+  std::vector<T> values(indices.size());
+  rng::iota(values, 0);
+
+  Stats stats(state, sizeof(T) * indices.size() * ranks,
+              sizeof(T) * indices.size() * ranks);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::scatter(values, indices, table);
+    }
+  }
+}
+
+DR_BENCHMARK(Scatter_Random_DR);
+
+// Element-at-a-time remote reads, for comparison with the batched
+// gather
+static void Gather_Random_Get(benchmark::State &state) {
+  xhp::distributed_vector<T> table(default_vector_size);
+  xhp::iota(table, 0);
+  // Keep the number of one-sided gets small enough to finish
+  auto indices =
+      random_indices(std::min(default_vector_size, std::size_t(100000)));
+  std::vector<T> values(indices.size());
+
+  Stats stats(state, sizeof(T) * indices.size() * ranks,
+              sizeof(T) * indices.size() * ranks);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      for (std::size_t j = 0; j < indices.size(); j++) {
+        values[j] = table[indices[j]];
+      }
+      xhp::barrier();
+    }
+  }
+}
+
+DR_BENCHMARK(Gather_Random_Get);
+
+static void Gather_Random_Serial(benchmark::State &state) {
+  std::vector<T> table(default_vector_size);
+  rng::iota(table, 0);
+  auto indices = random_indices(default_vector_size * ranks);
+  std::vector<T> values(indices.size());
+
+  Stats stats(state, sizeof(T) * indices.size(), sizeof(T) * indices.size());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      for (std::size_t j = 0; j < indices.size(); j++) {
+        values[j] = table[indices[j]];
+      }
+      benchmark::DoNotOptimize(values);
+    }
+  }
+}
+
+DR_BENCHMARK(Gather_Random_Serial);
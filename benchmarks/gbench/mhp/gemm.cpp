@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+#include "mkl.h"
+
+using T = double;
+
+// The problem size does not depend on the number of ranks, for strong
+// scaling
+const std::size_t m = 4096;
+const std::size_t n = m;
+const std::size_t k = m;
+
+template <typename F>
+static void fill_matrix(xhp::distributed_dense_matrix<T> &x, F value) {
+  auto local = x.local_mdspan();
+  for (std::size_t i = 0; i < local.extent(0); i++) {
+    for (std::size_t j = 0; j < local.extent(1); j++) {
+      auto index = x.global_index({i, j});
+      local(i, j) = value(index[0], index[1]);
+    }
+  }
+}
+
+static void Gemm_DR(benchmark::State &state) {
+  xhp::distributed_dense_matrix<T> a({m, k}), b({k, n}), c({m, n});
+  fill_matrix(a, [](auto i, auto j) { return T((i + j) % 7); });
+  // Identity, so c == a
+  fill_matrix(b, [](auto i, auto j) { return T(i == j); });
+
+  Stats stats(state, (m * k + k * n) * sizeof(T), m * n * sizeof(T),
+              2 * m * n * k);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::gemm(a, b, c);
+    }
+  }
+
+  if (check_results) {
+    auto local = c.local_mdspan();
+    for (std::size_t i = 0; i < local.extent(0); i += 7) {
+      for (std::size_t j = 0; j < local.extent(1); j += 5) {
+        auto index = c.global_index({i, j});
+        if (local(i, j) != T((index[0] + index[1]) % 7)) {
+          state.SkipWithError("gemm: wrong result");
+          return;
+        }
+      }
+    }
+  }
+}
+
+DR_BENCHMARK(Gemm_DR);
+
+// MKL on one rank, the baseline for strong scaling
+static void Gemm_Reference(benchmark::State &state) {
+  std::vector<T> a(m * k), b(k * n), c(m * n);
+  for (std::size_t i = 0; i < m * k; i++) {
+    a[i] = T(i % 7);
+  }
+  std::fill(b.begin(), b.end(), T(1));
+
+  Stats stats(state, (m * k + k * n) * sizeof(T), m * n * sizeof(T),
+              2 * m * n * k);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      cblas_dgemm(CblasRowMajor, CblasNoTrans, CblasNoTrans, m, n, k, 1,
+                  a.data(), k, b.data(), n, 0, c.data(), n);
+    }
+  }
+}
+
+DR_BENCHMARK(Gemm_Reference);
@@ -0,0 +1,81 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+#include <cmath>
+
+using T = double;
+using I = long;
+
+// 5-point Laplacian on a square grid with about default_vector_size
+// points. Every rank generates only its own rows. Returns the matrix
+// and the local part of sum(A * iota) for checking.
+static auto laplacian_2d() {
+  std::size_t side = std::sqrt(default_vector_size);
+  std::size_t n = side * side;
+  std::size_t block = (n + ranks - 1) / ranks;
+  std::size_t first = std::min(comm_rank * block, n);
+  std::size_t last = std::min(first + block, n);
+
+  std::vector<std::tuple<std::size_t, std::size_t, T>> entries;
+  T local_sum = 0;
+  auto add = [&](std::size_t i, std::size_t j, T v) {
+    entries.emplace_back(i, j, v);
+    local_sum += v * j;
+  };
+  for (std::size_t i = first; i < last; i++) {
+    std::size_t row = i / side, column = i % side;
+    add(i, i, 4);
+    if (row > 0) {
+      add(i, i - side, -1);
+    }
+    if (row < side - 1) {
+      add(i, i + side, -1);
+    }
+    if (column > 0) {
+      add(i, i - 1, -1);
+    }
+    if (column < side - 1) {
+      add(i, i + 1, -1);
+    }
+  }
+
+  return std::pair(std::make_unique<xhp::sparse_matrix<T, I>>(
+                       dr::index<std::size_t>(n, n), entries),
+                   local_sum);
+}
+
+static void Gemv_DR(benchmark::State &state) {
+  std::unique_ptr<xhp::sparse_matrix<T, I>> a;
+  T local_sum = 0;
+  if (sparse_matrix_file.empty()) {
+    std::tie(a, local_sum) = laplacian_2d();
+  } else {
+    a = std::make_unique<xhp::sparse_matrix<T, I>>(
+        xhp::mmread<T, I>(sparse_matrix_file));
+  }
+  auto [m, n] = a->shape();
+  xhp::distributed_vector<T> x(n), y(m);
+  xhp::iota(x, 0);
+
+  Stats stats(state, (sizeof(T) + sizeof(I)) * a->nnz() + sizeof(T) * n,
+              sizeof(T) * m, 2 * a->nnz());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::gemv(y, *a, x);
+    }
+  }
+
+  if (check_results && sparse_matrix_file.empty()) {
+    T expected = 0;
+    MPI_Allreduce(&local_sum, &expected, 1, MPI_DOUBLE, MPI_SUM, comm);
+    if (std::abs(xhp::reduce(y) - expected) > 1e-6 * std::abs(expected)) {
+      state.SkipWithError("gemv: wrong result");
+    }
+  }
+}
+
+DR_BENCHMARK(Gemv_DR);
@@ -0,0 +1,162 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+#include <cmath>
+
+using T = double;
+using I = long;
+
+// R-MAT parameters from Graph500
+const double rmat_a = 0.57, rmat_b = 0.19, rmat_c = 0.19;
+const std::size_t edge_factor = 16;
+
+static std::uint64_t xorshift(std::uint64_t &state) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return state;
+}
+
+// Bijection on [0, n) for n a power of 2
+static std::size_t scramble(std::size_t v, std::size_t n) {
+  return (v * 0x9E3779B97F4A7C15ull + 12345) & (n - 1);
+}
+
+// Undirected R-MAT graph with a power of 2 vertices and at most
+// default_vector_size / 4 edges. Every rank generates the same edges
+// and keeps the rows it owns. Vertex numbers are scrambled so high
+// degree vertices are spread over the ranks.
+static xhp::sparse_matrix<T, I> &rmat_graph() {
+  static std::unique_ptr<xhp::sparse_matrix<T, I>> graph;
+  if (graph) {
+    return *graph;
+  }
+
+  std::size_t scale = 4;
+  while ((4 * edge_factor) << (scale + 1) <= default_vector_size) {
+    scale++;
+  }
+  std::size_t n = std::size_t(1) << scale;
+  std::size_t block = (n + ranks - 1) / ranks;
+  std::size_t first = std::min(comm_rank * block, n);
+  std::size_t last = std::min(first + block, n);
+
+  std::vector<std::tuple<std::size_t, std::size_t, T>> entries;
+  std::uint64_t state = 0x2545F4914F6CDD1Dull;
+  for (std::size_t e = 0; e < edge_factor * n; e++) {
+    std::size_t i = 0, j = 0;
+    std::uint64_t bits = 0;
+    for (std::size_t level = 0; level < scale; level++) {
+      // 16 random bits per level
+      if (level % 4 == 0) {
+        bits = xorshift(state);
+      }
+      double r = double(bits & 0xFFFF) / 65536;
+      bits >>= 16;
+      i = 2 * i + (r >= rmat_a + rmat_b);
+      j = 2 * j + ((r >= rmat_a && r < rmat_a + rmat_b) ||
+                   r >= rmat_a + rmat_b + rmat_c);
+    }
+    i = scramble(i, n);
+    j = scramble(j, n);
+    if (i == j) {
+      continue;
+    }
+    if (i >= first && i < last) {
+      entries.emplace_back(i, j, 1);
+    }
+    if (j >= first && j < last) {
+      entries.emplace_back(j, i, 1);
+    }
+  }
+
+  graph = std::make_unique<xhp::sparse_matrix<T, I>>(
+      dr::index<std::size_t>(n, n), entries);
+  return *graph;
+}
+
+// Traversed edges per second, counting each undirected edge once
+static void teps(benchmark::State &state, std::size_t edges,
+                 std::size_t runs) {
+  state.counters["teps"] =
+      benchmark::Counter(double(edges) * runs, benchmark::Counter::kIsRate);
+}
+
+static void Bfs_DR(benchmark::State &state) {
+  auto &a = rmat_graph();
+  std::size_t n = a.shape()[0];
+  xhp::distributed_vector<std::size_t> levels(n);
+  // Highest degree vertex before scrambling
+  std::size_t source = scramble(0, n);
+
+  Stats stats(state, (sizeof(T) + sizeof(I)) * a.nnz(),
+              sizeof(std::size_t) * n);
+  std::size_t runs = 0;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::bfs(a, source, levels);
+      runs++;
+    }
+  }
+  teps(state, a.nnz() / 2, runs);
+
+  if (check_results && levels[source] != 0) {
+    state.SkipWithError("bfs: wrong result");
+  }
+}
+
+DR_BENCHMARK(Bfs_DR);
+
+static void PageRank_DR(benchmark::State &state) {
+  auto &a = rmat_graph();
+  std::size_t n = a.shape()[0];
+  xhp::distributed_vector<T> pr(n);
+  // Fixed number of iterations, so every run does the same work
+  const std::size_t iterations = 20;
+
+  Stats stats(state, (sizeof(T) + sizeof(I)) * a.nnz() * iterations,
+              sizeof(T) * n * iterations, 2 * a.nnz() * iterations);
+  std::size_t runs = 0;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::pagerank(a, pr, 0.85, 0.0, iterations);
+      runs++;
+    }
+  }
+  teps(state, a.nnz() * iterations, runs);
+
+  if (check_results && std::abs(xhp::reduce(pr) - 1) > 1e-6) {
+    state.SkipWithError("pagerank: wrong result");
+  }
+}
+
+DR_BENCHMARK(PageRank_DR);
+
+static void ConnectedComponents_DR(benchmark::State &state) {
+  auto &a = rmat_graph();
+  std::size_t n = a.shape()[0];
+  xhp::distributed_vector<std::size_t> components(n);
+
+  Stats stats(state, (sizeof(T) + sizeof(I)) * a.nnz(),
+              sizeof(std::size_t) * n);
+  std::size_t runs = 0, count = 0;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      count = xhp::connected_components(a, components);
+      runs++;
+    }
+  }
+  teps(state, a.nnz() / 2, runs);
+
+  if (check_results && (count == 0 || components[0] != 0)) {
+    state.SkipWithError("connected components: wrong result");
+  }
+}
+
+DR_BENCHMARK(ConnectedComponents_DR);
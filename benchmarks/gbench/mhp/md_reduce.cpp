@@ -0,0 +1,53 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+using T = double;
+
+// Reduction along the distributed axis, which combines the ranks, and
+// along the local axis
+static void ReduceAxis_DR(benchmark::State &state) {
+  std::size_t axis = state.range(0);
+  std::array<std::size_t, 2> shape = {num_rows, num_columns};
+  xhp::distributed_mdarray<T, 2> a(shape);
+  xhp::fill(a, 1);
+  std::size_t out_size = axis == 0 ? num_columns : num_rows;
+
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * out_size);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      auto sums = xhp::reduce(a, xhp::axis{axis});
+      if (check_results && i == 0 && T(sums[0]) != T(shape[axis])) {
+        state.SkipWithError("reduce: wrong result");
+        return;
+      }
+    }
+  }
+}
+
+DR_BENCHMARK(ReduceAxis_DR)->Arg(0)->Arg(1);
+
+static void ScanAxis_DR(benchmark::State &state) {
+  std::size_t axis = state.range(0);
+  std::array<std::size_t, 2> shape = {num_rows, num_columns};
+  xhp::distributed_mdarray<T, 2> a(shape);
+  xhp::fill(a, 1);
+
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * a.size());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      auto sums = xhp::scan(a, xhp::axis{axis});
+      if (check_results && i == 0 &&
+          T(sums.mdspan()(num_rows - 1, num_columns - 1)) != T(shape[axis])) {
+        state.SkipWithError("scan: wrong result");
+        return;
+      }
+    }
+  }
+}
+
+DR_BENCHMARK(ScanAxis_DR)->Arg(0)->Arg(1);
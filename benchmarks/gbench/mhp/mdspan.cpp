@@ -22,3 +22,126 @@ static void MdspanUtil_Pack(benchmark::State &state) {
 }
 
 DR_BENCHMARK(MdspanUtil_Pack);
+
+static void MdspanUtil_PackBlocked(benchmark::State &state) {
+  std::vector<T> a(num_rows * num_columns);
+  std::vector<T> b(num_rows * num_columns);
+
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * b.size());
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      dr::__detail::mdspan_pack(
+          md::mdspan(a.data(), std::array{num_rows, num_columns}), b.data());
+    }
+  }
+}
+
+DR_BENCHMARK(MdspanUtil_PackBlocked);
+
+// Pack with the derived datatype that a halo sends without packing
+static void MdspanUtil_PackDatatype(benchmark::State &state) {
+  std::vector<T> a(num_rows * num_columns);
+  std::vector<T> b(num_rows * num_columns);
+  auto type = dr::mhp::__detail::mdspan_datatype(
+      md::mdspan(a.data(), std::array{num_rows, num_columns}));
+
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * b.size());
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      int position = 0;
+      MPI_Pack(a.data(), 1, type, b.data(), sizeof(T) * b.size(), &position,
+               MPI_COMM_SELF);
+    }
+  }
+  MPI_Type_free(&type);
+}
+
+DR_BENCHMARK(MdspanUtil_PackDatatype);
+
+// Face of a halo across the last dimension: the first width columns
+// after the border column of a num_rows x num_columns array. The face
+// is strided, so every packer has to gather it.
+static auto column_face(std::vector<T> &a, std::size_t width) {
+  auto mdspan = md::mdspan(a.data(), std::array{num_rows, num_columns});
+  return dr::__detail::make_submdspan(mdspan, std::array<std::size_t, 2>{0, 1},
+                                      std::array{num_rows, 1 + width});
+}
+
+static bool check_width(benchmark::State &state, std::size_t width) {
+  if (width + 1 > num_columns) {
+    state.SkipWithError("Face is wider than the array");
+    return false;
+  }
+  return true;
+}
+
+static void MdspanUtil_PackFace(benchmark::State &state) {
+  std::size_t width = state.range(0);
+  if (!check_width(state, width)) {
+    return;
+  }
+  std::vector<T> a(num_rows * num_columns);
+  std::vector<T> b(num_rows * width);
+  auto face = column_face(a, width);
+
+  Stats stats(state, sizeof(T) * rng::size(b), sizeof(T) * rng::size(b));
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      dr::__detail::mdspan_copy(face, b.begin());
+    }
+  }
+}
+
+DR_BENCHMARK(MdspanUtil_PackFace)->Arg(1)->Arg(4);
+
+static void MdspanUtil_PackFaceBlocked(benchmark::State &state) {
+  std::size_t width = state.range(0);
+  if (!check_width(state, width)) {
+    return;
+  }
+  std::vector<T> a(num_rows * num_columns);
+  std::vector<T> b(num_rows * width);
+  auto face = column_face(a, width);
+
+  Stats stats(state, sizeof(T) * rng::size(b), sizeof(T) * rng::size(b));
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      dr::__detail::mdspan_pack(face, b.data());
+    }
+  }
+}
+
+DR_BENCHMARK(MdspanUtil_PackFaceBlocked)->Arg(1)->Arg(4);
+
+static void MdspanUtil_PackFaceDatatype(benchmark::State &state) {
+  std::size_t width = state.range(0);
+  if (!check_width(state, width)) {
+    return;
+  }
+  std::vector<T> a(num_rows * num_columns);
+  std::vector<T> b(num_rows * width);
+  auto face = column_face(a, width);
+  auto type = dr::mhp::__detail::mdspan_datatype(face);
+
+  Stats stats(state, sizeof(T) * rng::size(b), sizeof(T) * rng::size(b));
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      int position = 0;
+      MPI_Pack(face.data_handle(), 1, type, b.data(), sizeof(T) * rng::size(b),
+               &position, MPI_COMM_SELF);
+    }
+  }
+  MPI_Type_free(&type);
+}
+
+DR_BENCHMARK(MdspanUtil_PackFaceDatatype)->Arg(1)->Arg(4);
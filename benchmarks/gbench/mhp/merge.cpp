@@ -0,0 +1,49 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+using T = double;
+
+static void Merge_DR(benchmark::State &state) {
+  std::size_t n = default_vector_size / 2;
+  xhp::distributed_vector<T> a(n), b(n), c(2 * n);
+  xhp::iota(a, 0);
+  xhp::iota(b, 0);
+  Stats stats(state, sizeof(T) * 2 * n, sizeof(T) * 2 * n);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::merge(a, b, c.begin());
+    }
+  }
+  if (check_results && (T(c[0]) != 0 || T(c[2 * n - 1]) != T(n - 1))) {
+    state.SkipWithError("merge: wrong result");
+  }
+}
+
+DR_BENCHMARK(Merge_DR);
+
+// The boundary values cached by sort send every search to one rank
+static void LowerBound_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> a(default_vector_size);
+  xhp::iota(a, 0);
+  xhp::sort(a);
+  Stats stats(state, 0, 0);
+
+  std::size_t position = 0;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      position = xhp::lower_bound(a, T(a.size() / 3)) - a.begin();
+      benchmark::DoNotOptimize(position);
+    }
+  }
+  if (check_results && position != a.size() / 3) {
+    state.SkipWithError("lower_bound: wrong result");
+  }
+}
+
+DR_BENCHMARK(LowerBound_DR);
@@ -15,6 +15,7 @@ std::size_t num_rows;
 std::size_t num_columns;
 bool check_results;
 bool weak_scaling;
+std::string sparse_matrix_file;
 
 cxxopts::ParseResult options;
 
@@ -79,6 +80,7 @@ int main(int argc, char *argv[]) {
     ("different-devices", "ensure no multiple ranks on one device")
 #endif
     ("reps", "Debug repetitions for short duration vector operations", cxxopts::value<std::size_t>()->default_value("1"))
+    ("sparse-matrix", "Matrix Market file for sparse benchmarks", cxxopts::value<std::string>()->default_value(""))
     ("rows", "Number of rows", cxxopts::value<std::size_t>()->default_value("10000"))
     ("stencil-steps", "Default steps for stencil", cxxopts::value<std::size_t>()->default_value("10"))
     ("vector-size", "Default vector size", cxxopts::value<std::size_t>()->default_value("100000000"))
@@ -114,6 +116,7 @@ int main(int argc, char *argv[]) {
   num_columns = options["columns"].as<std::size_t>();
   check_results = options.count("check");
   weak_scaling = options["weak-scaling"].as<bool>();
+  sparse_matrix_file = options["sparse-matrix"].as<std::string>();
 
   if (options["weak-scaling"].as<bool>())
     default_vector_size = default_vector_size * ranks;
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+using T = double;
+
+// Compare with DotProduct_DR, which reduces a transform of a zip
+static void DotProduct_TransformReduce_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> a(default_vector_size, 1);
+  xhp::distributed_vector<T> b(default_vector_size, 1);
+  Stats stats(state, sizeof(T) * (a.size() + b.size()), 0);
+
+  T res = 0;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      res = xhp::transform_reduce(a, b, T(0));
+      benchmark::DoNotOptimize(res);
+    }
+  }
+  if (check_results && res != T(default_vector_size)) {
+    state.SkipWithError("dot product: wrong result");
+  }
+}
+
+DR_BENCHMARK(DotProduct_TransformReduce_DR);
+
+static auto min_op = [](T x, T y) { return std::min(x, y); };
+static auto max_op = [](T x, T y) { return std::max(x, y); };
+// Identities of min and max, so the result does not depend on the data
+static const T min_init = std::numeric_limits<T>::max();
+static const T max_init = std::numeric_limits<T>::lowest();
+
+// Sum, min, and max with a reduce for each
+static void SumMinMax_Reduce_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> a(default_vector_size);
+  xhp::iota(a, 0);
+  Stats stats(state, 3 * sizeof(T) * a.size(), 0);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      auto sum = xhp::reduce(a, T(0), std::plus<>());
+      auto min = xhp::reduce(a, min_init, min_op);
+      auto max = xhp::reduce(a, max_init, max_op);
+      benchmark::DoNotOptimize(sum);
+      benchmark::DoNotOptimize(min);
+      benchmark::DoNotOptimize(max);
+    }
+  }
+}
+
+DR_BENCHMARK(SumMinMax_Reduce_DR);
+
+// Sum, min, and max in one pass and one collective
+static void SumMinMax_TransformReduce_DR(benchmark::State &state) {
+  xhp::distributed_vector<T> a(default_vector_size);
+  xhp::iota(a, 0);
+  Stats stats(state, sizeof(T) * a.size(), 0);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      auto result = xhp::transform_reduce(
+          a, std::tuple(T(0), min_init, max_init),
+          std::tuple(std::plus<>(), min_op, max_op), [](T x) { return x; });
+      benchmark::DoNotOptimize(result);
+    }
+  }
+}
+
+DR_BENCHMARK(SumMinMax_TransformReduce_DR);
@@ -0,0 +1,68 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+using T = double;
+
+static std::size_t window = 64;
+
+static void AdjacentDifference_DR(benchmark::State &state) {
+  std::size_t n = default_vector_size;
+  xhp::distributed_vector<T> a(n, xhp::distribution().halo(1)), out(n);
+  xhp::iota(a, 0);
+  Stats stats(state, sizeof(T) * n, sizeof(T) * n);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::adjacent_difference(a, out.begin());
+    }
+  }
+  if (check_results && (T(out[0]) != 0 || T(out[n - 1]) != 1)) {
+    state.SkipWithError("adjacent_difference: wrong result");
+  }
+}
+
+DR_BENCHMARK(AdjacentDifference_DR);
+
+static void RollingMean_DR(benchmark::State &state) {
+  std::size_t n = default_vector_size;
+  xhp::distributed_vector<T> a(n, xhp::distribution().halo(window - 1)),
+      out(n);
+  xhp::iota(a, 0);
+  Stats stats(state, sizeof(T) * n, sizeof(T) * n);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::rolling_mean(a, out.begin(), window);
+    }
+  }
+  if (check_results && T(out[n - 1]) != T(n - 1) - T(window - 1) / 2) {
+    state.SkipWithError("rolling_mean: wrong result");
+  }
+}
+
+DR_BENCHMARK(RollingMean_DR);
+
+static void RollingMax_DR(benchmark::State &state) {
+  std::size_t n = default_vector_size;
+  xhp::distributed_vector<T> a(n, xhp::distribution().halo(window - 1)),
+      out(n);
+  xhp::iota(a, 0);
+  Stats stats(state, sizeof(T) * n, sizeof(T) * n);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::rolling_max(a, out.begin(), window);
+    }
+  }
+  if (check_results && T(out[n - 1]) != T(n - 1)) {
+    state.SkipWithError("rolling_max: wrong result");
+  }
+}
+
+DR_BENCHMARK(RollingMax_DR);
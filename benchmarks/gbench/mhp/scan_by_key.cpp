@@ -0,0 +1,55 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+using T = double;
+
+// Runs of 1000 equal keys
+static void run_keys(auto &keys) {
+  xhp::iota(keys, 0);
+  xhp::for_each(keys, [](auto &x) { x = std::floor(x / 1000); });
+}
+
+static void InclusiveScanByKey_DR(benchmark::State &state) {
+  std::size_t n = default_vector_size;
+  xhp::distributed_vector<T> keys(n), values(n, 1), out(n);
+  run_keys(keys);
+  Stats stats(state, sizeof(T) * 2 * n, sizeof(T) * n);
+
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::inclusive_scan_by_key(keys, values, out);
+    }
+  }
+  if (check_results && T(out[n - 1]) != T((n - 1) % 1000 + 1)) {
+    state.SkipWithError("inclusive_scan_by_key: wrong result");
+  }
+}
+
+DR_BENCHMARK(InclusiveScanByKey_DR);
+
+static void ReduceByKey_DR(benchmark::State &state) {
+  std::size_t n = default_vector_size;
+  xhp::distributed_vector<T> keys(n), values(n, 1), keys_out(n),
+      values_out(n);
+  run_keys(keys);
+  Stats stats(state, sizeof(T) * 2 * n, 2 * sizeof(T) * (n / 1000));
+
+  std::size_t runs = 0;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      auto [k, v] = xhp::reduce_by_key(keys, values, keys_out.begin(),
+                                       values_out.begin());
+      runs = k - keys_out.begin();
+    }
+  }
+  if (check_results && (runs != (n + 999) / 1000 || T(values_out[0]) != 1000)) {
+    state.SkipWithError("reduce_by_key: wrong result");
+  }
+}
+
+DR_BENCHMARK(ReduceByKey_DR);
@@ -314,10 +314,10 @@ void compute_aux_fields(Array &u, Array &v, Array &e, Array &hu, Array &hv,
     dr::mhp::stencil_for_each(kernel, q_view, qa_view, qb_view, qg_view,
                               qd_view);
   }
-  dr::mhp::halo(qa).exchange_begin();
-  dr::mhp::halo(qb).exchange_begin();
-  dr::mhp::halo(qg).exchange_begin();
-  dr::mhp::halo(qd).exchange_begin();
+  // One message per neighbor for all the q advection terms
+  dr::mhp::halo_group q_halos(dr::mhp::halo(qa), dr::mhp::halo(qb),
+                              dr::mhp::halo(qg), dr::mhp::halo(qd));
+  q_halos.exchange_begin();
 
   { // hv
     auto kernel = [](auto args) {
@@ -352,10 +352,7 @@ void compute_aux_fields(Array &u, Array &v, Array &e, Array &hu, Array &hv,
   }
   dr::mhp::halo(hu).exchange_begin();
 
-  dr::mhp::halo(qa).exchange_finalize();
-  dr::mhp::halo(qb).exchange_finalize();
-  dr::mhp::halo(qg).exchange_finalize();
-  dr::mhp::halo(qd).exchange_finalize();
+  q_halos.exchange_finalize();
   dr::mhp::halo(hv).exchange_finalize();
   dr::mhp::halo(hu).exchange_finalize();
 }
@@ -87,6 +87,90 @@ static void Stencil1D_Subrange_DR(benchmark::State &state) {
 
 DR_BENCHMARK(Stencil1D_Subrange_DR);
 
+//
+// Periodic boundary. The sliding view computes the windows that do not
+// wrap, and the first and last ranks compute the 2 windows that wrap
+// through the periodic halo.
+//
+static void Stencil1D_Periodic_DR(benchmark::State &state) {
+  // The halo wraps only if the last segment is full
+  std::size_t n = default_vector_size / ranks * ranks;
+  auto dist = dr::mhp::distribution().halo(1).periodic(true);
+  xhp::distributed_vector<T> a(n, init_val, dist);
+  xhp::distributed_vector<T> b(n, init_val, dist);
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * b.size());
+
+  auto in = &a, out = &b;
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < stencil_steps; i++) {
+      stats.rep();
+      xhp::halo(*in).exchange();
+      xhp::transform(xhp::views::sliding(*in, 3), out->begin() + 1,
+                     stencil1d_slide_op);
+      if (comm_rank == 0) {
+        auto win = dr::ranges::local(in->begin() + (n - 1));
+        *dr::ranges::local(out->begin()) = stencil1d_slide_op(win);
+      }
+      if (comm_rank == ranks - 1) {
+        auto win = dr::ranges::local(in->begin() + (n - 2));
+        *dr::ranges::local(out->begin() + (n - 1)) = stencil1d_slide_op(win);
+      }
+      std::swap(in, out);
+    }
+  }
+}
+
+DR_BENCHMARK(Stencil1D_Periodic_DR);
+
+// Steps between halo exchanges for temporal blocking
+static const std::size_t stencil1d_depth = 4;
+
+//
+// Halo of stencil1d_depth elements, exchanged every stencil1d_depth
+// steps. The steps in between also update the ghost elements that the
+// following steps read. Explicitly process segments SPMD-style.
+//
+static void Stencil1D_Temporal_DR(benchmark::State &state) {
+  std::size_t n = default_vector_size;
+  if (dr::__detail::partition_up(n, ranks) < stencil1d_depth) {
+    state.SkipWithError("Segments must be larger than the halo");
+    return;
+  }
+  auto dist = dr::mhp::distribution().halo(stencil1d_depth);
+  xhp::distributed_vector<T> a(n, init_val, dist);
+  xhp::distributed_vector<T> b(n, init_val, dist);
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * b.size());
+
+  // Global index of the first local element
+  long first = comm_rank * dr::__detail::partition_up(n, ranks);
+  long local_size = rng::distance(dr::mhp::local_segment(a));
+  // The edges of the vector are not updated
+  long lowest = 1 - first, highest = long(n) - 1 - first;
+  auto in = rng::begin(dr::mhp::local_segment(a));
+  auto out = rng::begin(dr::mhp::local_segment(b));
+  auto in_vector = &a, out_vector = &b;
+  dr::mhp::exchange_all(xhp::halo(a), xhp::halo(b));
+
+  for (auto _ : state) {
+    for (std::size_t s = 0; s < stencil_steps; s++) {
+      stats.rep();
+      if (s % stencil1d_depth == 0) {
+        xhp::halo(*in_vector).exchange();
+      }
+      long ghost = stencil1d_depth - 1 - s % stencil1d_depth;
+      long i0 = std::max(-ghost, lowest);
+      long i1 = std::min(local_size + ghost, highest);
+      for (long i = i0; i < i1; i++) {
+        out[i] = stencil1d_subrange_op(in[i]);
+      }
+      std::swap(in, out);
+      std::swap(in_vector, out_vector);
+    }
+  }
+}
+
+DR_BENCHMARK(Stencil1D_Temporal_DR);
+
 #ifdef SYCL_LANGUAGE_VERSION
 static void Stencil1D_Subrange_DPL(benchmark::State &state) {
   auto q = get_queue();
@@ -407,6 +407,55 @@ static void Stencil2D_DR(benchmark::State &state) {
 
 DR_BENCHMARK(Stencil2D_DR);
 
+// Rows of halo for the temporal blocking benchmarks, which bounds the
+// number of steps between halo exchanges
+static const std::size_t temporal_halo = 4;
+
+//
+// Exchange the halo every depth steps, and redundantly compute the
+// ghost rows in between. depth 0 lets the cost model choose.
+//
+static void stencil_2d_temporal(benchmark::State &state, std::size_t depth) {
+  auto shape = default_shape();
+  if (shape[0] == 0) {
+    return;
+  }
+  if (shape[0] / ranks < temporal_halo) {
+    state.SkipWithError("Tiles must have at least temporal_halo rows");
+    return;
+  }
+
+  auto dist = dr::mhp::distribution().halo(temporal_halo);
+  dr::mhp::distributed_mdarray<T, 2> a(shape, dist);
+  dr::mhp::distributed_mdarray<T, 2> b(shape, dist);
+  xhp::fill(a, init_val);
+  xhp::fill(b, init_val);
+
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * b.size());
+
+  Checker checker;
+  for (auto _ : state) {
+    for (std::size_t s = 0; s < stencil_steps; s++) {
+      stats.rep();
+    }
+    auto &result =
+        xhp::temporal_stencil(mdspan_stencil_op, a, b, stencil_steps, 1, depth);
+    checker.check(result);
+  }
+}
+
+static void Stencil2D_Temporal_DR(benchmark::State &state) {
+  stencil_2d_temporal(state, 0);
+}
+
+DR_BENCHMARK(Stencil2D_Temporal_DR);
+
+static void Stencil2D_Temporal4_DR(benchmark::State &state) {
+  stencil_2d_temporal(state, temporal_halo);
+}
+
+DR_BENCHMARK(Stencil2D_Temporal4_DR);
+
 #endif //__GNUC__ == 10 && __GNUC_MINOR__ == 4
 
 auto round_up(auto n, auto multiple) {
@@ -0,0 +1,174 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+using T = double;
+
+// Every plane is plane_rows x plane_columns, and the vector size sets
+// the number of planes
+static const std::size_t plane_rows = 100;
+static const std::size_t plane_columns = 100;
+
+static auto default_shape() {
+  std::size_t planes = default_vector_size / (plane_rows * plane_columns);
+  return std::array{planes, plane_rows, plane_columns};
+}
+
+static bool check_shape(benchmark::State &state, auto shape) {
+  if (shape[0] < 3) {
+    state.SkipWithError(fmt::format("Vector size must be >= 3 * {}",
+                                    plane_rows * plane_columns));
+    return false;
+  }
+  return true;
+}
+
+static T init_val(std::size_t i, std::size_t j, std::size_t k) {
+  return T((i * 7 + j * 3 + k) % 11);
+}
+
+// 7 point stencil: the average of the point and its neighbors in
+// every dimension
+static void stencil_3d_op(const T *in, T *out, std::size_t rows,
+                          std::size_t cols, std::size_t i, std::size_t j,
+                          std::size_t k) {
+  std::size_t plane = rows * cols, p = (i * rows + j) * cols + k;
+  out[p] = (in[p - plane] + in[p + plane] + in[p - cols] + in[p + cols] +
+            in[p - 1] + in[p + 1] + in[p]) /
+           7;
+}
+
+static std::vector<T> stencil_3d_init(std::array<std::size_t, 3> shape) {
+  std::vector<T> a(shape[0] * shape[1] * shape[2]);
+  for (std::size_t i = 0; i < shape[0]; i++) {
+    for (std::size_t j = 0; j < shape[1]; j++) {
+      for (std::size_t k = 0; k < shape[2]; k++) {
+        a[(i * shape[1] + j) * shape[2] + k] = init_val(i, j, k);
+      }
+    }
+  }
+  return a;
+}
+
+// Runs the stencil for steps on a and b, and returns the one with the
+// result
+static T *stencil_3d_serial(std::array<std::size_t, 3> shape, T *in, T *out,
+                            std::size_t steps) {
+  auto [planes, rows, cols] = shape;
+  for (std::size_t s = 0; s < steps; s++) {
+    for (std::size_t i = 1; i < planes - 1; i++) {
+      for (std::size_t j = 1; j < rows - 1; j++) {
+        for (std::size_t k = 1; k < cols - 1; k++) {
+          stencil_3d_op(in, out, rows, cols, i, j, k);
+        }
+      }
+    }
+    std::swap(in, out);
+  }
+  return in;
+}
+
+// Compares a distributed result with the serial stencil
+static void check_3d(benchmark::State &state, rng::forward_range auto &&actual,
+                     std::array<std::size_t, 3> shape) {
+  if (!check_results) {
+    return;
+  }
+
+  auto a = stencil_3d_init(shape), b = a;
+  T *expected = stencil_3d_serial(shape, a.data(), b.data(), stencil_steps);
+  auto fp_compare = [](T x, T y) {
+    return std::abs(x - y) <= 1e-9 * (1 + std::abs(y));
+  };
+  if (!rng::equal(actual, rng::span(expected, rng::size(a)), fp_compare)) {
+    state.SkipWithError("stencil 3d: wrong result");
+  }
+}
+
+//
+// Serial baseline
+//
+static void Stencil3D_Loop_Serial(benchmark::State &state) {
+  auto shape = default_shape();
+  if (!check_shape(state, shape)) {
+    return;
+  }
+  auto a = stencil_3d_init(shape), b = a;
+  Stats stats(state, sizeof(T) * rng::size(a), sizeof(T) * rng::size(b));
+
+  for (auto _ : state) {
+    for (std::size_t s = 0; s < stencil_steps; s++) {
+      stats.rep();
+    }
+    stencil_3d_serial(shape, a.data(), b.data(), stencil_steps);
+  }
+}
+
+DR_BENCHMARK(Stencil3D_Loop_Serial);
+
+#if __GNUC__ == 10 && __GNUC_MINOR__ == 4
+// mdspan triggers gcc 10 bugs, skip these tests
+#else
+
+auto mdspan_stencil_3d_op = [](auto v) {
+  auto [in, out] = v;
+  out(0, 0, 0) = (in(-1, 0, 0) + in(1, 0, 0) + in(0, -1, 0) + in(0, 1, 0) +
+                  in(0, 0, -1) + in(0, 0, 1) + in(0, 0, 0)) /
+                 7;
+};
+
+//
+// Distributed mdarray distributed on planes. The neighbors in the
+// leading dimension on other ranks come from the halo.
+//
+static void Stencil3D_DR(benchmark::State &state) {
+  auto shape = default_shape();
+  if (!check_shape(state, shape)) {
+    return;
+  }
+  std::size_t radius = 1;
+  std::array slice_starts{radius, radius, radius};
+  std::array slice_ends{shape[0] - radius, shape[1] - radius,
+                        shape[2] - radius};
+
+  auto dist = dr::mhp::distribution().halo(radius);
+  dr::mhp::distributed_mdarray<T, 3> a(shape, dist);
+  dr::mhp::distributed_mdarray<T, 3> b(shape, dist);
+  auto init = [](auto index, auto v) {
+    auto &[x] = v;
+    x = init_val(index[0], index[1], index[2]);
+  };
+  xhp::for_each(init, a);
+  xhp::for_each(init, b);
+
+  std::size_t n = shape[0] * shape[1] * shape[2];
+  Stats stats(state, sizeof(T) * n, sizeof(T) * n);
+
+  auto in = dr::mhp::views::submdspan(a.view(), slice_starts, slice_ends);
+  auto out = dr::mhp::views::submdspan(b.view(), slice_starts, slice_ends);
+  auto in_array = &a;
+  auto out_array = &b;
+
+  // Every iteration continues from the last one, so only the first
+  // one is checked
+  bool checked = false;
+  for (auto _ : state) {
+    for (std::size_t s = 0; s < stencil_steps; s++) {
+      stats.rep();
+      dr::mhp::halo(*in_array).exchange();
+      xhp::stencil_for_each(mdspan_stencil_3d_op, in, out);
+      std::swap(in, out);
+      std::swap(in_array, out_array);
+    }
+    if (!checked) {
+      check_3d(state, *in_array, shape);
+      checked = true;
+    }
+  }
+}
+
+DR_BENCHMARK(Stencil3D_DR);
+
+#endif //__GNUC__ == 10 && __GNUC_MINOR__ == 4
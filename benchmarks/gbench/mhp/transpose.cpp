@@ -0,0 +1,92 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+#include "mkl.h"
+
+using T = double;
+
+static void Transpose_DR(benchmark::State &state) {
+  std::array<std::size_t, 2> shape = {num_rows, num_columns},
+                             shape_t = {num_columns, num_rows};
+  xhp::distributed_mdarray<T, 2> a(shape), b(shape_t);
+  xhp::iota(a, 0);
+
+  Stats stats(state, sizeof(T) * a.size(), sizeof(T) * b.size());
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      xhp::transpose(a, b);
+    }
+  }
+
+  if (check_results) {
+    auto ma = a.mdspan(), mb = b.mdspan();
+    for (std::size_t i = 0; i < num_rows; i += 7) {
+      for (std::size_t j = 0; j < num_columns; j += 5) {
+        if (ma(i, j) != mb(j, i)) {
+          state.SkipWithError("transpose: wrong result");
+          return;
+        }
+      }
+    }
+  }
+}
+
+DR_BENCHMARK(Transpose_DR);
+
+// Same algorithm as examples/mhp/transpose-ref.cpp: square matrix
+// distributed by rows, mkl_domatcopy for the local transposes and a
+// pairwise exchange of one block per phase
+static void Transpose_Reference(benchmark::State &state) {
+  std::size_t block_order = std::max(num_rows / ranks, std::size_t(1));
+  std::size_t m = block_order * ranks;
+  std::size_t block_size = block_order * block_order;
+  std::vector<T> a(block_order * m), b(block_order * m);
+  std::vector<T> send(block_size), receive(block_size);
+  for (std::size_t i = 0; i < block_order; i++) {
+    for (std::size_t j = 0; j < m; j++) {
+      a[i * m + j] = (comm_rank * block_order + i) * m + j;
+    }
+  }
+
+  Stats stats(state, sizeof(T) * m * m, sizeof(T) * m * m);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      mkl_domatcopy('R', 'T', block_order, block_order, 1,
+                    a.data() + comm_rank * block_order, m,
+                    b.data() + comm_rank * block_order, m);
+      for (std::size_t phase = 1; phase < ranks; phase++) {
+        std::size_t send_to = (comm_rank + phase) % ranks;
+        std::size_t receive_from = (comm_rank + ranks - phase) % ranks;
+        mkl_domatcopy('R', 'T', block_order, block_order, 1,
+                      a.data() + send_to * block_order, m, send.data(),
+                      block_order);
+        MPI_Sendrecv(send.data(), block_size, MPI_DOUBLE, send_to, phase,
+                     receive.data(), block_size, MPI_DOUBLE, receive_from,
+                     phase, comm, MPI_STATUS_IGNORE);
+        for (std::size_t r = 0; r < block_order; r++) {
+          std::copy(receive.begin() + r * block_order,
+                    receive.begin() + (r + 1) * block_order,
+                    b.begin() + r * m + receive_from * block_order);
+        }
+      }
+    }
+  }
+
+  if (check_results) {
+    for (std::size_t i = 0; i < block_order; i++) {
+      for (std::size_t j = 0; j < m; j++) {
+        if (b[i * m + j] != T(j * m + comm_rank * block_order + i)) {
+          state.SkipWithError("transpose reference: wrong result");
+          return;
+        }
+      }
+    }
+  }
+}
+
+DR_BENCHMARK(Transpose_Reference);
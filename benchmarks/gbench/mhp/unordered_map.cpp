@@ -0,0 +1,89 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "../common/dr_bench.hpp"
+
+#include <random>
+#include <unordered_map>
+
+using K = long;
+using V = long;
+
+// Every rank has default_vector_size / ranks random keys
+static auto random_pairs(std::size_t key_range) {
+  std::vector<std::pair<K, V>> pairs(default_vector_size / ranks);
+  std::mt19937_64 gen(comm_rank);
+  std::uniform_int_distribution<K> dist(0, key_range - 1);
+  for (auto &[key, value] : pairs) {
+    key = dist(gen);
+    value = 1;
+  }
+  return pairs;
+}
+
+static void UnorderedMap_Insert_DR(benchmark::State &state) {
+  auto pairs = random_pairs(default_vector_size);
+  Stats stats(state, sizeof(pairs[0]) * pairs.size() * ranks, 0);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      xhp::distributed_unordered_map<K, V> map;
+      stats.rep();
+      map.insert(pairs);
+    }
+  }
+}
+
+DR_BENCHMARK(UnorderedMap_Insert_DR);
+
+static void UnorderedMap_Find_DR(benchmark::State &state) {
+  auto pairs = random_pairs(default_vector_size);
+  xhp::distributed_unordered_map<K, V> map;
+  map.insert(pairs);
+  std::vector<K> keys;
+  for (auto &[key, value] : pairs) {
+    keys.push_back(key);
+  }
+
+  Stats stats(state, sizeof(K) * keys.size() * ranks,
+              sizeof(V) * keys.size() * ranks);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      auto values = map.find(keys);
+      benchmark::DoNotOptimize(values);
+    }
+  }
+}
+
+DR_BENCHMARK(UnorderedMap_Find_DR);
+
+// Many updates per key, like counting words
+static void UnorderedMap_Upsert_DR(benchmark::State &state) {
+  auto pairs = random_pairs(std::max(default_vector_size / 1000, std::size_t(100)));
+  xhp::distributed_unordered_map<K, V> map;
+  Stats stats(state, sizeof(pairs[0]) * pairs.size() * ranks, 0);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      stats.rep();
+      map.upsert(pairs, std::plus<>{});
+    }
+  }
+}
+
+DR_BENCHMARK(UnorderedMap_Upsert_DR);
+
+static void UnorderedMap_Insert_Serial(benchmark::State &state) {
+  auto pairs = random_pairs(default_vector_size);
+  Stats stats(state, sizeof(pairs[0]) * pairs.size(), 0);
+  for (auto _ : state) {
+    for (std::size_t i = 0; i < default_repetitions; i++) {
+      std::unordered_map<K, V> map;
+      stats.rep();
+      map.insert(pairs.begin(), pairs.end());
+      benchmark::DoNotOptimize(map);
+    }
+  }
+}
+
+DR_BENCHMARK(UnorderedMap_Insert_Serial);
@@ -6,6 +6,58 @@
 
 namespace dr {
 
+// MPI datatype for an arithmetic type. Returns MPI_DATATYPE_NULL for
+// other types, which must be sent as bytes.
+template <typename T> MPI_Datatype mpi_data_type() {
+  using U = std::remove_cv_t<T>;
+  if constexpr (std::is_same_v<U, char>) {
+    return MPI_CHAR;
+  } else if constexpr (std::is_same_v<U, unsigned char>) {
+    return MPI_UNSIGNED_CHAR;
+  } else if constexpr (std::is_same_v<U, short>) {
+    return MPI_SHORT;
+  } else if constexpr (std::is_same_v<U, unsigned short>) {
+    return MPI_UNSIGNED_SHORT;
+  } else if constexpr (std::is_same_v<U, int>) {
+    return MPI_INT;
+  } else if constexpr (std::is_same_v<U, unsigned>) {
+    return MPI_UNSIGNED;
+  } else if constexpr (std::is_same_v<U, long>) {
+    return MPI_LONG;
+  } else if constexpr (std::is_same_v<U, unsigned long>) {
+    return MPI_UNSIGNED_LONG;
+  } else if constexpr (std::is_same_v<U, long long>) {
+    return MPI_LONG_LONG;
+  } else if constexpr (std::is_same_v<U, unsigned long long>) {
+    return MPI_UNSIGNED_LONG_LONG;
+  } else if constexpr (std::is_same_v<U, float>) {
+    return MPI_FLOAT;
+  } else if constexpr (std::is_same_v<U, double>) {
+    return MPI_DOUBLE;
+  } else if constexpr (std::is_same_v<U, long double>) {
+    return MPI_LONG_DOUBLE;
+  } else {
+    return MPI_DATATYPE_NULL;
+  }
+}
+
+// MPI reduction operation for a binary function object. Returns
+// MPI_OP_NULL if there is no matching predefined operation.
+template <typename Op, typename T> MPI_Op mpi_op() {
+  if constexpr (std::is_same_v<Op, std::plus<>> ||
+                std::is_same_v<Op, std::plus<T>>) {
+    return MPI_SUM;
+  } else if constexpr (std::is_same_v<Op, std::multiplies<>> ||
+                       std::is_same_v<Op, std::multiplies<T>>) {
+    return MPI_PROD;
+  } else {
+    return MPI_OP_NULL;
+  }
+}
+
+template <typename T>
+concept mpi_arithmetic = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+
 class communicator {
 public:
   enum class tag {
@@ -32,12 +84,27 @@ public:
 
   MPI_Comm mpi_comm() const { return mpi_comm_; }
 
+  // Collective split into sub-communicators of the ranks with the same
+  // color, ordered by key. Release the result with free().
+  communicator split(std::size_t color, std::size_t key) const {
+    MPI_Comm comm;
+    MPI_Comm_split(mpi_comm_, color, key, &comm);
+    return communicator(comm);
+  }
+
+  void free() { MPI_Comm_free(&mpi_comm_); }
+
   void barrier() const { MPI_Barrier(mpi_comm_); }
 
   void bcast(void *src, std::size_t count, std::size_t root) const {
     MPI_Bcast(src, count, MPI_BYTE, root, mpi_comm_);
   }
 
+  void i_bcast(void *src, std::size_t count, std::size_t root,
+               MPI_Request *request) const {
+    MPI_Ibcast(src, count, MPI_BYTE, root, mpi_comm_, request);
+  }
+
   void scatter(const void *src, void *dst, std::size_t count,
                std::size_t root) const {
     MPI_Scatter(src, count, MPI_BYTE, dst, count, MPI_BYTE, root, mpi_comm_);
@@ -86,6 +153,13 @@ public:
     all_gather(rng::data(src), rng::data(dst), rng::size(src));
   }
 
+  // counts and offsets are in bytes, for every rank
+  void all_gatherv(const void *src, int *counts, int *offsets,
+                   void *dst) const {
+    MPI_Allgatherv(src, counts[rank()], MPI_BYTE, dst, counts, offsets,
+                   MPI_BYTE, mpi_comm_);
+  }
+
   template <typename T>
   void i_all_gather(const T *src, T *dst, std::size_t count,
                     MPI_Request *req) const {
@@ -100,6 +174,43 @@ public:
     i_all_gather(&src, rng::data(dst), 1, req);
   }
 
+  // In place reduction of arithmetic values
+  template <mpi_arithmetic T>
+  void all_reduce(T *data, std::size_t count, MPI_Op op) const {
+    MPI_Allreduce(MPI_IN_PLACE, data, count, mpi_data_type<T>(), op,
+                  mpi_comm_);
+  }
+
+  template <mpi_arithmetic T> T all_reduce(T value, MPI_Op op) const {
+    all_reduce(&value, 1, op);
+    return value;
+  }
+
+  // src must not change until the request completes
+  template <mpi_arithmetic T>
+  void i_all_reduce(const T *src, T *dst, std::size_t count, MPI_Op op,
+                    MPI_Request *req) const {
+    MPI_Iallreduce(src, dst, count, mpi_data_type<T>(), op, mpi_comm_, req);
+  }
+
+  // Reduces the elements of src over the ranks, and scatters the
+  // result: rank i receives the next counts[i] elements
+  template <mpi_arithmetic T>
+  void reduce_scatter(const T *src, T *dst, const int *counts,
+                      MPI_Op op) const {
+    MPI_Reduce_scatter(src, dst, counts, mpi_data_type<T>(), op, mpi_comm_);
+  }
+
+  // Exclusive prefix reduction over the ranks. MPI leaves the result
+  // on rank 0 undefined, it is set to 0.
+  template <mpi_arithmetic T>
+  void exscan(const T *src, T *dst, std::size_t count, MPI_Op op) const {
+    MPI_Exscan(src, dst, count, mpi_data_type<T>(), op, mpi_comm_);
+    if (rank() == 0) {
+      std::fill(dst, dst + count, T(0));
+    }
+  }
+
   void gatherv(const void *src, int *counts, int *offsets, void *dst,
                std::size_t root) const {
     MPI_Gatherv(src, counts[rank()], MPI_BYTE, dst, counts, offsets, MPI_BYTE,
@@ -131,6 +242,18 @@ public:
     irecv(rng::data(data), rng::size(data), src_rank, t, request);
   }
 
+  // Send 1 element of a derived datatype, which can describe strided
+  // data that MPI sends without packing
+  void isend_type(const void *data, MPI_Datatype type, std::size_t dst_rank,
+                  tag t, MPI_Request *request) const {
+    MPI_Isend(data, 1, type, dst_rank, int(t), mpi_comm_, request);
+  }
+
+  void irecv_type(void *data, MPI_Datatype type, std::size_t src_rank, tag t,
+                  MPI_Request *request) const {
+    MPI_Irecv(data, 1, type, src_rank, int(t), mpi_comm_, request);
+  }
+
   template <rng::contiguous_range R>
   void alltoall(const R &sendr, R &recvr, std::size_t count) {
     using T = typename R::value_type;
@@ -138,6 +261,13 @@ public:
                  rng::data(recvr), count * sizeof(T), MPI_BYTE, mpi_comm_);
   }
 
+  template <typename T>
+  void i_alltoall(const T *send, T *receive, std::size_t count,
+                  MPI_Request *request) const {
+    MPI_Ialltoall(send, count * sizeof(T), MPI_BYTE, receive, count * sizeof(T),
+                  MPI_BYTE, mpi_comm_, request);
+  }
+
   template <rng::contiguous_range SendR, rng::contiguous_range RecvR>
   void alltoallv(const SendR &sendbuf, const std::vector<std::size_t> &sendcnt,
                  const std::vector<std::size_t> &senddsp, RecvR &recvbuf,
@@ -182,6 +312,50 @@ private:
   std::size_t size_;
 };
 
+//
+// Ranks arranged in a 2D grid in row major order, with communicators
+// for the ranks in the same row and in the same column of the grid.
+// Used for pencil decompositions, where data is exchanged along one
+// grid dimension at a time.
+//
+class process_grid {
+public:
+  // Shape is chosen by MPI_Dims_create if rows is 0
+  process_grid(communicator comm, std::size_t rows = 0) {
+    int dims[2] = {int(rows), 0};
+    MPI_Dims_create(comm.size(), 2, dims);
+    rows_ = dims[0];
+    columns_ = dims[1];
+    assert(rows_ * columns_ == comm.size());
+    row_ = comm.rank() / columns_;
+    column_ = comm.rank() % columns_;
+    row_comm_ = comm.split(row_, column_);
+    column_comm_ = comm.split(column_, row_);
+  }
+
+  // Destructor frees the communicators, so cannot copy
+  process_grid(const process_grid &) = delete;
+  process_grid &operator=(const process_grid &) = delete;
+
+  ~process_grid() {
+    row_comm_.free();
+    column_comm_.free();
+  }
+
+  auto rows() const { return rows_; }
+  auto columns() const { return columns_; }
+  auto row() const { return row_; }
+  auto column() const { return column_; }
+  // Ranks in the same grid row, ranked by column
+  auto row_comm() const { return row_comm_; }
+  // Ranks in the same grid column, ranked by row
+  auto column_comm() const { return column_comm_; }
+
+private:
+  std::size_t rows_, columns_, row_, column_;
+  communicator row_comm_, column_comm_;
+};
+
 class rma_window {
 public:
   void create(communicator comm, void *data, std::size_t size) {
@@ -191,6 +365,23 @@ public:
     MPI_Win_create(data, size, 1, MPI_INFO_NULL, comm.mpi_comm(), &win_);
   }
 
+  // Window with memory allocated by MPI
+  void allocate(communicator comm, std::size_t size) {
+    communicator_ = comm;
+    drlog.debug("win allocate:: size: {}\n", size);
+    MPI_Win_allocate(size, 1, MPI_INFO_NULL, comm.mpi_comm(), &local_data_,
+                     &win_);
+  }
+
+  // View of this window that begins at a byte offset. The offset must
+  // be the same on every rank.
+  rma_window subwindow(std::size_t offset) const {
+    rma_window sub = *this;
+    sub.offset_ = offset_ + offset;
+    sub.local_data_ = static_cast<char *>(local_data_) + offset;
+    return sub;
+  }
+
   template <typename T> auto local_data() {
     return static_cast<T *>(local_data_);
   }
@@ -198,7 +389,7 @@ public:
   void free() { MPI_Win_free(&win_); }
 
   bool operator==(const rma_window other) const noexcept {
-    return this->win_ == other.win_;
+    return this->win_ == other.win_ && this->offset_ == other.offset_;
   }
 
   void set_null() { win_ = MPI_WIN_NULL; }
@@ -214,7 +405,8 @@ public:
            std::size_t disp) const {
     drlog.debug("comm get:: ({}:{}:{})\n", rank, disp, size);
     MPI_Request request;
-    MPI_Rget(dst, size, MPI_BYTE, rank, disp, size, MPI_BYTE, win_, &request);
+    MPI_Rget(dst, size, MPI_BYTE, rank, offset_ + disp, size, MPI_BYTE, win_,
+             &request);
     MPI_Wait(&request, MPI_STATUS_IGNORE);
   }
 
@@ -226,10 +418,21 @@ public:
            std::size_t disp) const {
     drlog.debug("comm put:: ({}:{}:{})\n", rank, disp, size);
     MPI_Request request;
-    MPI_Rput(src, size, MPI_BYTE, rank, disp, size, MPI_BYTE, win_, &request);
+    MPI_Rput(src, size, MPI_BYTE, rank, offset_ + disp, size, MPI_BYTE, win_,
+             &request);
     MPI_Wait(&request, MPI_STATUS_IGNORE);
   }
 
+  // Combine count elements of src into the target with op. Completes
+  // at the next fence.
+  template <mpi_arithmetic T>
+  void accumulate(const T *src, std::size_t count, std::size_t rank,
+                  std::size_t disp, MPI_Op op) const {
+    drlog.debug("comm accumulate:: ({}:{}:{})\n", rank, disp, count);
+    MPI_Accumulate(src, count, mpi_data_type<T>(), rank, offset_ + disp, count,
+                   mpi_data_type<T>(), op, win_);
+  }
+
   void fence() const { MPI_Win_fence(0, win_); }
 
   void flush(std::size_t rank) const {
@@ -244,6 +447,7 @@ private:
   dr::communicator communicator_;
   MPI_Win win_ = MPI_WIN_NULL;
   void *local_data_ = nullptr;
+  std::size_t offset_ = 0;
 };
 
 } // namespace dr
@@ -107,6 +107,65 @@ void mdspan_copy(mdspan_like auto src, mdspan_like auto dst) {
   mdspan_foreach<src.rank(), decltype(copy)>(src.extents(), copy);
 }
 
+// Calls op(offset, run) for each run of the last dimension of an
+// mdspan over memory, in order. offset is the offset of the first
+// element of the run, and the elements of the run are stride(Rank - 1)
+// apart.
+template <mdspan_like Mdspan, typename Op>
+void mdspan_foreach_run(const Mdspan &mdspan, Op op) {
+  constexpr std::size_t rank = Mdspan::rank();
+  std::size_t runs = 1;
+  for (std::size_t d = 0; d + 1 < rank; d++) {
+    runs *= mdspan.extent(d);
+  }
+  for (std::size_t run = 0; run < runs; run++) {
+    std::size_t offset = 0;
+    for (std::size_t d = rank - 1, linear = run; d-- > 0;) {
+      offset += (linear % mdspan.extent(d)) * mdspan.stride(d);
+      linear /= mdspan.extent(d);
+    }
+    op(offset, run);
+  }
+}
+
+// Pack an mdspan over memory into contiguous memory. Faster than
+// mdspan_copy because the last dimension is copied a run at a time,
+// which is a block copy when the stride is 1.
+template <mdspan_like Mdspan>
+void mdspan_pack(const Mdspan &src, typename Mdspan::value_type *dst) {
+  constexpr std::size_t rank = Mdspan::rank();
+  const auto *data = src.data_handle();
+  std::size_t n = src.extent(rank - 1), stride = src.stride(rank - 1);
+  mdspan_foreach_run(src, [=](std::size_t offset, std::size_t run) {
+    auto *out = dst + run * n;
+    if (stride == 1) {
+      std::copy(data + offset, data + offset + n, out);
+    } else {
+      for (std::size_t i = 0; i < n; i++) {
+        out[i] = data[offset + i * stride];
+      }
+    }
+  });
+}
+
+// Unpack contiguous memory into an mdspan over memory
+template <mdspan_like Mdspan>
+void mdspan_unpack(const typename Mdspan::value_type *src, const Mdspan &dst) {
+  constexpr std::size_t rank = Mdspan::rank();
+  auto *data = dst.data_handle();
+  std::size_t n = dst.extent(rank - 1), stride = dst.stride(rank - 1);
+  mdspan_foreach_run(dst, [=](std::size_t offset, std::size_t run) {
+    const auto *in = src + run * n;
+    if (stride == 1) {
+      std::copy(in, in + n, data + offset);
+    } else {
+      for (std::size_t i = 0; i < n; i++) {
+        data[offset + i * stride] = in[i];
+      }
+    }
+  });
+}
+
 // For operator(), rearrange indices according to template arguments.
 //
 // For mdtranspose<mdspan2d, 1, 0> a(b);
@@ -0,0 +1,142 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <array>
+#include <cmath>
+#include <concepts>
+#include <cstdint>
+#include <limits>
+#include <random>
+
+namespace dr::__detail {
+
+using philox_counter = std::array<std::uint32_t, 4>;
+using philox_key = std::array<std::uint32_t, 2>;
+
+// Philox4x32-10 from Salmon et al., "Parallel Random Numbers: As Easy
+// as 1, 2, 3". A bijection of the counter for every key, so every
+// counter gives 128 independent random bits without any state. It only
+// multiplies and xors 32 bit words, and it vectorizes across counters.
+inline philox_counter philox4x32(philox_counter c, philox_key k) {
+  for (int round = 0; round < 10; round++) {
+    std::uint64_t p0 = std::uint64_t(0xD2511F53) * c[0];
+    std::uint64_t p1 = std::uint64_t(0xCD9E8D57) * c[2];
+    c = {std::uint32_t(p1 >> 32) ^ c[1] ^ k[0], std::uint32_t(p1),
+         std::uint32_t(p0 >> 32) ^ c[3] ^ k[1], std::uint32_t(p0)};
+    k[0] += 0x9E3779B9;
+    k[1] += 0xBB67AE85;
+  }
+  return c;
+}
+
+// 64 random bits from 2 words
+inline std::uint64_t random_bits(std::uint32_t lo, std::uint32_t hi) {
+  return std::uint64_t(hi) << 32 | lo;
+}
+
+// Uniform in [0, 1) with all the bits of the mantissa of T
+template <std::floating_point T> T random_unit(std::uint64_t x) {
+  constexpr int digits = std::numeric_limits<T>::digits;
+  return T(x >> (64 - digits)) * (T(1) / T(std::uint64_t(1) << digits));
+}
+
+// High 64 bits of a * b, with 32 bit multiplies so it also runs on
+// devices without 128 bit integers
+inline std::uint64_t mul_high(std::uint64_t a, std::uint64_t b) {
+  std::uint64_t a_lo = a & 0xFFFFFFFF, a_hi = a >> 32;
+  std::uint64_t b_lo = b & 0xFFFFFFFF, b_hi = b >> 32;
+  std::uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+  std::uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+  std::uint64_t middle = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+  return hi_hi + (hi_lo >> 32) + (middle >> 32);
+}
+
+// A distribution that maps the 4 words of one counter to a value, so
+// the value of an element depends only on the seed and its index.
+// Constructed from the std distribution with the same parameters, and
+// copyable to a device.
+template <typename D> struct counter_distribution {
+  static_assert(sizeof(D) == 0,
+                "generate_random supports uniform_int_distribution, "
+                "uniform_real_distribution, normal_distribution and "
+                "bernoulli_distribution");
+};
+
+template <std::integral T>
+struct counter_distribution<std::uniform_int_distribution<T>> {
+  using result_type = T;
+  T a;
+  // Number of values, 0 when it is all 2^64 values
+  std::uint64_t range;
+
+  counter_distribution(const std::uniform_int_distribution<T> &d)
+      : a(d.a()), range(std::uint64_t(d.b()) - std::uint64_t(d.a()) + 1) {}
+
+  // Multiply and shift. The bias is at most range / 2^64.
+  T operator()(const philox_counter &w) const {
+    std::uint64_t x = random_bits(w[0], w[1]);
+    return T(std::uint64_t(a) + (range == 0 ? x : mul_high(x, range)));
+  }
+};
+
+template <std::floating_point T>
+struct counter_distribution<std::uniform_real_distribution<T>> {
+  using result_type = T;
+  T a, width;
+
+  counter_distribution(const std::uniform_real_distribution<T> &d)
+      : a(d.a()), width(d.b() - d.a()) {}
+
+  T operator()(const philox_counter &w) const {
+    return a + width * random_unit<T>(random_bits(w[0], w[1]));
+  }
+};
+
+template <std::floating_point T>
+struct counter_distribution<std::normal_distribution<T>> {
+  using result_type = T;
+  T mean, stddev;
+
+  counter_distribution(const std::normal_distribution<T> &d)
+      : mean(d.mean()), stddev(d.stddev()) {}
+
+  // Box-Muller, with u1 in (0, 1] so the log is finite
+  T operator()(const philox_counter &w) const {
+    T u1 = T(1) - random_unit<T>(random_bits(w[0], w[1]));
+    T u2 = random_unit<T>(random_bits(w[2], w[3]));
+    T two_pi = T(6.283185307179586476925286766559);
+    return mean + stddev * std::sqrt(T(-2) * std::log(u1)) *
+                      std::cos(two_pi * u2);
+  }
+};
+
+template <> struct counter_distribution<std::bernoulli_distribution> {
+  using result_type = bool;
+  double p;
+
+  counter_distribution(const std::bernoulli_distribution &d) : p(d.p()) {}
+
+  bool operator()(const philox_counter &w) const {
+    return random_unit<double>(random_bits(w[0], w[1])) < p;
+  }
+};
+
+// Key of a seed
+inline philox_key random_key(std::uint64_t seed) {
+  return {std::uint32_t(seed), std::uint32_t(seed >> 32)};
+}
+
+// Value of element i for the key. Every element has its own counter,
+// so the value does not depend on how the elements are split between
+// ranks, devices or threads.
+template <typename D>
+auto random_value(const counter_distribution<D> &dist, philox_key key,
+                  std::uint64_t i) {
+  return dist(philox4x32({std::uint32_t(i), std::uint32_t(i >> 32), 0, 0},
+                         key));
+}
+
+} // namespace dr::__detail
@@ -108,11 +108,13 @@ sycl::event parallel_for(sycl::queue &q, sycl::range<1> global, Fn &&fn) {
   std::vector<sycl::event> events;
 
   // Chunks are 32 bits
-  for (std::size_t remainder = global[0]; remainder != 0;) {
-    std::size_t chunk = std::min(
-        remainder, std::size_t(std::numeric_limits<std::int32_t>::max()));
-    events.push_back(parallel_for_nd(q, sycl::range<>(chunk), fn));
-    remainder -= chunk;
+  for (std::size_t first = 0; first != global[0];) {
+    std::size_t chunk =
+        std::min(global[0] - first,
+                 std::size_t(std::numeric_limits<std::int32_t>::max()));
+    auto chunk_fn = [=](auto idx) { fn(first + idx); };
+    events.push_back(parallel_for_nd(q, sycl::range<>(chunk), chunk_fn));
+    first += chunk;
   }
 
   return combine_events(q, events);
@@ -58,15 +58,36 @@
 #include <dr/mhp/views/sliding.hpp>
 #include <dr/mhp/views/mdspan_view.hpp>
 #include <dr/mhp/views/submdspan_view.hpp>
+#include <dr/mhp/algorithms/accumulate.hpp>
+#include <dr/mhp/algorithms/adjacent_difference.hpp>
+#include <dr/mhp/algorithms/binary_search.hpp>
 #include <dr/mhp/algorithms/copy.hpp>
+#include <dr/mhp/algorithms/copy_if.hpp>
 #include <dr/mhp/algorithms/fill.hpp>
+#include <dr/mhp/algorithms/find.hpp>
 #include <dr/mhp/algorithms/for_each.hpp>
+#include <dr/mhp/algorithms/gather_scatter.hpp>
+#include <dr/mhp/algorithms/generate_random.hpp>
+#include <dr/mhp/algorithms/gemm.hpp>
+#include <dr/mhp/algorithms/gemv.hpp>
+#include <dr/mhp/algorithms/graph.hpp>
 #include <dr/mhp/algorithms/exclusive_scan.hpp>
 #include <dr/mhp/algorithms/inclusive_scan.hpp>
 #include <dr/mhp/algorithms/iota.hpp>
+#include <dr/mhp/algorithms/merge.hpp>
 #include <dr/mhp/algorithms/reduce.hpp>
+#include <dr/mhp/algorithms/rolling.hpp>
+#include <dr/mhp/algorithms/scan_by_key.hpp>
 #include <dr/mhp/algorithms/sort.hpp>
 #include <dr/mhp/algorithms/md_for_each.hpp>
+#include <dr/mhp/algorithms/md_reduce.hpp>
 #include <dr/mhp/algorithms/transform.hpp>
+#include <dr/mhp/algorithms/transform_reduce.hpp>
+#include <dr/mhp/algorithms/transpose.hpp>
+#include <dr/mhp/algorithms/fft.hpp>
+#include <dr/mhp/algorithms/temporal_stencil.hpp>
 #include <dr/mhp/containers/distributed_vector.hpp>
 #include <dr/mhp/containers/distributed_mdarray.hpp>
+#include <dr/mhp/containers/distributed_dense_matrix.hpp>
+#include <dr/mhp/containers/distributed_unordered_map.hpp>
+#include <dr/mhp/containers/sparse_matrix.hpp>
@@ -0,0 +1,242 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <functional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/communicator.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/algorithms/gather_scatter.hpp>
+#include <dr/mhp/global.hpp>
+
+namespace dr::mhp::__detail {
+
+// Combine updates with the same index. Returns the distinct indices in
+// ascending order and the combined value for each.
+template <typename T>
+auto combine_updates(rng::random_access_range auto &&indices,
+                     rng::random_access_range auto &&values, auto &&op) {
+  std::size_t n = rng::size(indices);
+  std::vector<std::pair<std::size_t, T>> entries(n);
+  for (std::size_t i = 0; i < n; i++) {
+    entries[i] = {std::size_t(indices[i]), T(values[i])};
+  }
+  std::sort(std::execution::par_unseq, entries.begin(), entries.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+
+  std::pair<std::vector<std::size_t>, std::vector<T>> combined;
+  auto &[combined_indices, combined_values] = combined;
+  for (auto &[index, value] : entries) {
+    if (!rng::empty(combined_indices) && combined_indices.back() == index) {
+      combined_values.back() = op(combined_values.back(), value);
+    } else {
+      combined_indices.push_back(index);
+      combined_values.push_back(value);
+    }
+  }
+  return combined;
+}
+
+// Apply combined updates with one MPI_Accumulate per run of
+// consecutive indices in the same segment
+template <typename T>
+void accumulate_rma(auto &&dr, const std::vector<std::size_t> &offsets,
+                    const std::vector<std::size_t> &indices,
+                    const std::vector<T> &values, MPI_Op op) {
+  auto segments = dr::ranges::segments(dr);
+  std::vector<rng::iterator_t<rng::range_value_t<decltype(segments)>>> begins;
+  for (auto &&segment : segments) {
+    begins.push_back(rng::begin(segment));
+  }
+
+  std::size_t n = rng::size(indices);
+  for (std::size_t first = 0; first < n;) {
+    auto segment = owning_segment(offsets, indices[first]);
+    std::size_t last = first + 1;
+    while (last < n && indices[last] == indices[last - 1] + 1 &&
+           indices[last] < offsets[segment + 1]) {
+      last++;
+    }
+    auto it = begins[segment] + (indices[first] - offsets[segment]);
+    it.accumulate(values.data() + first, last - first, op);
+    first = last;
+  }
+
+  fence();
+}
+
+// Send combined updates to the owners, which combine the updates from
+// all ranks and apply them to local memory
+template <typename T>
+void accumulate_owner(auto &&dr, const std::vector<std::size_t> &offsets,
+                      const std::vector<std::size_t> &indices,
+                      const std::vector<T> &values, auto &&op) {
+  auto comm = default_comm();
+  auto ranks = segment_ranks(dr);
+  auto pointers = segment_pointers<T>(dr);
+
+  // Collective, so it is called once
+  auto batches = exchange_batches(rng::size(indices));
+  std::vector<T> requested, forwarded, current;
+  for (std::size_t b = 0; b < batches; b++) {
+    auto batch = exchange_batch(indices, b);
+    index_exchange exchange(comm, offsets, ranks, batch);
+
+    requested.resize(rng::size(exchange.requests));
+    auto batch_values =
+        values.begin() + exchange_batch_first(rng::size(values), b);
+    for (std::size_t i = 0; i < rng::size(batch); i++) {
+      requested[exchange.slots[i]] = batch_values[i];
+    }
+    exchange.forward(comm, requested, forwarded);
+
+    // Several ranks may update the same index
+    auto [owned_indices, owned_values] =
+        combine_updates<T>(exchange.received, forwarded, op);
+    auto addresses = local_addresses(offsets, pointers, owned_indices);
+    load_local(addresses, current);
+    for (std::size_t i = 0; i < rng::size(current); i++) {
+      current[i] = op(current[i], owned_values[i]);
+    }
+    store_local(addresses, current);
+  }
+
+  barrier();
+}
+
+// Use RMA when the updates form long runs of consecutive indices,
+// which happens when many updates hit a small set of destinations.
+// Sparse updates are cheaper to route to the owners.
+inline constexpr std::size_t accumulate_rma_min_run = 16;
+
+template <typename T>
+void accumulate_combined(auto &&dr, const std::vector<std::size_t> &indices,
+                         const std::vector<T> &values, auto &&op) {
+  auto offsets = segment_offsets(dr);
+
+  using Op = std::remove_cvref_t<decltype(op)>;
+  using segment_iterator = rng::iterator_t<
+      rng::range_value_t<decltype(dr::ranges::segments(dr))>>;
+  if constexpr (mpi_arithmetic<T> &&
+                requires(segment_iterator it, const T *src) {
+                  it.accumulate(src, 1, MPI_SUM);
+                }) {
+    if (mpi_op<Op, T>() != MPI_OP_NULL) {
+      // Count the RMA operations needed and the distinct destinations
+      std::size_t counts[2] = {0, rng::size(indices)};
+      for (std::size_t i = 0; i < rng::size(indices); i++) {
+        if (i == 0 || indices[i] != indices[i - 1] + 1 ||
+            owning_segment(offsets, indices[i]) !=
+                owning_segment(offsets, indices[i - 1])) {
+          counts[0]++;
+        }
+      }
+      default_comm().all_reduce(counts, 2, MPI_SUM);
+      auto [runs, distinct] = counts;
+      dr::drlog.debug("accumulate: runs: {} distinct: {}\n", runs, distinct);
+      if (distinct >= accumulate_rma_min_run * runs) {
+        accumulate_rma(dr, offsets, indices, values, mpi_op<Op, T>());
+        return;
+      }
+    }
+  }
+
+  accumulate_owner(dr, offsets, indices, values, op);
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective update by global index. Each rank passes its own indices
+/// and values, and dr[indices[k]] = op(dr[indices[k]], values[k]) is
+/// applied for every k on every rank. op must be associative and
+/// commutative. Updates are combined locally before they are sent.
+template <dr::distributed_contiguous_range DR,
+          rng::random_access_range Indices, rng::random_access_range Values,
+          typename Op = std::plus<>>
+void accumulate_at(DR &&dr, Indices &&indices, Values &&values, Op op = Op{}) {
+  using value_type = rng::range_value_t<DR>;
+  assert(rng::size(indices) == rng::size(values));
+
+  auto [combined_indices, combined_values] =
+      __detail::combine_updates<value_type>(indices, values, op);
+  dr::drlog.debug("accumulate_at: {} updates combined to {}\n",
+                  rng::size(indices), rng::size(combined_indices));
+  __detail::accumulate_combined(dr, combined_indices, combined_values, op);
+}
+
+/// Collective histogram. Every element of dr is a bin index, and the
+/// count of each bin is added to bins. Elements that are not a valid
+/// bin index are ignored.
+template <dr::distributed_contiguous_range DR,
+          dr::distributed_contiguous_range Bins>
+void histogram(DR &&dr, Bins &&bins) {
+  using input_type = rng::range_value_t<DR>;
+  using count_type = rng::range_value_t<Bins>;
+  std::size_t nbins = rng::size(bins);
+
+  // Copy the local elements to the host
+  std::vector<input_type> local;
+  for (auto &&segment : dr::ranges::segments(dr)) {
+    if (dr::ranges::rank(segment) != default_comm().rank()) {
+      continue;
+    }
+    auto n = rng::size(segment);
+    auto p = std::to_address(dr::ranges::local(rng::begin(segment)));
+    local.resize(rng::size(local) + n);
+    if (mhp::use_sycl()) {
+#ifdef SYCL_LANGUAGE_VERSION
+      sycl_queue().copy(p, local.data() + rng::size(local) - n, n).wait();
+#else
+      assert(false);
+#endif
+    } else {
+      std::copy(p, p + n, local.end() - n);
+    }
+  }
+
+  auto valid = [nbins](auto v) {
+    return std::cmp_greater_equal(v, 0) && std::cmp_less(v, nbins);
+  };
+  std::vector<std::size_t> indices;
+  std::vector<count_type> counts;
+  if (nbins <= 4 * rng::size(local)) {
+    // Few bins: count directly
+    std::vector<count_type> dense(nbins, 0);
+    for (auto v : local) {
+      if (valid(v)) {
+        dense[v]++;
+      }
+    }
+    for (std::size_t i = 0; i < nbins; i++) {
+      if (dense[i] != 0) {
+        indices.push_back(i);
+        counts.push_back(dense[i]);
+      }
+    }
+  } else {
+    // Many bins: combine by sorting
+    for (auto v : local) {
+      if (valid(v)) {
+        indices.push_back(v);
+      }
+    }
+    std::vector<count_type> ones(rng::size(indices), 1);
+    std::tie(indices, counts) =
+        __detail::combine_updates<count_type>(indices, ones, std::plus<>{});
+  }
+
+  __detail::accumulate_combined(bins, indices, counts, std::plus<>{});
+}
+
+} // namespace dr::mhp
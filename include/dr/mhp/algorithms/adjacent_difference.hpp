@@ -0,0 +1,319 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/algorithms/copy_if.hpp>
+#include <dr/mhp/algorithms/merge.hpp>
+#include <dr/mhp/algorithms/scan_by_key.hpp>
+#include <dr/mhp/global.hpp>
+#include <dr/mhp/sycl_support.hpp>
+
+namespace dr::mhp::__detail {
+
+// A local segment of a range on the host, with the elements of the
+// range before it at first[-1], ..., first[-before]
+template <typename T> struct window_segment {
+  const T *first;
+  // index is the position of the segment among the nonempty segments,
+  // and offset the position of its first element in the range
+  std::size_t size, before, index, offset;
+  std::vector<T> host;
+};
+
+// Reads [first, first + n) of a local segment, which may be in device
+// memory, to the host
+template <typename T> void get_local(const T *first, std::size_t n, T *dst) {
+  if (mhp::use_sycl()) {
+    sycl_copy(first, first + n, dst);
+  } else {
+    std::copy(first, first + n, dst);
+  }
+}
+
+// Local outputs of the local segments of r, for the output at out
+template <typename U>
+std::vector<U *> local_outputs(dr::distributed_range auto &&r,
+                               dr::distributed_iterator auto out) {
+  std::vector<U *> outputs;
+  auto me = default_comm().rank();
+  for (auto &&[s, o] : rng::views::zip(dr::ranges::segments(r),
+                                       dr::ranges::segments(out))) {
+    if (rng::distance(s) > 0 && dr::ranges::rank(s) == me) {
+      outputs.push_back(std::to_address(dr::ranges::local(rng::begin(o))));
+    }
+  }
+  return outputs;
+}
+
+// Collective. The local segments of r, each with the before elements
+// of r in front of it, or all of them at the start of r.
+//
+// When the container has a halo that is at least before wide, one
+// halo exchange brings the elements in front of every segment, and
+// the segments are read in place. Otherwise, the elements are read
+// from the ranks that own them, and the segment is copied after them.
+// A segment on the device, or one that is also its output in outputs,
+// is always copied to the host.
+//
+// If the caller writes to r afterwards, sync makes every rank finish
+// reading from the others before any rank returns, so no rank
+// overwrites an element that another rank has not read yet.
+template <typename T, typename U = T>
+std::vector<window_segment<T>>
+window_segments(dr::distributed_range auto &&r, std::size_t before,
+                const std::vector<U *> &outputs = {}, bool sync = false) {
+  auto me = default_comm().rank();
+  auto segments = dr::ranges::segments(r);
+
+  // Every rank makes the same choice, because the exchange is
+  // collective
+  bool borrow = true, exchange = false;
+  std::size_t offset = 0;
+  for (auto &&s : segments) {
+    std::size_t m = std::min(before, offset);
+    if constexpr (requires { rng::begin(s).halo_bounds(); }) {
+      borrow = borrow && rng::begin(s).halo_bounds().prev >= m;
+    } else {
+      borrow = false;
+    }
+    exchange = exchange || m > 0;
+    offset += rng::distance(s);
+  }
+  if constexpr (requires { rng::begin(*rng::begin(segments)).halo(); }) {
+    if (borrow && exchange && !rng::empty(segments)) {
+      rng::begin(*rng::begin(segments)).halo().exchange();
+    }
+  }
+
+  std::vector<window_segment<T>> local;
+  offset = 0;
+  std::size_t index = 0;
+  for (auto &&s : segments) {
+    std::size_t n = rng::distance(s), m = std::min(before, offset);
+    if (n > 0 && dr::ranges::rank(s) == me) {
+      const T *first = std::to_address(dr::ranges::local(rng::begin(s)));
+      std::size_t k = rng::size(local);
+      bool in_place = k < rng::size(outputs) &&
+                      static_cast<const void *>(outputs[k]) == first;
+      window_segment<T> w{first, n, m, index, offset, {}};
+      if (mhp::use_sycl() || in_place || !borrow) {
+        w.host.resize(m + n);
+        if (borrow) {
+          get_local(first - m, m + n, w.host.data());
+        } else {
+          get_elements(rng::begin(r) + (offset - m), m, w.host.data());
+          get_local(first, n, w.host.data() + m);
+        }
+        w.first = w.host.data() + m;
+      }
+      local.push_back(std::move(w));
+    }
+    index += n > 0;
+    offset += n;
+  }
+  if (sync && exchange && !borrow) {
+    barrier();
+  }
+  dr::drlog.debug("window segments: before: {} halo: {}\n", before, borrow);
+  return local;
+}
+
+// Calls fn(segment, first, last) for chunks [first, last) of the local
+// segments, in parallel. A chunk reads the before elements in front of
+// it again, so chunks are much longer than that.
+template <typename T, typename Fn>
+void for_each_window_chunk(const std::vector<window_segment<T>> &segments,
+                           std::size_t before, Fn fn) {
+  struct chunk {
+    std::size_t segment, first, last;
+  };
+  std::size_t size = std::max(std::size_t(1) << 14, 8 * before);
+  std::vector<chunk> chunks;
+  for (std::size_t s = 0; s < rng::size(segments); s++) {
+    for (std::size_t i = 0; i < segments[s].size; i += size) {
+      chunks.push_back({s, i, std::min(i + size, segments[s].size)});
+    }
+  }
+  std::for_each(std::execution::par, chunks.begin(), chunks.end(),
+                [&](const chunk &c) { fn(c.segment, c.first, c.last); });
+}
+
+// Collective. Writes the output of a window kernel for r to out. The
+// kernel is called for chunks as kernel(in, before, index, o, n): it
+// writes o[0], ..., o[n - 1] for in[0], ..., in[n - 1], where in[0] is
+// element index of r, and in[-1], ..., in[-before] are the elements in
+// front of it.
+template <typename U, typename Kernel>
+void window_transform(dr::distributed_range auto &&r,
+                      dr::distributed_iterator auto out, std::size_t before,
+                      Kernel kernel) {
+  using T = rng::range_value_t<decltype(r)>;
+  assert(aligned(r, out));
+  auto outputs = local_outputs<U>(r, out);
+  // out may be r, so the reads must finish before the writes
+  auto segments = window_segments<T>(r, before, outputs, true);
+
+  std::vector<std::vector<U>> host(rng::size(segments));
+  if (mhp::use_sycl()) {
+    for (std::size_t s = 0; s < rng::size(segments); s++) {
+      host[s].resize(segments[s].size);
+    }
+  }
+  auto chunk = [&](std::size_t s, std::size_t first, std::size_t last) {
+    auto &w = segments[s];
+    U *o = mhp::use_sycl() ? host[s].data() : outputs[s];
+    kernel(w.first + first, std::min(before, w.before + first),
+           w.offset + first, o + first, last - first);
+  };
+  for_each_window_chunk(segments, before, chunk);
+  if (mhp::use_sycl()) {
+    for (std::size_t s = 0; s < rng::size(segments); s++) {
+      put_local(host[s].data(), segments[s].size, outputs[s]);
+    }
+  }
+  barrier();
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective. Writes r[0] to out[0] and op(r[i], r[i - 1]) to out[i],
+/// like std::adjacent_difference. out must be aligned with r, and it
+/// may be the beginning of r. The element in front of every segment
+/// comes from the halo of the container, or from the rank that owns
+/// it.
+template <dr::distributed_range DR, dr::distributed_iterator O,
+          typename BinaryOp = std::minus<>>
+O adjacent_difference(DR &&r, O out, BinaryOp op = BinaryOp()) {
+  using U = std::iter_value_t<O>;
+  __detail::window_transform<U>(
+      r, out, 1,
+      [op](auto in, std::size_t before, std::size_t, U *o, std::size_t n) {
+        std::size_t first = 0;
+        if (before == 0) {
+          o[0] = in[0];
+          first = 1;
+        }
+        for (std::size_t i = first; i < n; i++) {
+          o[i] = op(in[i], in[i - 1]);
+        }
+      });
+  return out + rng::distance(r);
+}
+
+/// Collective. Returns an iterator to the first element of r that is
+/// before the element in front of it under comp, or the end of r, like
+/// std::is_sorted_until.
+template <dr::distributed_range DR, typename Compare = std::less<>>
+auto is_sorted_until(DR &&r, Compare comp = Compare()) {
+  using T = rng::range_value_t<DR>;
+  std::int64_t n = rng::distance(r);
+  auto segments = __detail::window_segments<T>(r, 1);
+
+  std::vector<std::int64_t> firsts(rng::size(segments), n);
+  for (std::size_t s = 0; s < rng::size(segments); s++) {
+    auto &w = segments[s];
+    auto first = w.before == 0 ? w.first : w.first - 1;
+    auto last = w.first + w.size;
+    auto it = std::is_sorted_until(std::execution::par_unseq, first, last,
+                                   comp);
+    if (it != last) {
+      firsts[s] = w.offset + (it - w.first);
+    }
+  }
+  std::int64_t position = n;
+  if (!rng::empty(firsts)) {
+    position = *std::min_element(firsts.begin(), firsts.end());
+  }
+  // int64, because MPI_MIN of unsigned 64 bit values is not reliable
+  position = default_comm().all_reduce(position, MPI_MIN);
+  return rng::begin(r) + position;
+}
+
+/// Collective. Returns true if r is sorted under comp, like
+/// std::is_sorted
+template <dr::distributed_range DR, typename Compare = std::less<>>
+bool is_sorted(DR &&r, Compare comp = Compare()) {
+  return mhp::is_sorted_until(r, comp) == rng::end(r);
+}
+
+/// Collective. Writes the first element of every run of consecutive
+/// elements of r that satisfy pred to values_out, and the length of
+/// the run to counts_out. Returns the ends of both outputs.
+///
+/// The element in front of every segment decides if its first element
+/// starts a run. The length of the last run of a segment comes from one
+/// all gather of the first run of every segment. The runs are
+/// redistributed to the outputs like copy_if.
+template <dr::distributed_range DR, dr::distributed_contiguous_iterator VO,
+          dr::distributed_contiguous_iterator CO,
+          typename Pred = std::equal_to<>>
+std::pair<VO, CO> run_length_encode(DR &&r, VO values_out, CO counts_out,
+                                    Pred pred = Pred()) {
+  using T = rng::range_value_t<DR>;
+  using C = std::iter_value_t<CO>;
+  assert(__detail::ranks_in_order(r));
+  std::int64_t n = rng::distance(r);
+  auto segments = __detail::window_segments<T>(r, 1);
+
+  std::vector<T> values;
+  std::vector<std::int64_t> starts, first_starts;
+  for (auto &w : segments) {
+    first_starts.push_back(-1);
+    for (std::size_t i = 0; i < w.size; i++) {
+      if ((i == 0 && w.before == 0) || !pred(w.first[i - 1], w.first[i])) {
+        if (first_starts.back() < 0) {
+          first_starts.back() = w.offset + i;
+        }
+        values.push_back(w.first[i]);
+        starts.push_back(w.offset + i);
+      }
+    }
+  }
+
+  // The run after the last one of this rank starts at the first start
+  // in a later segment
+  std::vector<std::size_t> ranks;
+  for (auto &&s : dr::ranges::segments(r)) {
+    if (rng::distance(s) > 0) {
+      ranks.push_back(dr::ranges::rank(s));
+    }
+  }
+  auto all_starts = __detail::gather_segments(ranks, first_starts);
+  std::int64_t next = n;
+  if (!rng::empty(segments)) {
+    for (std::size_t i = segments.back().index + 1; i < rng::size(ranks);
+         i++) {
+      if (all_starts[i] >= 0) {
+        next = all_starts[i];
+        break;
+      }
+    }
+  }
+  std::vector<C> counts(rng::size(starts));
+  for (std::size_t k = 0; k < rng::size(starts); k++) {
+    std::int64_t end = k + 1 < rng::size(starts) ? starts[k + 1] : next;
+    counts[k] = C(end - starts[k]);
+  }
+
+  std::array<std::size_t, 1> local_runs{rng::size(values)};
+  dr::drlog.debug("run length encode: local runs: {}\n", local_runs[0]);
+  auto runs = __detail::redistribute<1>(values, local_runs, values_out)[0];
+  __detail::redistribute<1>(counts, local_runs, counts_out);
+  return {values_out + runs, counts_out + runs};
+}
+
+} // namespace dr::mhp
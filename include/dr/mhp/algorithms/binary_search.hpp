@@ -0,0 +1,315 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/global.hpp>
+#include <dr/mhp/sycl_support.hpp>
+
+namespace dr::mhp::__detail {
+
+// A nonempty segment of a range, with its first and last values
+template <typename T> struct segment_bound {
+  std::size_t offset, size, rank;
+  T first, last;
+};
+
+// The segments of a range in order, with their boundary values. For a
+// sorted range, this is enough to find the segment that holds the
+// answer to a search without asking the other ranks.
+template <typename T> struct segment_bounds {
+  std::vector<segment_bound<T>> segments;
+  std::size_t size = 0;
+
+  // FNV-1a of the table, used to check that all ranks have the same
+  // table. Non-negative, so it can be reduced as a signed value.
+  std::int64_t hash() const {
+    std::uint64_t h = 14695981039346656037ull;
+    auto add = [&h](const void *p, std::size_t n) {
+      for (std::size_t i = 0; i < n; i++) {
+        h = (h ^ static_cast<const unsigned char *>(p)[i]) * 1099511628211ull;
+      }
+    };
+    add(&size, sizeof(size));
+    for (auto &s : segments) {
+      add(&s.offset, sizeof(s.offset));
+      add(&s.size, sizeof(s.size));
+      add(&s.rank, sizeof(s.rank));
+      add(&s.first, sizeof(T));
+      add(&s.last, sizeof(T));
+    }
+    return std::int64_t(h >> 1);
+  }
+};
+
+// Tables are cached by the address of the range, and checked before
+// they are used, so a stale entry costs a recomputation, not a wrong
+// answer
+template <typename T>
+inline std::map<const void *, segment_bounds<T>> bounds_cache_;
+inline constexpr std::size_t bounds_cache_entries = 16;
+
+// Reads an element of a local segment, which may be in device memory
+template <typename T> T local_value(T *p) {
+  return mhp::use_sycl() ? sycl_get(*p) : *p;
+}
+
+// Index of the first element in [first, first + n) that is not before
+// value, or the first that is after value if upper
+template <typename T, typename U, typename Compare>
+std::size_t local_bound(T *first, std::size_t n, const U &value, bool upper,
+                        Compare &comp) {
+  if (!mhp::use_sycl()) {
+    return upper ? std::upper_bound(first, first + n, value, comp) - first
+                 : std::lower_bound(first, first + n, value, comp) - first;
+  }
+
+  // Few probes, each one reads an element from the device
+  std::size_t lo = 0, hi = n;
+  while (lo < hi) {
+    std::size_t mid = lo + (hi - lo) / 2;
+    T x = local_value(first + mid);
+    if (upper ? !comp(value, x) : comp(x, value)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// Nonempty segments of r, with their positions, and pointers to the
+// local ones. The boundary values are not set.
+template <typename T>
+auto segment_layout(dr::distributed_range auto &&r,
+                    std::vector<T *> *locals = nullptr) {
+  segment_bounds<T> bounds;
+  for (auto &&segment : dr::ranges::segments(r)) {
+    std::size_t size = rng::distance(segment);
+    if (size > 0) {
+      std::size_t rank = dr::ranges::rank(segment);
+      bounds.segments.push_back({bounds.size, size, rank, T{}, T{}});
+      if (locals != nullptr) {
+        locals->push_back(rank == default_comm().rank()
+                              ? std::to_address(
+                                    dr::ranges::local(rng::begin(segment)))
+                              : nullptr);
+      }
+    }
+    bounds.size += size;
+  }
+  return bounds;
+}
+
+// Collective. Table of the boundary values of the segments of r, with
+// one all gather.
+template <typename T>
+segment_bounds<T> compute_bounds(dr::distributed_range auto &&r) {
+  auto comm = default_comm();
+  std::size_t nprocs = comm.size(); // dr-style ignore
+  std::vector<T *> locals;
+  auto bounds = segment_layout<T>(r, &locals);
+
+  // Boundary values of the local segments, and where the values of
+  // each rank go in the gathered array
+  std::vector<T> mine, all(2 * rng::size(bounds.segments));
+  std::vector<int> counts(nprocs), offsets(nprocs);
+  for (std::size_t i = 0; i < rng::size(bounds.segments); i++) {
+    auto &s = bounds.segments[i];
+    counts[s.rank] += 2 * sizeof(T);
+    if (locals[i] != nullptr) {
+      mine.push_back(local_value(locals[i]));
+      mine.push_back(local_value(locals[i] + s.size - 1));
+    }
+  }
+  std::exclusive_scan(counts.begin(), counts.end(), offsets.begin(), 0);
+  comm.all_gatherv(mine.data(), counts.data(), offsets.data(), all.data());
+
+  // The values of a rank are in the order of its segments
+  std::vector<std::size_t> next(nprocs);
+  for (std::size_t q = 0; q < nprocs; q++) {
+    next[q] = offsets[q] / sizeof(T);
+  }
+  for (auto &s : bounds.segments) {
+    s.first = all[next[s.rank]++];
+    s.last = all[next[s.rank]++];
+  }
+  dr::drlog.debug("compute bounds: segments: {}\n",
+                  rng::size(bounds.segments));
+  return bounds;
+}
+
+// True if the table describes the local segments of r. When this is
+// true on every rank and all ranks have the same table, the table is
+// correct.
+template <typename T>
+bool bounds_match(const segment_bounds<T> &bounds,
+                  dr::distributed_range auto &&r) {
+  std::vector<T *> locals;
+  auto layout = segment_layout<T>(r, &locals);
+  if (layout.size != bounds.size ||
+      rng::size(layout.segments) != rng::size(bounds.segments)) {
+    return false;
+  }
+  for (std::size_t i = 0; i < rng::size(locals); i++) {
+    auto &s = bounds.segments[i];
+    if (s.offset != layout.segments[i].offset ||
+        s.size != layout.segments[i].size ||
+        s.rank != layout.segments[i].rank) {
+      return false;
+    }
+    if (locals[i] != nullptr) {
+      T first = local_value(locals[i]);
+      T last = local_value(locals[i] + s.size - 1);
+      if (std::memcmp(&first, &s.first, sizeof(T)) != 0 ||
+          std::memcmp(&last, &s.last, sizeof(T)) != 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+template <typename T>
+segment_bounds<T> &cached_bounds(dr::distributed_range auto &&r) {
+  auto &cache = bounds_cache_<T>;
+  const void *key = std::addressof(r);
+  if (!cache.contains(key) && rng::size(cache) >= bounds_cache_entries) {
+    cache.clear();
+  }
+  return cache[key];
+}
+
+/// Collective. Computes the boundary values of r and caches them for
+/// later searches. Called after sort.
+template <dr::distributed_range DR> void cache_bounds(DR &&r) {
+  using T = rng::range_value_t<DR>;
+  cached_bounds<T>(r) = compute_bounds<T>(r);
+}
+
+/// Collective. Table of the boundary values of r, from the cache when
+/// it is valid. Costs one small all reduce when it is.
+template <dr::distributed_range DR> const auto &checked_bounds(DR &&r) {
+  using T = rng::range_value_t<DR>;
+  auto &bounds = cached_bounds<T>(r);
+  std::int64_t h = bounds.hash();
+  std::array<std::int64_t, 3> check = {!bounds_match(bounds, r), h, -h};
+  default_comm().all_reduce(check.data(), 3, MPI_MAX);
+  if (check[0] || check[1] != -check[2]) {
+    bounds = compute_bounds<T>(r);
+  }
+  return bounds;
+}
+
+/// Collective. Global positions of the lower bounds of values, or the
+/// upper bounds where upper is set, in the sorted range r.
+///
+/// The segment that holds an answer is found in the table of boundary
+/// values, and only its owner searches. The check of the cached table
+/// and the answers share one all reduce, so a search with a valid
+/// cache costs one collective. Otherwise, the table is computed again
+/// and the search is repeated.
+template <std::size_t K, typename U, typename Compare>
+std::array<std::size_t, K> bound_positions(dr::distributed_range auto &&r,
+                                           const std::array<U, K> &values,
+                                           const std::array<bool, K> &upper,
+                                           Compare comp) {
+  using T = rng::range_value_t<decltype(r)>;
+  auto &bounds = cached_bounds<T>(r);
+  auto me = default_comm().rank();
+
+  for (std::size_t attempt = 0;; attempt++) {
+    assert(attempt < 2);
+    std::vector<T *> locals;
+    segment_layout<T>(r, &locals);
+    bool stale = !bounds_match(bounds, r);
+    std::int64_t h = bounds.hash();
+
+    // {stale, hash, -hash, positions}
+    std::array<std::int64_t, 3 + K> all;
+    all[0] = stale;
+    all[1] = h;
+    all[2] = -h;
+    for (std::size_t k = 0; k < K; k++) {
+      all[3 + k] = -1;
+      if (stale) {
+        continue;
+      }
+      // First segment that ends at or after the answer
+      auto &segments = bounds.segments;
+      auto it = std::partition_point(
+          segments.begin(), segments.end(), [&](const auto &s) {
+            return upper[k] ? !comp(values[k], s.last)
+                            : comp(s.last, values[k]);
+          });
+      if (it != segments.end() && it->rank == me) {
+        std::size_t i = it - segments.begin();
+        all[3 + k] = it->offset + local_bound(locals[i], it->size, values[k],
+                                              upper[k], comp);
+      }
+    }
+    default_comm().all_reduce(all.data(), 3 + K, MPI_MAX);
+
+    if (!all[0] && all[1] == -all[2]) {
+      std::array<std::size_t, K> positions;
+      for (std::size_t k = 0; k < K; k++) {
+        positions[k] = all[3 + k] < 0 ? bounds.size : all[3 + k];
+      }
+      return positions;
+    }
+    bounds = compute_bounds<T>(r);
+  }
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective. Returns an iterator to the first element of the sorted
+/// range r that is not before value, or the end of r. Uses the
+/// boundary values of the segments, cached by sort, to search on one
+/// rank only.
+template <dr::distributed_contiguous_range DR, typename T,
+          typename Compare = std::less<>>
+auto lower_bound(DR &&r, const T &value, Compare comp = Compare()) {
+  auto [position] = __detail::bound_positions<1>(
+      r, std::array<T, 1>{value}, std::array<bool, 1>{false}, comp);
+  return rng::begin(r) + position;
+}
+
+/// Collective. Returns an iterator to the first element of the sorted
+/// range r that is after value, or the end of r.
+template <dr::distributed_contiguous_range DR, typename T,
+          typename Compare = std::less<>>
+auto upper_bound(DR &&r, const T &value, Compare comp = Compare()) {
+  auto [position] = __detail::bound_positions<1>(
+      r, std::array<T, 1>{value}, std::array<bool, 1>{true}, comp);
+  return rng::begin(r) + position;
+}
+
+/// Collective. Returns the lower and upper bounds of value in the
+/// sorted range r, with one search.
+template <dr::distributed_contiguous_range DR, typename T,
+          typename Compare = std::less<>>
+auto equal_range(DR &&r, const T &value, Compare comp = Compare()) {
+  auto [lower, upper] = __detail::bound_positions<2>(
+      r, std::array<T, 2>{value, value}, std::array<bool, 2>{false, true},
+      comp);
+  return std::pair(rng::begin(r) + lower, rng::begin(r) + upper);
+}
+
+} // namespace dr::mhp
@@ -0,0 +1,360 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/onedpl_direct_iterator.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/detail/utils.hpp>
+#include <dr/mhp/algorithms/transform_reduce.hpp>
+#include <dr/mhp/global.hpp>
+
+namespace dr::mhp::__detail {
+
+// Elements compacted by one task
+inline constexpr std::size_t compact_chunk = 1 << 14;
+
+// Compacts n elements on the CPU, a chunk per task. mask holds the
+// class of every element, and values gets the elements of each class
+// in order, starting at offsets[class].
+template <std::size_t Classes, typename T, typename Iter>
+void chunk_compact(std::size_t n, Iter first, const std::uint8_t *mask,
+                   T *values, std::array<std::size_t, Classes> offsets,
+                   const std::array<std::size_t, Classes> &counts) {
+  std::array<T *, Classes> out;
+  for (std::size_t j = 0; j < Classes; j++) {
+    out[j] = values + offsets[j];
+  }
+  if constexpr (Classes == 1) {
+    // Mask compress: every element is stored at the next position and
+    // the position only advances if it is kept. The loop stops after
+    // the last kept element, so nothing is stored past the chunk.
+    std::size_t k = 0;
+    for (std::size_t i = 0; k < counts[0]; i++) {
+      out[0][k] = first[i];
+      k += mask[i] == 0;
+    }
+  } else {
+    std::array<std::size_t, Classes> k{};
+    for (std::size_t i = 0; i < n; i++) {
+      std::size_t j = mask[i];
+      if (j < Classes) {
+        out[j][k[j]++] = first[i];
+      }
+    }
+  }
+}
+
+// Compacts the local elements of r on the CPU
+template <std::size_t Classes, typename T, typename R, typename C>
+std::array<std::size_t, Classes> cpu_compact(R &&r, C &classify,
+                                             std::vector<T> &values) {
+  using segment = rng::range_value_t<decltype(local_segments(r))>;
+  using iterator = decltype(segment_begin(std::declval<segment &>()));
+  struct chunk {
+    iterator first;
+    std::size_t size;
+    std::array<std::size_t, Classes> counts;
+  };
+  std::vector<chunk> chunks;
+  for (auto &&s : local_segments(r)) {
+    std::size_t n = rng::distance(s);
+    for (std::size_t i = 0; i < n; i += compact_chunk) {
+      chunks.push_back(
+          {segment_begin(s) + i, std::min(compact_chunk, n - i), {}});
+    }
+  }
+  std::vector<std::uint8_t> mask(rng::size(chunks) * compact_chunk);
+  std::vector<std::size_t> ids(rng::size(chunks));
+  std::iota(ids.begin(), ids.end(), 0);
+
+  // Classify and count, without branches
+  std::for_each(std::execution::par_unseq, ids.begin(), ids.end(),
+                [&](std::size_t c) {
+                  auto &ch = chunks[c];
+                  auto *m = mask.data() + c * compact_chunk;
+                  std::array<std::size_t, Classes> counts{};
+                  for (std::size_t i = 0; i < ch.size; i++) {
+                    auto j = std::size_t(classify(ch.first[i]));
+                    m[i] = std::uint8_t(std::min(j, Classes));
+                    for (std::size_t k = 0; k < Classes; k++) {
+                      counts[k] += j == k;
+                    }
+                  }
+                  ch.counts = counts;
+                });
+
+  // Output offsets of the chunks: all of class 0 first, then class 1
+  std::array<std::size_t, Classes> totals{};
+  for (auto &ch : chunks) {
+    for (std::size_t j = 0; j < Classes; j++) {
+      totals[j] += ch.counts[j];
+    }
+  }
+  std::vector<std::array<std::size_t, Classes>> offsets(rng::size(chunks));
+  std::array<std::size_t, Classes> next;
+  std::exclusive_scan(totals.begin(), totals.end(), next.begin(),
+                      std::size_t(0));
+  for (std::size_t c = 0; c < rng::size(chunks); c++) {
+    offsets[c] = next;
+    for (std::size_t j = 0; j < Classes; j++) {
+      next[j] += chunks[c].counts[j];
+    }
+  }
+
+  values.resize(std::reduce(totals.begin(), totals.end()));
+  std::for_each(std::execution::par_unseq, ids.begin(), ids.end(),
+                [&](std::size_t c) {
+                  auto &ch = chunks[c];
+                  chunk_compact<Classes>(ch.size, ch.first,
+                                         mask.data() + c * compact_chunk,
+                                         values.data(), offsets[c], ch.counts);
+                });
+  return totals;
+}
+
+// Compacts the local elements of r on the device, a copy_if per class
+// and segment, and copies the result to values
+template <std::size_t Classes, typename T, typename R, typename C>
+std::array<std::size_t, Classes> sycl_compact(R &&r, C &classify,
+                                              std::vector<T> &values) {
+  std::array<std::vector<T>, Classes> parts;
+#ifdef SYCL_LANGUAGE_VERSION
+  for (auto &&s : local_segments(r)) {
+    std::size_t n = rng::distance(s);
+    if (n == 0) {
+      continue;
+    }
+    auto first = dr::__detail::direct_iterator(rng::begin(s));
+    T *staging = sycl::malloc_device<T>(n, sycl_queue());
+    for (std::size_t j = 0; j < Classes; j++) {
+      auto in_class = [classify, j](auto &&x) {
+        return std::size_t(classify(x)) == j;
+      };
+      std::size_t m = std::copy_if(dpl_policy(), first, first + n, staging,
+                                   in_class) -
+                      staging;
+      std::size_t old_size = rng::size(parts[j]);
+      parts[j].resize(old_size + m);
+      sycl_queue().copy(staging, parts[j].data() + old_size, m).wait();
+    }
+    sycl::free(staging, sycl_queue());
+  }
+#else
+  assert(false);
+#endif
+
+  std::array<std::size_t, Classes> totals;
+  for (std::size_t j = 0; j < Classes; j++) {
+    totals[j] = rng::size(parts[j]);
+    values.insert(values.end(), parts[j].begin(), parts[j].end());
+  }
+  return totals;
+}
+
+// Local segments of r must be in rank order for the offsets of the
+// ranks to be a scan
+inline bool ranks_in_order(dr::distributed_range auto &&r) {
+  std::size_t last = 0;
+  for (auto &&segment : dr::ranges::segments(r)) {
+    if (rng::distance(segment) > 0) {
+      if (dr::ranges::rank(segment) < last) {
+        return false;
+      }
+      last = dr::ranges::rank(segment);
+    }
+  }
+  return true;
+}
+
+/// Collective. Writes the elements in values on every rank to out, and
+/// returns the number of elements of each class on all ranks. values
+/// holds counts[0] elements of class 0, then counts[1] of class 1, and
+/// so on. The output has all elements of class 0 first, then class 1,
+/// each in rank order.
+///
+/// Every rank gets the position of its output from one exclusive scan
+/// of the counts. The elements are sent to the ranks that own their
+/// positions in out, under its distribution, with one all to all.
+template <std::size_t Classes, typename T>
+std::array<std::size_t, Classes>
+redistribute(const std::vector<T> &values,
+             const std::array<std::size_t, Classes> &counts,
+             dr::distributed_contiguous_iterator auto out) {
+  auto comm = default_comm();
+  std::size_t nprocs = comm.size(); // dr-style ignore
+
+  // Position of the output of this rank in each class, and the first
+  // position of each class
+  std::array<std::size_t, Classes> offsets, totals = counts, bases;
+  comm.exscan(counts.data(), offsets.data(), Classes, MPI_SUM);
+  comm.all_reduce(totals.data(), Classes, MPI_SUM);
+  std::exclusive_scan(totals.begin(), totals.end(), bases.begin(),
+                      std::size_t(0));
+  std::size_t total = std::reduce(totals.begin(), totals.end());
+  dr::drlog.debug("redistribute: local: {} total: {}\n", rng::size(values),
+                  total);
+
+  // The part of the output that each rank owns
+  struct part {
+    std::size_t first = 0, last = 0;
+  };
+  std::vector<part> owned(nprocs);
+  T *local_out = nullptr;
+  std::size_t position = 0;
+  for (auto &&segment : dr::ranges::segments(out)) {
+    std::size_t size = rng::distance(segment);
+    std::size_t first = position, last = std::min(position + size, total);
+    if (first < last) {
+      auto rank = dr::ranges::rank(segment);
+      // A rank owns one part
+      assert(owned[rank].first == owned[rank].last);
+      owned[rank] = {first, last};
+      if (rank == comm.rank()) {
+        local_out = dr::ranges::local(rng::begin(segment));
+      }
+    }
+    position += size;
+  }
+  assert(position >= total);
+
+  // Elements sent to each rank, by class. The output positions
+  // increase along values, so the elements for a rank are contiguous.
+  std::vector<std::size_t> class_sends(nprocs * Classes),
+      class_receives(nprocs * Classes);
+  std::vector<std::size_t> send_counts(nprocs), send_offsets(nprocs);
+  for (std::size_t d = 0; d < nprocs; d++) {
+    bool first_class = true;
+    for (std::size_t j = 0, start = 0; j < Classes; start += counts[j++]) {
+      std::size_t first = bases[j] + offsets[j];
+      std::size_t lo = std::max(first, owned[d].first);
+      std::size_t hi = std::min(first + counts[j], owned[d].last);
+      if (lo < hi) {
+        if (first_class) {
+          send_offsets[d] = start + (lo - first);
+          first_class = false;
+        }
+        class_sends[d * Classes + j] = hi - lo;
+        send_counts[d] += hi - lo;
+      }
+    }
+  }
+  comm.alltoall(class_sends, class_receives, Classes);
+
+  std::vector<std::size_t> receive_counts(nprocs), receive_offsets(nprocs);
+  for (std::size_t s = 0; s < nprocs; s++) {
+    for (std::size_t j = 0; j < Classes; j++) {
+      receive_counts[s] += class_receives[s * Classes + j];
+    }
+  }
+  std::exclusive_scan(receive_counts.begin(), receive_counts.end(),
+                      receive_offsets.begin(), std::size_t(0));
+  std::vector<T> received(receive_offsets.back() + receive_counts.back());
+  comm.alltoallv(values, send_counts, send_offsets, received, receive_counts,
+                 receive_offsets);
+
+  // Each class fills its part of the local output in rank order
+  auto mine = owned[comm.rank()];
+  std::array<std::size_t, Classes> next;
+  for (std::size_t j = 0; j < Classes; j++) {
+    next[j] = std::max(mine.first, bases[j]) - mine.first;
+  }
+  const T *in = received.data();
+  for (std::size_t s = 0; s < nprocs; s++) {
+    for (std::size_t j = 0; j < Classes; j++) {
+      std::size_t n = class_receives[s * Classes + j];
+      if (n == 0) {
+        continue;
+      }
+      if (mhp::use_sycl()) {
+#ifdef SYCL_LANGUAGE_VERSION
+        sycl_queue().copy(in, local_out + next[j], n).wait();
+#else
+        assert(false);
+#endif
+      } else {
+        std::copy(in, in + n, local_out + next[j]);
+      }
+      in += n;
+      next[j] += n;
+    }
+  }
+
+  barrier();
+  return totals;
+}
+
+/// Collective. Writes the elements of r to out by class, like
+/// redistribute, and returns the number of elements of each class.
+/// classify(x) is the class of x, and elements of class Classes or
+/// more are dropped.
+template <std::size_t Classes, typename C>
+std::array<std::size_t, Classes>
+compact(dr::distributed_range auto &&r,
+        dr::distributed_contiguous_iterator auto out, C classify) {
+  using T = rng::range_value_t<decltype(r)>;
+  assert(ranks_in_order(r));
+
+  std::vector<T> values;
+  auto counts = mhp::use_sycl() ? sycl_compact<Classes>(r, classify, values)
+                                : cpu_compact<Classes>(r, classify, values);
+  return redistribute<Classes>(values, counts, out);
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective. Copies the elements of r that satisfy pred to out,
+/// keeping their order, and returns the end of the output. The output
+/// is written where out places it, without gathering it on a rank. out
+/// may be the beginning of r.
+template <dr::distributed_range DR, dr::distributed_contiguous_iterator O,
+          typename Pred>
+O copy_if(DR &&r, O out, Pred pred) {
+  dr::drlog.debug("copy_if\n");
+  auto counts = __detail::compact<1>(
+      r, out, [pred](auto &&x) { return pred(x) ? 0 : 1; });
+  return out + counts[0];
+}
+
+/// Collective. Moves the elements of r that do not satisfy pred to the
+/// front of r, keeping their order, and returns the new end of r. The
+/// elements after the new end keep their old values.
+template <dr::distributed_contiguous_range DR, typename Pred>
+auto remove_if(DR &&r, Pred pred) {
+  return mhp::copy_if(r, rng::begin(r),
+                      [pred](auto &&x) { return !pred(x); });
+}
+
+/// Collective. Removes the elements of r that are equal to value, like
+/// remove_if
+template <dr::distributed_contiguous_range DR, typename T>
+auto remove(DR &&r, const T &value) {
+  return mhp::remove_if(r, [value](auto &&x) { return x == value; });
+}
+
+/// Collective. Moves the elements of r that satisfy pred before the
+/// elements that do not, and returns an iterator to the first element
+/// that does not. The partition is stable: both groups keep their
+/// order.
+template <dr::distributed_contiguous_range DR, typename Pred>
+auto partition(DR &&r, Pred pred) {
+  dr::drlog.debug("partition\n");
+  auto first = rng::begin(r);
+  auto counts = __detail::compact<2>(
+      r, first, [pred](auto &&x) { return pred(x) ? 0 : 1; });
+  return first + counts[0];
+}
+
+} // namespace dr::mhp
@@ -0,0 +1,326 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <complex>
+#include <execution>
+#include <numbers>
+#include <numeric>
+#include <vector>
+
+#include <dr/detail/communicator.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/containers/distributed_mdarray.hpp>
+#include <dr/mhp/containers/mdarray_tiles.hpp>
+#include <dr/mhp/global.hpp>
+#include <dr/mhp/sycl_support.hpp>
+
+namespace dr::mhp::__detail {
+
+//
+// 1D complex FFT of a fixed length. The length is factored into
+// radices 4, 2, 3, 5 and any remaining primes, and each factor is one
+// pass of a Stockham autosort FFT, so no bit reversal is needed.
+// Radix 2 and 4 passes have no multiplications in the butterfly,
+// other radices use a small DFT.
+//
+template <typename T> class fft_plan {
+public:
+  using value_type = std::complex<T>;
+
+  fft_plan(std::size_t n, bool forward) : n_(n) {
+    T sign = forward ? -1 : 1;
+    std::size_t remaining = n;
+    for (std::size_t radix : {4, 2, 3, 5}) {
+      while (remaining % radix == 0) {
+        radices_.push_back(radix);
+        remaining /= radix;
+      }
+    }
+    for (std::size_t radix = 7; remaining > 1; radix += 2) {
+      while (remaining % radix == 0) {
+        radices_.push_back(radix);
+        remaining /= radix;
+      }
+    }
+
+    // Twiddles for every pass: w_len^(p * k) for p < len / radix and
+    // k < radix
+    std::size_t len = n;
+    for (auto radix : radices_) {
+      std::size_t m = len / radix;
+      std::vector<value_type> twiddles(m * radix);
+      for (std::size_t p = 0; p < m; p++) {
+        for (std::size_t k = 0; k < radix; k++) {
+          twiddles[p * radix + k] =
+              std::polar(T(1), sign * 2 * std::numbers::pi_v<T> *
+                                   T(p * k % len) / T(len));
+        }
+      }
+      twiddles_.push_back(std::move(twiddles));
+      len = m;
+    }
+    forward_ = forward;
+  }
+
+  std::size_t length() const { return n_; }
+
+  // Transform data in place. work must hold length() elements.
+  void operator()(value_type *data, value_type *work) const {
+    value_type *x = data, *y = work;
+    std::size_t len = n_, stride = 1;
+    for (std::size_t pass = 0; pass < rng::size(radices_); pass++) {
+      auto radix = radices_[pass];
+      std::size_t m = len / radix;
+      auto &twiddles = twiddles_[pass];
+      if (radix == 2) {
+        radix2(x, y, m, stride, twiddles);
+      } else if (radix == 4) {
+        radix4(x, y, m, stride, twiddles);
+      } else {
+        radix_any(x, y, radix, m, stride, twiddles);
+      }
+      std::swap(x, y);
+      len = m;
+      stride *= radix;
+    }
+    if (x != data) {
+      std::copy(x, x + n_, data);
+    }
+  }
+
+private:
+  // Every pass reads radix sequences of length m, interleaved with
+  // the given stride, and writes radix * m outputs with a stride of
+  // radix * stride
+  static void radix2(const value_type *x, value_type *y, std::size_t m,
+                     std::size_t stride,
+                     const std::vector<value_type> &twiddles) {
+    for (std::size_t p = 0; p < m; p++) {
+      auto w = twiddles[p * 2 + 1];
+      for (std::size_t q = 0; q < stride; q++) {
+        auto a = x[q + stride * p], b = x[q + stride * (p + m)];
+        y[q + stride * (2 * p)] = a + b;
+        y[q + stride * (2 * p + 1)] = (a - b) * w;
+      }
+    }
+  }
+
+  void radix4(const value_type *x, value_type *y, std::size_t m,
+              std::size_t stride,
+              const std::vector<value_type> &twiddles) const {
+    // Multiply by -i for forward, i for backward
+    auto rotate = [forward = forward_](value_type v) {
+      return forward ? value_type(v.imag(), -v.real())
+                     : value_type(-v.imag(), v.real());
+    };
+    for (std::size_t p = 0; p < m; p++) {
+      auto w1 = twiddles[p * 4 + 1], w2 = twiddles[p * 4 + 2],
+           w3 = twiddles[p * 4 + 3];
+      for (std::size_t q = 0; q < stride; q++) {
+        auto a = x[q + stride * p], b = x[q + stride * (p + m)];
+        auto c = x[q + stride * (p + 2 * m)];
+        auto d = x[q + stride * (p + 3 * m)];
+        auto apc = a + c, amc = a - c, bpd = b + d, jbmd = rotate(b - d);
+        auto out = y + q + stride * (4 * p);
+        out[0] = apc + bpd;
+        out[stride] = (amc + jbmd) * w1;
+        out[2 * stride] = (apc - bpd) * w2;
+        out[3 * stride] = (amc - jbmd) * w3;
+      }
+    }
+  }
+
+  void radix_any(const value_type *x, value_type *y, std::size_t radix,
+                 std::size_t m, std::size_t stride,
+                 const std::vector<value_type> &twiddles) const {
+    // Roots of unity for the radix point DFT
+    T sign = forward_ ? -1 : 1;
+    std::vector<value_type> roots(radix);
+    for (std::size_t k = 0; k < radix; k++) {
+      roots[k] =
+          std::polar(T(1), sign * 2 * std::numbers::pi_v<T> * T(k) / T(radix));
+    }
+    for (std::size_t p = 0; p < m; p++) {
+      for (std::size_t q = 0; q < stride; q++) {
+        for (std::size_t k = 0; k < radix; k++) {
+          value_type sum = 0;
+          for (std::size_t j = 0; j < radix; j++) {
+            sum += x[q + stride * (p + j * m)] * roots[j * k % radix];
+          }
+          y[q + stride * (radix * p + k)] = sum * twiddles[p * radix + k];
+        }
+      }
+    }
+  }
+
+  std::size_t n_;
+  bool forward_;
+  std::vector<std::size_t> radices_;
+  std::vector<std::vector<value_type>> twiddles_;
+};
+
+// Transform lines of data in parallel. Line l starts at
+// data + l * line_stride and its elements are element_stride apart.
+template <typename T>
+void fft_lines(const fft_plan<T> &plan, std::complex<T> *data,
+               std::size_t lines, std::size_t line_stride,
+               std::size_t element_stride) {
+  std::size_t n = plan.length();
+  if (n <= 1 || lines == 0) {
+    return;
+  }
+
+  std::vector<std::size_t> indices(lines);
+  std::iota(indices.begin(), indices.end(), 0);
+  std::for_each(std::execution::par_unseq, indices.begin(), indices.end(),
+                [=, &plan](std::size_t l) {
+                  std::vector<std::complex<T>> buffer(2 * n);
+                  auto line = data + l * line_stride;
+                  if (element_stride == 1) {
+                    plan(line, buffer.data());
+                    return;
+                  }
+                  for (std::size_t i = 0; i < n; i++) {
+                    buffer[i] = line[i * element_stride];
+                  }
+                  plan(buffer.data(), buffer.data() + n);
+                  for (std::size_t i = 0; i < n; i++) {
+                    line[i * element_stride] = buffer[i];
+                  }
+                });
+}
+
+// Local planes are transformed and sent in groups, so the exchange of
+// one group overlaps the transforms of the next
+inline constexpr std::size_t fft_pipeline_depth = 4;
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective 3D FFT of a distributed_mdarray with shape (n0, n1, n2).
+/// The result is written to out in transposed order: out has shape
+/// (n1, n0, n2), and out(k1, k0, k2) is element (k0, k1, k2) of the
+/// transform. Calling fft on the result with forward = false returns
+/// the original order. The backward transform is scaled by
+/// 1 / (n0 * n1 * n2), so a forward and backward transform is the
+/// identity. in is overwritten.
+template <typename T>
+void fft(distributed_mdarray<std::complex<T>, 3> &in,
+         distributed_mdarray<std::complex<T>, 3> &out, bool forward = true) {
+  using value_type = std::complex<T>;
+  std::size_t n0 = in.extent(0), n1 = in.extent(1), n2 = in.extent(2);
+  assert(out.extent(0) == n1 && out.extent(1) == n0 && out.extent(2) == n2);
+  auto comm = default_comm();
+  std::size_t ranks = comm.size();
+  std::size_t rank = comm.rank();
+
+  // Slab decomposition: in is distributed by planes of dimension 0,
+  // and out by planes of dimension 1
+  std::size_t in_tile = dr::__detail::partition_up(n0, ranks);
+  std::size_t out_tile = dr::__detail::partition_up(n1, ranks);
+  std::size_t my_planes = __detail::tile_rows(n0, in_tile, rank);
+  std::size_t my_out_planes = __detail::tile_rows(n1, out_tile, rank);
+  std::size_t plane = n1 * n2, out_plane = n0 * n2;
+
+  std::size_t group = dr::__detail::partition_up(
+      in_tile, __detail::fft_pipeline_depth);
+  std::size_t groups = dr::__detail::partition_up(in_tile, group);
+  // Block of one group sent to one rank, padded to the same size
+  std::size_t block = group * out_tile * n2;
+  dr::drlog.debug("fft: {}x{}x{} planes: {} groups: {}\n", n0, n1, n2,
+                  my_planes, groups);
+
+  value_type *in_ptr = __detail::local_tile_pointer<value_type>(in);
+  value_type *out_tile_ptr = __detail::local_tile_pointer<value_type>(out);
+
+  // The kernels run on the host, so device tiles are staged
+  std::vector<value_type> in_host, out_host;
+  if (mhp::use_sycl()) {
+    in_host.resize(my_planes * plane);
+    out_host.resize(my_out_planes * out_plane);
+    __detail::sycl_copy(in_ptr, in_ptr + my_planes * plane, in_host.data());
+    in_ptr = in_host.data();
+  }
+  value_type *out_ptr = mhp::use_sycl() ? out_host.data() : out_tile_ptr;
+
+  __detail::fft_plan<T> plan0(n0, forward), plan1(n1, forward),
+      plan2(n2, forward);
+
+  std::vector<value_type> send(groups * ranks * block),
+      receive(groups * ranks * block);
+  std::vector<MPI_Request> requests(groups);
+  for (std::size_t g = 0; g < groups; g++) {
+    std::size_t first = std::min(g * group, my_planes);
+    std::size_t last = std::min(first + group, my_planes);
+    auto planes = in_ptr + first * plane;
+
+    // Transform dimensions 2 and 1 of the planes in the group
+    __detail::fft_lines(plan2, planes, (last - first) * n1, n2, 1);
+    for (std::size_t a = first; a < last; a++) {
+      __detail::fft_lines(plan1, in_ptr + a * plane, n2, 1, n2);
+    }
+
+    // Block for rank s holds rows [s * out_tile, ...) of every plane
+    auto group_send = send.data() + g * ranks * block;
+    for (std::size_t s = 0; s < ranks; s++) {
+      std::size_t rows = __detail::tile_rows(n1, out_tile, s);
+      for (std::size_t a = first; a < last; a++) {
+        auto src = in_ptr + a * plane + s * out_tile * n2;
+        std::copy(src, src + rows * n2,
+                  group_send + s * block + (a - first) * out_tile * n2);
+      }
+    }
+    comm.i_alltoall(group_send, receive.data() + g * ranks * block, block,
+                    &requests[g]);
+  }
+  MPI_Waitall(groups, requests.data(), MPI_STATUSES_IGNORE);
+
+  // Row b of plane a from rank s is row a of plane b in out
+  std::vector<std::size_t> out_planes(my_out_planes);
+  std::iota(out_planes.begin(), out_planes.end(), 0);
+  std::for_each(
+      std::execution::par_unseq, out_planes.begin(), out_planes.end(),
+      [=, r = receive.data()](std::size_t b) {
+        for (std::size_t g = 0; g < groups; g++) {
+          for (std::size_t s = 0; s < ranks; s++) {
+            std::size_t planes = __detail::tile_rows(n0, in_tile, s);
+            std::size_t first = std::min(g * group, planes);
+            std::size_t last = std::min(first + group, planes);
+            auto src = r + (g * ranks + s) * block + b * n2;
+            for (std::size_t a = first; a < last; a++) {
+              auto row = src + (a - first) * out_tile * n2;
+              std::copy(row, row + n2,
+                        out_ptr + b * out_plane + (s * in_tile + a) * n2);
+            }
+          }
+        }
+      });
+
+  // Transform dimension 1 of out, which is dimension 0 of in
+  for (std::size_t b = 0; b < my_out_planes; b++) {
+    __detail::fft_lines(plan0, out_ptr + b * out_plane, n2, 1, n2);
+  }
+
+  if (!forward) {
+    T scale = T(1) / T(n0 * n1 * n2);
+    std::for_each(std::execution::par_unseq, out_ptr,
+                  out_ptr + my_out_planes * out_plane,
+                  [scale](value_type &v) { v *= scale; });
+  }
+
+  if (mhp::use_sycl()) {
+    __detail::sycl_copy(out_host.data(),
+                        out_host.data() + my_out_planes * out_plane,
+                        out_tile_ptr);
+  }
+
+  barrier();
+}
+
+} // namespace dr::mhp
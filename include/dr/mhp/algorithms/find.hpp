@@ -0,0 +1,212 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <execution>
+#include <functional>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/onedpl_direct_iterator.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/algorithms/transform_reduce.hpp>
+#include <dr/mhp/global.hpp>
+
+namespace dr::mhp::__detail {
+
+// Elements searched between checks for a hit on another rank
+inline constexpr std::size_t find_chunk = 1 << 16;
+
+// Position of the first element of [first, first + n) that satisfies
+// pred, or n
+template <typename Iter, typename Pred>
+std::size_t find_local(Iter first, std::size_t n, Pred &pred) {
+  if (mhp::use_sycl()) {
+#ifdef SYCL_LANGUAGE_VERSION
+    auto begin = dr::__detail::direct_iterator(first);
+    return std::find_if(dpl_policy(), begin, begin + n, pred) - begin;
+#else
+    assert(false);
+    return n;
+#endif
+  } else {
+    return std::find_if(std::execution::par_unseq, first, first + n, pred) -
+           first;
+  }
+}
+
+/// Collective. Global position of the first element of r that
+/// satisfies pred, or the size of r.
+///
+/// Every rank searches its segments in order, a chunk at a time, and
+/// a non-blocking all reduce runs in the background with the first hit
+/// and the next unsearched position of every rank. A rank stops when
+/// the best hit it knows of is before its next position, and all ranks
+/// return when a reduction shows that no rank can find an earlier hit.
+template <typename Pred>
+std::size_t find_position(dr::distributed_range auto &&r, Pred pred) {
+  // Positions are reduced as signed values, some MPI libraries get the
+  // minimum of large unsigned values wrong
+  using position = std::int64_t;
+  constexpr position none = std::numeric_limits<position>::max();
+  auto comm = default_comm();
+
+  // Local segments, with the global position of their first element
+  using segment_type = rng::range_value_t<decltype(dr::ranges::segments(r))>;
+  using local_iterator = decltype(dr::ranges::local(
+      rng::begin(std::declval<segment_type &>())));
+  struct part {
+    std::size_t offset;
+    std::size_t size;
+    local_iterator first;
+  };
+  std::vector<part> parts;
+  std::size_t offset = 0;
+  for (auto &&segment : dr::ranges::segments(r)) {
+    std::size_t size = rng::distance(segment);
+    if (size > 0 && dr::ranges::rank(segment) == comm.rank()) {
+      parts.push_back({offset, size, dr::ranges::local(rng::begin(segment))});
+    }
+    offset += size;
+  }
+
+  position found = none, best = none;
+  std::size_t p = 0, i = 0;
+  auto next = [&]() {
+    return p < rng::size(parts) ? position(parts[p].offset + i) : none;
+  };
+  auto search_chunk = [&]() {
+    auto &part = parts[p];
+    std::size_t n = std::min(find_chunk, part.size - i);
+    std::size_t hit = find_local(part.first + i, n, pred);
+    if (hit < n) {
+      found = part.offset + i + hit;
+      p = rng::size(parts);
+    } else if ((i += n) == part.size) {
+      p++;
+      i = 0;
+    }
+  };
+
+  // {first hit, next unsearched position}
+  std::array<position, 2> mine, all;
+  MPI_Request request = MPI_REQUEST_NULL;
+  std::size_t rounds = 0;
+  while (true) {
+    if (request == MPI_REQUEST_NULL) {
+      mine = {found, next()};
+      comm.i_all_reduce(mine.data(), all.data(), 2, MPI_MIN, &request);
+      rounds++;
+    }
+    if (next() < std::min(found, best)) {
+      search_chunk();
+      int done;
+      MPI_Test(&request, &done, MPI_STATUS_IGNORE);
+      if (!done) {
+        continue;
+      }
+    } else {
+      MPI_Wait(&request, MPI_STATUS_IGNORE);
+    }
+
+    best = all[0];
+    if (all[1] >= best) {
+      dr::drlog.debug("find: position: {} rounds: {}\n", best, rounds);
+      return best == none ? offset : std::size_t(best);
+    }
+  }
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective. Returns an iterator to the first element of r that
+/// satisfies pred, or the end of r. Ranks stop searching soon after
+/// the first hit on any rank.
+template <dr::distributed_range DR, typename Pred>
+auto find_if(DR &&r, Pred pred) {
+  return rng::begin(r) + __detail::find_position(r, pred);
+}
+
+/// Collective. Returns an iterator to the first element of r that does
+/// not satisfy pred, or the end of r.
+template <dr::distributed_range DR, typename Pred>
+auto find_if_not(DR &&r, Pred pred) {
+  return mhp::find_if(r, [pred](auto &&x) { return !pred(x); });
+}
+
+/// Collective. Returns an iterator to the first element of r that is
+/// equal to value, or the end of r.
+template <dr::distributed_range DR, typename T>
+auto find(DR &&r, const T &value) {
+  return mhp::find_if(r, [value](auto &&x) { return x == value; });
+}
+
+/// Collective. True if an element of r satisfies pred
+template <dr::distributed_range DR, typename Pred>
+bool any_of(DR &&r, Pred pred) {
+  return __detail::find_position(r, pred) != std::size_t(rng::distance(r));
+}
+
+/// Collective. True if all elements of r satisfy pred
+template <dr::distributed_range DR, typename Pred>
+bool all_of(DR &&r, Pred pred) {
+  return !mhp::any_of(r, [pred](auto &&x) { return !pred(x); });
+}
+
+/// Collective. True if no element of r satisfies pred
+template <dr::distributed_range DR, typename Pred>
+bool none_of(DR &&r, Pred pred) {
+  return !mhp::any_of(r, pred);
+}
+
+/// Collective. Number of elements of r that satisfy pred. Every
+/// element is tested, so there is no early exit.
+template <dr::distributed_range DR, typename Pred>
+std::size_t count_if(DR &&r, Pred pred) {
+  return mhp::transform_reduce(
+      r, std::size_t(0), std::plus<>(),
+      [pred](auto &&x) { return pred(x) ? std::size_t(1) : std::size_t(0); });
+}
+
+/// Collective. Number of elements of r that are equal to value
+template <dr::distributed_range DR, typename T>
+std::size_t count(DR &&r, const T &value) {
+  return mhp::count_if(r, [value](auto &&x) { return x == value; });
+}
+
+/// Collective. Returns iterators to the first elements of r1 and r2
+/// that do not satisfy pred, or the ends. r1 and r2 must be aligned.
+template <dr::distributed_range DR1, dr::distributed_range DR2,
+          typename Pred = std::equal_to<>>
+auto mismatch(DR1 &&r1, DR2 &&r2, Pred pred = Pred()) {
+  assert(aligned(r1, r2));
+  auto differ = [pred](auto &&v) {
+    auto &&[x, y] = v;
+    return !pred(x, y);
+  };
+  std::size_t position = __detail::find_position(views::zip(r1, r2), differ);
+  return std::pair(rng::begin(r1) + position, rng::begin(r2) + position);
+}
+
+/// Collective. True if r1 and r2 have the same size and the pairs of
+/// elements satisfy pred
+template <dr::distributed_range DR1, dr::distributed_range DR2,
+          typename Pred = std::equal_to<>>
+bool equal(DR1 &&r1, DR2 &&r2, Pred pred = Pred()) {
+  if (rng::distance(r1) != rng::distance(r2)) {
+    return false;
+  }
+  return mhp::mismatch(r1, r2, pred).first == rng::end(r1);
+}
+
+} // namespace dr::mhp
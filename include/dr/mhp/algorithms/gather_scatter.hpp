@@ -0,0 +1,330 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/communicator.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/detail/sycl_utils.hpp>
+#include <dr/mhp/global.hpp>
+
+namespace dr::mhp::__detail {
+
+// Global index of the first element of each segment. The last entry
+// is the size of the range.
+inline auto segment_offsets(auto &&dr) {
+  std::vector<std::size_t> offsets{0};
+  for (auto &&segment : dr::ranges::segments(dr)) {
+    offsets.push_back(offsets.back() + rng::distance(segment));
+  }
+  return offsets;
+}
+
+// Rank that owns each segment
+inline auto segment_ranks(auto &&dr) {
+  std::vector<std::size_t> ranks;
+  for (auto &&segment : dr::ranges::segments(dr)) {
+    ranks.push_back(dr::ranges::rank(segment));
+  }
+  return ranks;
+}
+
+// Pointer to the local memory for each segment, or nullptr if the
+// segment is on another rank
+template <typename T> inline auto segment_pointers(auto &&dr) {
+  std::vector<T *> pointers;
+  for (auto &&segment : dr::ranges::segments(dr)) {
+    if (dr::ranges::rank(segment) == default_comm().rank()) {
+      pointers.push_back(
+          std::to_address(dr::ranges::local(rng::begin(segment))));
+    } else {
+      pointers.push_back(nullptr);
+    }
+  }
+  return pointers;
+}
+
+inline std::size_t owning_segment(const std::vector<std::size_t> &offsets,
+                                  std::size_t index) {
+  assert(index < offsets.back());
+  return std::upper_bound(offsets.begin(), offsets.end(), index) -
+         offsets.begin() - 1;
+}
+
+//
+// Routes a batch of global indices to the ranks that own them. Indices
+// are bucketed by owner and deduplicated, so an element is requested
+// at most once per batch. Owners receive the indices in ascending
+// order, which keeps their memory accesses local.
+//
+struct index_exchange {
+  // Deduplicated indices, grouped by owner
+  std::vector<std::size_t> requests;
+  // For each position in the batch, the location of its index in
+  // requests
+  std::vector<std::size_t> slots;
+  // Indices this rank serves, grouped by requester
+  std::vector<std::size_t> received;
+  std::vector<std::size_t> send_counts, send_displs;
+  std::vector<std::size_t> recv_counts, recv_displs;
+
+  index_exchange(communicator comm, const std::vector<std::size_t> &offsets,
+                 const std::vector<std::size_t> &ranks,
+                 rng::random_access_range auto &&indices) {
+    std::size_t n = rng::size(indices);
+    std::size_t nranks = comm.size();
+
+    struct entry {
+      std::size_t owner, index, position;
+    };
+    std::vector<entry> entries(n);
+    for (std::size_t i = 0; i < n; i++) {
+      std::size_t index = indices[i];
+      entries[i] = {ranks[owning_segment(offsets, index)], index, i};
+    }
+    std::sort(std::execution::par_unseq, entries.begin(), entries.end(),
+              [](const auto &a, const auto &b) {
+                return std::pair(a.owner, a.index) <
+                       std::pair(b.owner, b.index);
+              });
+
+    send_counts.resize(nranks, 0);
+    slots.resize(n);
+    for (std::size_t i = 0; i < n; i++) {
+      auto &e = entries[i];
+      if (i == 0 || e.owner != entries[i - 1].owner ||
+          e.index != entries[i - 1].index) {
+        requests.push_back(e.index);
+        send_counts[e.owner]++;
+      }
+      slots[e.position] = rng::size(requests) - 1;
+    }
+
+    recv_counts.resize(nranks);
+    comm.alltoall(send_counts, recv_counts, 1);
+    send_displs = displacements(send_counts);
+    recv_displs = displacements(recv_counts);
+    received.resize(recv_displs.back() + recv_counts.back());
+    comm.alltoallv(requests, send_counts, send_displs, received, recv_counts,
+                   recv_displs);
+  }
+
+  // Send data for the received indices back to the requesters
+  template <typename T>
+  void respond(communicator comm, const std::vector<T> &responses,
+               std::vector<T> &values) {
+    values.resize(rng::size(requests));
+    comm.alltoallv(responses, recv_counts, recv_displs, values, send_counts,
+                   send_displs);
+  }
+
+  // Send data for the requested indices to the owners
+  template <typename T>
+  void forward(communicator comm, const std::vector<T> &values,
+               std::vector<T> &forwarded) {
+    forwarded.resize(rng::size(received));
+    comm.alltoallv(values, send_counts, send_displs, forwarded, recv_counts,
+                   recv_displs);
+  }
+
+private:
+  static std::vector<std::size_t>
+  displacements(const std::vector<std::size_t> &counts) {
+    std::vector<std::size_t> displs(rng::size(counts));
+    std::exclusive_scan(counts.begin(), counts.end(), displs.begin(),
+                        std::size_t(0));
+    return displs;
+  }
+};
+
+// Resolve global indices to local addresses on the owner
+template <typename T>
+std::vector<T *> local_addresses(const std::vector<std::size_t> &offsets,
+                                 const std::vector<T *> &pointers,
+                                 const std::vector<std::size_t> &indices) {
+  std::vector<T *> addresses(rng::size(indices));
+  std::transform(std::execution::par_unseq, indices.begin(), indices.end(),
+                 addresses.begin(), [&](std::size_t index) {
+                   auto segment = owning_segment(offsets, index);
+                   assert(pointers[segment] != nullptr);
+                   return pointers[segment] + (index - offsets[segment]);
+                 });
+  return addresses;
+}
+
+template <typename T>
+void load_local(const std::vector<T *> &addresses, std::vector<T> &values) {
+  values.resize(rng::size(addresses));
+  if (rng::empty(addresses)) {
+    return;
+  }
+  if (mhp::use_sycl()) {
+#ifdef SYCL_LANGUAGE_VERSION
+    auto q = sycl_queue();
+    auto n = rng::size(addresses);
+    auto device_addresses = sycl::malloc_device<T *>(n, q);
+    auto device_values = sycl::malloc_device<T>(n, q);
+    q.copy(addresses.data(), device_addresses, n).wait();
+    dr::__detail::parallel_for(
+        q, sycl::range<1>(n),
+        [=](auto i) { device_values[i] = *device_addresses[i]; })
+        .wait();
+    q.copy(device_values, values.data(), n).wait();
+    sycl::free(device_addresses, q);
+    sycl::free(device_values, q);
+#else
+    assert(false);
+#endif
+  } else {
+    std::transform(std::execution::par_unseq, addresses.begin(),
+                   addresses.end(), values.begin(),
+                   [](T *address) { return *address; });
+  }
+}
+
+template <typename T>
+void store_local(const std::vector<T *> &addresses,
+                 const std::vector<T> &values) {
+  if (rng::empty(addresses)) {
+    return;
+  }
+  if (mhp::use_sycl()) {
+#ifdef SYCL_LANGUAGE_VERSION
+    auto q = sycl_queue();
+    auto n = rng::size(addresses);
+    auto device_addresses = sycl::malloc_device<T *>(n, q);
+    auto device_values = sycl::malloc_device<T>(n, q);
+    q.copy(addresses.data(), device_addresses, n).wait();
+    q.copy(values.data(), device_values, n).wait();
+    dr::__detail::parallel_for(
+        q, sycl::range<1>(n),
+        [=](auto i) { *device_addresses[i] = device_values[i]; })
+        .wait();
+    sycl::free(device_addresses, q);
+    sycl::free(device_values, q);
+#else
+    assert(false);
+#endif
+  } else {
+    // Requests are deduplicated, so addresses are unique
+    for (std::size_t i = 0; i < rng::size(addresses); i++) {
+      *addresses[i] = values[i];
+    }
+  }
+}
+
+// Indices are exchanged in batches to bound the size of the buffers
+// and the byte counts passed to MPI
+inline constexpr std::size_t exchange_batch_size = std::size_t(1) << 24;
+
+// Every rank takes part in every batch, even if it has no indices
+inline std::size_t exchange_batches(std::size_t n) {
+  std::size_t batches = (n + exchange_batch_size - 1) / exchange_batch_size;
+  return default_comm().all_reduce(batches, MPI_MAX);
+}
+
+// Position of the first of n elements in a batch. Ranks with fewer
+// elements than others have empty batches at the end, which start at n.
+inline std::size_t exchange_batch_first(std::size_t n, std::size_t batch) {
+  return std::min(batch * exchange_batch_size, n);
+}
+
+inline auto exchange_batch(rng::random_access_range auto &&indices,
+                           std::size_t batch) {
+  std::size_t first = exchange_batch_first(rng::size(indices), batch);
+  std::size_t last = std::min(first + exchange_batch_size,
+                              std::size_t(rng::size(indices)));
+  return rng::subrange(rng::begin(indices) + first,
+                       rng::begin(indices) + last);
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective gather by global index. Each rank passes its own
+/// indices, and receives the values of dr at those indices in out, in
+/// the same order.
+template <dr::distributed_contiguous_range DR,
+          rng::random_access_range Indices, std::random_access_iterator O>
+O gather(DR &&dr, Indices &&indices, O out) {
+  using value_type = rng::range_value_t<DR>;
+  auto comm = default_comm();
+
+  auto offsets = __detail::segment_offsets(dr);
+  auto ranks = __detail::segment_ranks(dr);
+  auto pointers = __detail::segment_pointers<value_type>(dr);
+
+  auto batches = __detail::exchange_batches(rng::size(indices));
+  dr::drlog.debug("gather: {} indices in {} batches\n", rng::size(indices),
+                  batches);
+  std::vector<value_type> responses, values;
+  for (std::size_t b = 0; b < batches; b++) {
+    auto batch = __detail::exchange_batch(indices, b);
+    __detail::index_exchange exchange(comm, offsets, ranks, batch);
+
+    __detail::load_local(
+        __detail::local_addresses(offsets, pointers, exchange.received),
+        responses);
+    exchange.respond(comm, responses, values);
+
+    auto batch_out =
+        out + __detail::exchange_batch_first(rng::size(indices), b);
+    for (std::size_t i = 0; i < rng::size(batch); i++) {
+      batch_out[i] = values[exchange.slots[i]];
+    }
+  }
+
+  return out + rng::size(indices);
+}
+
+/// Collective scatter by global index. Each rank passes its own values
+/// and indices. If an index appears more than once on a rank, the last
+/// value is written. If ranks write the same index, one of the values
+/// is written.
+template <rng::random_access_range Values, rng::random_access_range Indices,
+          dr::distributed_contiguous_range DR>
+void scatter(Values &&values, Indices &&indices, DR &&dr) {
+  using value_type = rng::range_value_t<DR>;
+  assert(rng::size(values) == rng::size(indices));
+  auto comm = default_comm();
+
+  auto offsets = __detail::segment_offsets(dr);
+  auto ranks = __detail::segment_ranks(dr);
+  auto pointers = __detail::segment_pointers<value_type>(dr);
+
+  auto batches = __detail::exchange_batches(rng::size(indices));
+  dr::drlog.debug("scatter: {} indices in {} batches\n", rng::size(indices),
+                  batches);
+  std::vector<value_type> requested, forwarded;
+  for (std::size_t b = 0; b < batches; b++) {
+    auto batch = __detail::exchange_batch(indices, b);
+    __detail::index_exchange exchange(comm, offsets, ranks, batch);
+
+    // Later positions overwrite earlier ones for duplicate indices
+    requested.resize(rng::size(exchange.requests));
+    auto batch_values = rng::begin(values) +
+                        __detail::exchange_batch_first(rng::size(values), b);
+    for (std::size_t i = 0; i < rng::size(batch); i++) {
+      requested[exchange.slots[i]] = batch_values[i];
+    }
+    exchange.forward(comm, requested, forwarded);
+
+    __detail::store_local(
+        __detail::local_addresses(offsets, pointers, exchange.received),
+        forwarded);
+  }
+
+  barrier();
+}
+
+} // namespace dr::mhp
@@ -0,0 +1,173 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+#include <dr/detail/communicator.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/utils.hpp>
+#include <dr/mhp/containers/distributed_dense_matrix.hpp>
+
+namespace dr::mhp::__detail {
+
+// Upper bound on the width of a panel, smaller panels give more
+// overlap of communication and computation
+inline constexpr std::size_t gemm_panel = 128;
+// Rows and columns of c updated by one task. A block of b of
+// gemm_panel x gemm_block_columns stays in cache while the rows of the
+// block are updated.
+inline constexpr std::size_t gemm_block_rows = 32;
+inline constexpr std::size_t gemm_block_columns = 256;
+
+// c += a * b, where a is m x k, b is k x n, c is m x n, all row major
+// and contiguous
+template <typename T>
+void local_gemm(const T *a, const T *b, T *c, std::size_t m, std::size_t n,
+                std::size_t k) {
+  std::size_t row_blocks = dr::__detail::partition_up(m, gemm_block_rows);
+  std::size_t column_blocks =
+      dr::__detail::partition_up(n, gemm_block_columns);
+  std::vector<std::size_t> blocks(row_blocks * column_blocks);
+  std::iota(blocks.begin(), blocks.end(), 0);
+
+  auto block_product = [=](std::size_t block) {
+    std::size_t i0 = (block / column_blocks) * gemm_block_rows;
+    std::size_t j0 = (block % column_blocks) * gemm_block_columns;
+    std::size_t i1 = std::min(i0 + gemm_block_rows, m);
+    std::size_t j1 = std::min(j0 + gemm_block_columns, n);
+    for (std::size_t i = i0; i < i1; i++) {
+      T *ci = c + i * n;
+      for (std::size_t l = 0; l < k; l++) {
+        // Unit stride over j, so the loop vectorizes
+        T ail = a[i * k + l];
+        const T *bl = b + l * n;
+        for (std::size_t j = j0; j < j1; j++) {
+          ci[j] += ail * bl[j];
+        }
+      }
+    }
+  };
+  std::for_each(std::execution::par_unseq, blocks.begin(), blocks.end(),
+                block_product);
+}
+
+// A k panel of the product: columns [first, first + width) of a and
+// the same rows of b
+struct gemm_panel_info {
+  std::size_t first;
+  std::size_t width;
+};
+
+// Split k into panels that do not cross a tile boundary of a or b, so
+// each panel of a is on one grid column and each panel of b is on one
+// grid row
+inline std::vector<gemm_panel_info>
+gemm_panels(std::size_t k, std::size_t a_tile, std::size_t b_tile) {
+  std::vector<gemm_panel_info> panels;
+  for (std::size_t first = 0; first < k;) {
+    std::size_t end = std::min({k, (first / a_tile + 1) * a_tile,
+                                (first / b_tile + 1) * b_tile,
+                                first + gemm_panel});
+    panels.push_back({first, end - first});
+    first = end;
+  }
+  return panels;
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective c = a * b with SUMMA. The matrices must use the same
+/// process grid, the tile rows of a must match c, and the tile columns
+/// of b must match c.
+///
+/// For each panel of k, the grid column that stores the panel of a
+/// broadcasts it along the grid rows, and the grid row that stores the
+/// panel of b broadcasts it along the grid columns. Every process then
+/// multiplies the panels into its tiles of c. The broadcasts of the
+/// next panel are started before the current panel is multiplied, into
+/// a second set of buffers.
+template <typename T>
+void gemm(distributed_dense_matrix<T> &a, distributed_dense_matrix<T> &b,
+          distributed_dense_matrix<T> &c) {
+  std::size_t m = a.shape()[0], n = b.shape()[1], k = a.shape()[1];
+  assert(b.shape()[0] == k);
+  assert(c.shape()[0] == m && c.shape()[1] == n);
+  assert(a.grid_shape() == c.grid_shape());
+  assert(b.grid_shape() == c.grid_shape());
+  assert(a.tile_shape()[0] == c.tile_shape()[0]);
+  assert(b.tile_shape()[1] == c.tile_shape()[1]);
+
+  auto &grid = c.grid();
+  auto row_comm = grid.row_comm(), column_comm = grid.column_comm();
+  std::size_t local_m = c.local_shape()[0], local_n = c.local_shape()[1];
+  assert(a.local_shape()[0] == local_m && b.local_shape()[1] == local_n);
+  std::size_t a_tile = a.tile_shape()[1], b_tile = b.tile_shape()[0];
+  std::size_t a_ld = a.local_shape()[1];
+
+  auto panels = __detail::gemm_panels(k, a_tile, b_tile);
+  dr::drlog.debug("gemm: {}x{}x{} local: {}x{} panels: {}\n", m, n, k,
+                  local_m, local_n, rng::size(panels));
+
+  // Double buffered panels
+  std::vector<T> a_panel[2], b_panel[2];
+  for (std::size_t i = 0; i < 2; i++) {
+    a_panel[i].resize(local_m * std::min(k, __detail::gemm_panel));
+    b_panel[i].resize(std::min(k, __detail::gemm_panel) * local_n);
+  }
+  MPI_Request requests[2][2];
+
+  auto start_panel = [&](std::size_t p) {
+    auto [first, width] = panels[p];
+    auto &ap = a_panel[p % 2], &bp = b_panel[p % 2];
+
+    // Owner of the panel of a in my grid row, and the local column
+    // where the panel starts
+    std::size_t a_owner = (first / a_tile) % grid.columns();
+    if (a_owner == grid.column()) {
+      std::size_t column =
+          (first / a_tile) / grid.columns() * a_tile + first % a_tile;
+      const T *src = a.local_data() + column;
+      for (std::size_t i = 0; i < local_m; i++) {
+        std::copy(src + i * a_ld, src + i * a_ld + width,
+                  ap.data() + i * width);
+      }
+    }
+    row_comm.i_bcast(ap.data(), sizeof(T) * local_m * width, a_owner,
+                     &requests[p % 2][0]);
+
+    // Rows of b are contiguous
+    std::size_t b_owner = (first / b_tile) % grid.rows();
+    if (b_owner == grid.row()) {
+      std::size_t row =
+          (first / b_tile) / grid.rows() * b_tile + first % b_tile;
+      const T *src = b.local_data() + row * local_n;
+      std::copy(src, src + width * local_n, bp.data());
+    }
+    column_comm.i_bcast(bp.data(), sizeof(T) * width * local_n, b_owner,
+                        &requests[p % 2][1]);
+  };
+
+  T *c_data = c.local_data();
+  std::fill(c_data, c_data + local_m * local_n, T(0));
+  if (!rng::empty(panels)) {
+    start_panel(0);
+  }
+  for (std::size_t p = 0; p < rng::size(panels); p++) {
+    if (p + 1 < rng::size(panels)) {
+      start_panel(p + 1);
+    }
+    MPI_Waitall(2, requests[p % 2], MPI_STATUSES_IGNORE);
+    __detail::local_gemm(a_panel[p % 2].data(), b_panel[p % 2].data(), c_data,
+                         local_m, local_n, panels[p].width);
+  }
+}
+
+} // namespace dr::mhp
@@ -0,0 +1,38 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <memory>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/containers/sparse_matrix.hpp>
+#include <dr/mhp/global.hpp>
+#include <dr/mhp/views/views.hpp>
+
+namespace dr::mhp {
+
+/// Collective sparse matrix-vector product y = A * x. x and y must use
+/// the default distribution, with sizes matching the columns and rows
+/// of A.
+template <dr::distributed_contiguous_range Y, typename T, typename I,
+          dr::distributed_contiguous_range X>
+void gemv(Y &&y, sparse_matrix<T, I> &a, X &&x) {
+  assert(rng::size(y) == a.shape()[0]);
+  assert(rng::size(x) == a.shape()[1]);
+
+  auto &&y_local = local_segment(y);
+  auto &&x_local = local_segment(x);
+  auto [first, last] = a.local_rows();
+  assert(std::size_t(rng::distance(y_local)) == last - first);
+  dr::drlog.debug("gemv: rows: {}-{}\n", first, last);
+
+  a.multiply(std::to_address(rng::begin(y_local)),
+             std::to_address(rng::begin(x_local)));
+  barrier();
+}
+
+} // namespace dr::mhp
@@ -0,0 +1,44 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <cstdint>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/random.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/global.hpp>
+
+namespace dr::mhp {
+
+/// Collective. Fills r with random values from dist. The value of
+/// element i depends only on seed and i, and not on the number of
+/// ranks or threads. Every element is computed independently with a
+/// Philox counter based generator, so the fill runs in parallel and
+/// vectorizes. dist is a std uniform_int_distribution,
+/// uniform_real_distribution, normal_distribution or
+/// bernoulli_distribution. The values are not the values that the std
+/// distribution would produce.
+template <dr::distributed_range R, typename D>
+void generate_random(R &&r, const D &dist, std::uint64_t seed) {
+  dr::__detail::counter_distribution<D> counter_dist(dist);
+  auto key = dr::__detail::random_key(seed);
+  auto indices =
+      rng::views::iota(std::uint64_t(0), std::uint64_t(rng::distance(r)));
+
+  for_each(views::zip(indices, r), [counter_dist, key](auto &&elem) {
+    auto &&[i, v] = elem;
+    v = dr::__detail::random_value(counter_dist, key, i);
+  });
+}
+
+/// Collective generate_random on iterator/sentinel for a distributed
+/// range
+template <dr::distributed_iterator Iter, typename D>
+void generate_random(Iter begin, Iter end, const D &dist, std::uint64_t seed) {
+  generate_random(rng::subrange(begin, end), dist, seed);
+}
+
+} // namespace dr::mhp
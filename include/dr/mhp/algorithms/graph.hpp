@@ -0,0 +1,491 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <execution>
+#include <limits>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/communicator.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/containers/sparse_matrix.hpp>
+#include <dr/mhp/global.hpp>
+#include <dr/mhp/sycl_support.hpp>
+#include <dr/mhp/views/views.hpp>
+
+namespace dr::mhp::__detail {
+
+// Adjacency of the vertices on this rank, taken from the rows of a
+// square sparse_matrix. Neighbors are numbered with the local vertices
+// first, followed by the ghosts: vertices on other ranks, sorted by
+// global index. Ghosts are grouped by owner, so every exchange is one
+// alltoallv.
+class graph_partition {
+public:
+  template <typename T, typename I>
+  graph_partition(const sparse_matrix<T, I> &a) {
+    auto comm = default_comm();
+    auto ranks = comm.size();
+    n_ = a.shape()[0];
+    assert(a.shape()[1] == n_);
+    std::tie(first_, last_) = a.local_rows();
+    block_ = block_size(n_, ranks);
+    std::size_t nlocal = last_ - first_;
+
+    std::vector<std::size_t> neighbors;
+    rowptr_.assign(nlocal + 1, 0);
+    a.for_each_local([&](std::size_t i, std::size_t j, auto) {
+      rowptr_[i - first_ + 1]++;
+      neighbors.push_back(j);
+      if (!owned(j)) {
+        ghosts_.push_back(j);
+      }
+    });
+    std::inclusive_scan(rowptr_.begin(), rowptr_.end(), rowptr_.begin());
+    std::sort(ghosts_.begin(), ghosts_.end());
+    ghosts_.erase(std::unique(ghosts_.begin(), ghosts_.end()), ghosts_.end());
+    colind_.resize(rng::size(neighbors));
+    std::transform(std::execution::par_unseq, neighbors.begin(),
+                   neighbors.end(), colind_.begin(),
+                   [this](std::size_t j) { return local_index(j); });
+
+    // Tell the owners which of their vertices are ghosts here
+    ghost_counts_.assign(ranks, 0);
+    for (auto j : ghosts_) {
+      ghost_counts_[owner(j)]++;
+    }
+    shared_counts_.resize(ranks);
+    comm.alltoall(ghost_counts_, shared_counts_, 1);
+    ghost_displs_ = displacements(ghost_counts_);
+    shared_displs_ = displacements(shared_counts_);
+    shared_.resize(shared_displs_.back() + shared_counts_.back());
+    comm.alltoallv(ghosts_, ghost_counts_, ghost_displs_, shared_,
+                   shared_counts_, shared_displs_);
+    for (auto &j : shared_) {
+      j -= first_;
+    }
+    dr::drlog.debug("graph: vertices: {}-{} edges: {} ghosts: {} shared: {}\n",
+                    first_, last_, rng::size(colind_), rng::size(ghosts_),
+                    rng::size(shared_));
+  }
+
+  std::size_t vertices() const { return n_; }
+  std::size_t first() const { return first_; }
+  std::size_t local_vertices() const { return last_ - first_; }
+  std::size_t local_edges() const { return rng::size(colind_); }
+  std::size_t ghost_vertices() const { return rng::size(ghosts_); }
+  bool owned(std::size_t j) const { return j >= first_ && j < last_; }
+  std::size_t owner(std::size_t j) const { return j / block_; }
+  std::size_t degree(std::size_t v) const {
+    return rowptr_[v + 1] - rowptr_[v];
+  }
+  // Neighbors of local vertex v
+  const std::size_t *begin(std::size_t v) const {
+    return colind_.data() + rowptr_[v];
+  }
+  const std::size_t *end(std::size_t v) const {
+    return colind_.data() + rowptr_[v + 1];
+  }
+
+  // Local vertex or ghost number of global vertex j
+  std::size_t local_index(std::size_t j) const {
+    if (owned(j)) {
+      return j - first_;
+    }
+    auto ghost = std::lower_bound(ghosts_.begin(), ghosts_.end(), j);
+    assert(ghost != ghosts_.end() && *ghost == j);
+    return local_vertices() + (ghost - ghosts_.begin());
+  }
+
+  // Collective owner[v] = op(owner[v], ghost) for every ghost copy of
+  // every vertex
+  template <typename V>
+  void push(const V *ghost_values, V *values, const auto &op) const {
+    std::vector<V> send(ghost_values, ghost_values + ghost_vertices());
+    std::vector<V> receive(rng::size(shared_));
+    default_comm().alltoallv(send, ghost_counts_, ghost_displs_, receive,
+                             shared_counts_, shared_displs_);
+    for (std::size_t k = 0; k < rng::size(shared_); k++) {
+      values[shared_[k]] = op(values[shared_[k]], receive[k]);
+    }
+  }
+
+  // Collective ghost = owner value for the vertices where changed is
+  // set. Only the changed values are sent.
+  template <typename V>
+  void pull_changed(const V *values, const char *changed,
+                    V *ghost_values) const {
+    auto ranks = default_comm().size(); // dr-style ignore
+    // (offset in the block of ghosts from this rank, value)
+    std::vector<std::pair<std::size_t, V>> send;
+    std::vector<std::size_t> send_counts(ranks, 0);
+    for (std::size_t r = 0; r < ranks; r++) {
+      for (std::size_t k = 0; k < shared_counts_[r]; k++) {
+        auto v = shared_[shared_displs_[r] + k];
+        if (changed[v]) {
+          send.emplace_back(k, values[v]);
+          send_counts[r]++;
+        }
+      }
+    }
+
+    std::vector<std::pair<std::size_t, V>> receive;
+    std::vector<std::size_t> receive_counts(ranks);
+    auto receive_displs = sparse_exchange(send, send_counts, receive,
+                                          receive_counts);
+    for (std::size_t r = 0; r < ranks; r++) {
+      for (std::size_t k = 0; k < receive_counts[r]; k++) {
+        auto [offset, value] = receive[receive_displs[r] + k];
+        ghost_values[ghost_displs_[r] + offset] = value;
+      }
+    }
+  }
+
+  // Collective exchange of one flag per vertex, sent as a bitmap.
+  // Returns the flags of the ghosts.
+  std::vector<char> pull_bitmap(const std::vector<char> &flags) const {
+    auto ranks = default_comm().size(); // dr-style ignore
+    auto words = [](std::size_t bits) { return (bits + 63) / 64; };
+    std::vector<std::size_t> send_counts(ranks), receive_counts(ranks);
+    for (std::size_t r = 0; r < ranks; r++) {
+      send_counts[r] = words(shared_counts_[r]);
+      receive_counts[r] = words(ghost_counts_[r]);
+    }
+    auto send_displs = displacements(send_counts);
+    auto receive_displs = displacements(receive_counts);
+
+    std::vector<std::uint64_t> send(send_displs.back() + send_counts.back(),
+                                    0);
+    std::vector<std::uint64_t> receive(receive_displs.back() +
+                                       receive_counts.back());
+    for (std::size_t r = 0; r < ranks; r++) {
+      auto bits = send.data() + send_displs[r];
+      for (std::size_t k = 0; k < shared_counts_[r]; k++) {
+        if (flags[shared_[shared_displs_[r] + k]]) {
+          bits[k / 64] |= std::uint64_t(1) << (k % 64);
+        }
+      }
+    }
+    default_comm().alltoallv(send, send_counts, send_displs, receive,
+                             receive_counts, receive_displs);
+
+    std::vector<char> ghost_flags(ghost_vertices());
+    for (std::size_t r = 0; r < ranks; r++) {
+      auto bits = receive.data() + receive_displs[r];
+      for (std::size_t k = 0; k < ghost_counts_[r]; k++) {
+        ghost_flags[ghost_displs_[r] + k] = (bits[k / 64] >> (k % 64)) & 1;
+      }
+    }
+    return ghost_flags;
+  }
+
+  // Collective. ghosts is a sorted list of ghost numbers. Returns the
+  // local vertices that other ranks listed.
+  std::vector<std::size_t>
+  push_list(const std::vector<std::size_t> &ghosts) const {
+    auto ranks = default_comm().size(); // dr-style ignore
+    std::vector<std::size_t> send, send_counts(ranks, 0);
+    for (auto g : ghosts) {
+      auto j = ghosts_[g];
+      send.push_back(j - owner(j) * block_);
+      send_counts[owner(j)]++;
+    }
+    std::vector<std::size_t> receive, receive_counts(ranks);
+    sparse_exchange(send, send_counts, receive, receive_counts);
+    return receive;
+  }
+
+private:
+  static std::vector<std::size_t>
+  displacements(const std::vector<std::size_t> &counts) {
+    std::vector<std::size_t> displs(rng::size(counts));
+    std::exclusive_scan(counts.begin(), counts.end(), displs.begin(),
+                        std::size_t(0));
+    return displs;
+  }
+
+  // alltoallv where the receiver does not know the counts. Returns the
+  // receive displacements.
+  template <typename V>
+  static std::vector<std::size_t>
+  sparse_exchange(const std::vector<V> &send,
+                  std::vector<std::size_t> &send_counts,
+                  std::vector<V> &receive,
+                  std::vector<std::size_t> &receive_counts) {
+    auto comm = default_comm();
+    comm.alltoall(send_counts, receive_counts, 1);
+    auto send_displs = displacements(send_counts);
+    auto receive_displs = displacements(receive_counts);
+    receive.resize(receive_displs.back() + receive_counts.back());
+    comm.alltoallv(send, send_counts, send_displs, receive, receive_counts,
+                   receive_displs);
+    return receive_displs;
+  }
+
+  std::size_t n_, first_, last_, block_;
+  std::vector<std::size_t> rowptr_, colind_;
+  // Global indices of off-rank neighbors
+  std::vector<std::size_t> ghosts_;
+  // Ghosts owned by each rank
+  std::vector<std::size_t> ghost_counts_, ghost_displs_;
+  // Local vertices that are ghosts on other ranks, grouped by rank in
+  // the order of their ghosts
+  std::vector<std::size_t> shared_, shared_counts_, shared_displs_;
+};
+
+// Direction switching thresholds from Beamer et al., "Direction-
+// optimizing breadth-first search"
+inline constexpr std::size_t bfs_alpha = 14;
+inline constexpr std::size_t bfs_beta = 24;
+
+// Copy host values to the local segment of a distributed range
+template <typename V>
+void copy_to_local(const std::vector<V> &values, auto &&r) {
+  auto &&segment = local_segment(r);
+  assert(std::size_t(rng::distance(segment)) == rng::size(values));
+  auto out = std::to_address(rng::begin(segment));
+  if (mhp::use_sycl()) {
+    __detail::sycl_copy(values.data(), values.data() + rng::size(values), out);
+  } else {
+    std::copy(values.begin(), values.end(), out);
+  }
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Value of unreached vertices in the result of bfs
+inline constexpr std::size_t bfs_unreached =
+    std::numeric_limits<std::size_t>::max();
+
+/// Collective direction-optimizing breadth-first search. a is the
+/// adjacency matrix of an undirected graph, so it must be symmetric.
+/// levels[v] is set to the distance of vertex v from source, or
+/// bfs_unreached.
+///
+/// Small frontiers are expanded top-down: only the newly discovered
+/// ghost vertices are sent to their owners. Large frontiers are
+/// expanded bottom-up: the frontier is exchanged as a bitmap and every
+/// unvisited vertex looks for a parent in it.
+template <typename T, typename I, dr::distributed_contiguous_range L>
+void bfs(sparse_matrix<T, I> &a, std::size_t source, L &&levels) {
+  assert(rng::size(levels) == a.shape()[0]);
+  assert(source < a.shape()[0]);
+  __detail::graph_partition g(a);
+  auto comm = default_comm();
+  std::size_t nlocal = g.local_vertices();
+
+  std::vector<std::size_t> level(nlocal, bfs_unreached);
+  // Ghosts already sent to their owner
+  std::vector<char> ghost_sent(g.ghost_vertices(), 0);
+  std::vector<std::size_t> frontier;
+  if (g.owned(source)) {
+    level[source - g.first()] = 0;
+    frontier.push_back(source - g.first());
+  }
+  // Edges of unvisited vertices
+  std::size_t unexplored = g.local_edges();
+
+  auto top_down = [&](std::size_t depth) {
+    std::vector<std::size_t> next, discovered;
+    auto visit = [&](std::size_t v) {
+      if (level[v] == bfs_unreached) {
+        level[v] = depth + 1;
+        next.push_back(v);
+      }
+    };
+    for (auto v : frontier) {
+      for (auto u = g.begin(v); u != g.end(v); u++) {
+        if (*u < nlocal) {
+          visit(*u);
+        } else if (!ghost_sent[*u - nlocal]) {
+          ghost_sent[*u - nlocal] = 1;
+          discovered.push_back(*u - nlocal);
+        }
+      }
+    }
+    std::sort(discovered.begin(), discovered.end());
+    for (auto v : g.push_list(discovered)) {
+      visit(v);
+    }
+    return next;
+  };
+
+  auto bottom_up = [&](std::size_t depth) {
+    std::vector<char> in_frontier(nlocal, 0);
+    for (auto v : frontier) {
+      in_frontier[v] = 1;
+    }
+    auto ghost_in_frontier = g.pull_bitmap(in_frontier);
+    std::vector<std::size_t> vertices(nlocal);
+    std::iota(vertices.begin(), vertices.end(), 0);
+    std::for_each(std::execution::par_unseq, vertices.begin(), vertices.end(),
+                  [&](std::size_t v) {
+                    if (level[v] != bfs_unreached) {
+                      return;
+                    }
+                    for (auto u = g.begin(v); u != g.end(v); u++) {
+                      if (*u < nlocal ? in_frontier[*u]
+                                      : ghost_in_frontier[*u - nlocal]) {
+                        level[v] = depth + 1;
+                        return;
+                      }
+                    }
+                  });
+    std::vector<std::size_t> next;
+    std::copy_if(vertices.begin(), vertices.end(), std::back_inserter(next),
+                 [&](std::size_t v) { return level[v] == depth + 1; });
+    return next;
+  };
+
+  bool is_bottom_up = false;
+  for (std::size_t depth = 0;; depth++) {
+    // Frontier vertices, frontier edges, unexplored edges
+    std::size_t counts[3] = {rng::size(frontier), 0, 0};
+    for (auto v : frontier) {
+      counts[1] += g.degree(v);
+    }
+    unexplored -= counts[1];
+    counts[2] = unexplored;
+    comm.all_reduce(counts, 3, MPI_SUM);
+    if (counts[0] == 0) {
+      break;
+    }
+
+    if (!is_bottom_up && counts[1] > counts[2] / __detail::bfs_alpha) {
+      is_bottom_up = true;
+    } else if (is_bottom_up &&
+               counts[0] < g.vertices() / __detail::bfs_beta) {
+      is_bottom_up = false;
+    }
+    dr::drlog.debug("bfs: depth: {} frontier: {} bottom up: {}\n", depth,
+                    counts[0], is_bottom_up);
+    frontier = is_bottom_up ? bottom_up(depth) : top_down(depth);
+  }
+
+  __detail::copy_to_local(level, levels);
+  barrier();
+}
+
+/// Collective PageRank. a(i, j) is the weight of the edge from vertex
+/// j to vertex i, so each iteration is y = A * x with the sparse
+/// matrix-vector product of gemv. Rank flows out of a vertex in
+/// proportion to the edge weights, and the rank of vertices without
+/// out edges is spread evenly over all vertices. Returns the number of
+/// iterations.
+template <typename T, typename I, dr::distributed_contiguous_range R>
+std::size_t pagerank(sparse_matrix<T, I> &a, R &&pr, T damping = 0.85,
+                     T tolerance = 1e-6, std::size_t max_iterations = 100) {
+  assert(rng::size(pr) == a.shape()[0]);
+  __detail::graph_partition g(a);
+  auto comm = default_comm();
+  std::size_t nlocal = g.local_vertices();
+  T n(g.vertices());
+
+  // Out weight of every vertex is the column sum of a
+  std::vector<T> out_weight(nlocal, 0), ghost_weight(g.ghost_vertices(), 0);
+  a.for_each_local([&](std::size_t, std::size_t j, T v) {
+    auto u = g.local_index(j);
+    (u < nlocal ? out_weight[u] : ghost_weight[u - nlocal]) += v;
+  });
+  g.push(ghost_weight.data(), out_weight.data(), std::plus<T>());
+
+  std::vector<T> rank(nlocal, T(1) / n), x(nlocal), y(nlocal);
+  std::size_t iteration = 0;
+  while (iteration < max_iterations) {
+    iteration++;
+    T dangling = 0;
+    for (std::size_t v = 0; v < nlocal; v++) {
+      if (out_weight[v] == 0) {
+        dangling += rank[v];
+        x[v] = 0;
+      } else {
+        x[v] = rank[v] / out_weight[v];
+      }
+    }
+    dangling = comm.all_reduce(dangling, MPI_SUM);
+
+    a.multiply(y.data(), x.data());
+
+    T base = (1 - damping) / n + damping * dangling / n, change = 0;
+    for (std::size_t v = 0; v < nlocal; v++) {
+      T next = base + damping * y[v];
+      change += std::abs(next - rank[v]);
+      rank[v] = next;
+    }
+    change = comm.all_reduce(change, MPI_SUM);
+    dr::drlog.debug("pagerank: iteration: {} change: {}\n", iteration,
+                    change);
+    if (change < tolerance) {
+      break;
+    }
+  }
+
+  __detail::copy_to_local(rank, pr);
+  barrier();
+  return iteration;
+}
+
+/// Collective connected components by label propagation. a is the
+/// adjacency matrix of an undirected graph, so it must be symmetric.
+/// components[v] is set to the smallest vertex in the component of v.
+/// Every round, only the labels that changed are sent. Returns the
+/// number of components.
+template <typename T, typename I, dr::distributed_contiguous_range C>
+std::size_t connected_components(sparse_matrix<T, I> &a, C &&components) {
+  assert(rng::size(components) == a.shape()[0]);
+  __detail::graph_partition g(a);
+  auto comm = default_comm();
+  std::size_t nlocal = g.local_vertices();
+
+  // Labels of the local vertices followed by the ghosts
+  std::vector<std::size_t> label(nlocal + g.ghost_vertices());
+  std::vector<std::size_t> next(nlocal);
+  std::vector<char> changed(nlocal, 1);
+  std::iota(label.begin(), label.begin() + nlocal, g.first());
+  std::vector<std::size_t> vertices(nlocal);
+  std::iota(vertices.begin(), vertices.end(), 0);
+
+  for (std::size_t round = 0;; round++) {
+    g.pull_changed(label.data(), changed.data(), label.data() + nlocal);
+    std::for_each(std::execution::par_unseq, vertices.begin(), vertices.end(),
+                  [&](std::size_t v) {
+                    auto l = label[v];
+                    for (auto u = g.begin(v); u != g.end(v); u++) {
+                      l = std::min(l, label[*u]);
+                    }
+                    next[v] = l;
+                    changed[v] = l != label[v];
+                  });
+    std::copy(next.begin(), next.end(), label.begin());
+
+    std::size_t count = std::count(changed.begin(), changed.end(), 1);
+    count = comm.all_reduce(count, MPI_SUM);
+    dr::drlog.debug("connected components: round: {} changed: {}\n", round,
+                    count);
+    if (count == 0) {
+      break;
+    }
+  }
+
+  std::size_t roots = 0;
+  for (std::size_t v = 0; v < nlocal; v++) {
+    roots += label[v] == g.first() + v;
+  }
+  label.resize(nlocal);
+  __detail::copy_to_local(label, components);
+  barrier();
+  return comm.all_reduce(roots, MPI_SUM);
+}
+
+} // namespace dr::mhp
@@ -6,6 +6,7 @@
 
 #include <algorithm>
 #include <execution>
+#include <numeric>
 #include <type_traits>
 #include <utility>
 
@@ -14,6 +15,7 @@
 #include <dr/detail/onedpl_direct_iterator.hpp>
 #include <dr/detail/ranges_shim.hpp>
 #include <dr/detail/tuple_utils.hpp>
+#include <dr/detail/utils.hpp>
 #include <dr/mhp/global.hpp>
 
 namespace dr::mhp::__detail {
@@ -34,13 +36,116 @@ concept two_arguments = requires(F &f) {
   { f(Arg1{}, Arg2{}) };
 };
 
+// Elements in a tile of the host engine. The rows of a tile, and the
+// rows next to it that a stencil reads, stay in L2.
+inline constexpr std::size_t md_tile_elements = 1 << 14;
+// Longest run of the last dimension in a tile, so a tile of a wide
+// array still has several rows
+inline constexpr std::size_t md_tile_columns = 1 << 11;
+
+// Host engine for the local part of md_for_each and stencil_for_each.
+// Calls row_op(index, n) for runs of n elements of the last dimension
+// of extents, where index is the first element of the run. The
+// elements of a run are contiguous in row major tiles, so row_op can
+// use a unit stride loop that vectorizes, without any per element
+// index arithmetic. The runs are grouped in tiles of consecutive rows
+// and a block of columns, and the tiles run in parallel.
+template <typename Extents, typename RowOp>
+void md_for_each_rows(const Extents &extents, RowOp row_op) {
+  constexpr std::size_t Rank = Extents::rank();
+  std::size_t columns = extents.extent(Rank - 1), rows = 1;
+  for (std::size_t d = 0; d + 1 < Rank; d++) {
+    rows *= extents.extent(d);
+  }
+  if (rows == 0 || columns == 0) {
+    return;
+  }
+
+  std::size_t tile_columns = std::min(columns, md_tile_columns);
+  std::size_t tile_rows =
+      std::max(md_tile_elements / tile_columns, std::size_t(1));
+  std::size_t column_tiles =
+      dr::__detail::partition_up(columns, tile_columns);
+  auto tile = [=](std::size_t t) {
+    std::size_t first = t / column_tiles * tile_rows;
+    std::size_t last = std::min(first + tile_rows, rows);
+    std::size_t column = t % column_tiles * tile_columns;
+    std::size_t n = std::min(tile_columns, columns - column);
+    dr::__detail::dr_extents<Rank> index;
+    for (std::size_t row = first; row < last; row++) {
+      for (std::size_t d = Rank - 1, linear = row; d-- > 0;) {
+        index[d] = linear % extents.extent(d);
+        linear /= extents.extent(d);
+      }
+      index[Rank - 1] = column;
+      row_op(index, n);
+    }
+  };
+
+  std::size_t tiles =
+      dr::__detail::partition_up(rows, tile_rows) * column_tiles;
+  if (tiles == 1) {
+    tile(0);
+    return;
+  }
+  std::vector<std::size_t> ids(tiles);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::for_each(std::execution::par, ids.begin(), ids.end(), tile);
+}
+
+// True if the last dimension of every mdspan in the tuple has stride 1
+bool unit_stride(auto mdspans) {
+  bool unit = true;
+  dr::__detail::tuple_foreach(mdspans, [&unit](auto mdspan) {
+    unit = unit && mdspan.stride(mdspan.rank() - 1) == 1;
+  });
+  return unit;
+}
+
+#ifdef SYCL_LANGUAGE_VERSION
+// Device engine for the local part of md_for_each and
+// stencil_for_each. Calls fn(index) for every index of extents, where
+// index is a std::array of the rank. Rank 2 and 3 use a range of the
+// same rank, and the other ranks a linear range.
+template <typename Extents, typename Fn>
+sycl::event md_parallel_for(const Extents &extents, Fn fn) {
+  constexpr std::size_t Rank = Extents::rank();
+  if constexpr (Rank == 2) {
+    return dr::__detail::parallel_for(
+        mhp::sycl_queue(), sycl::range(extents.extent(0), extents.extent(1)),
+        fn);
+  } else if constexpr (Rank == 3) {
+    return dr::__detail::parallel_for(
+        mhp::sycl_queue(),
+        sycl::range(extents.extent(0), extents.extent(1), extents.extent(2)),
+        fn);
+  } else {
+    dr::__detail::dr_extents<Rank> shape;
+    std::size_t n = 1;
+    for (std::size_t d = 0; d < Rank; d++) {
+      shape[d] = extents.extent(d);
+      n *= shape[d];
+    }
+    return dr::__detail::parallel_for(
+        mhp::sycl_queue(), sycl::range(n), [=](auto linear) {
+          fn(dr::__detail::linear_to_index(std::size_t(linear), shape));
+        });
+  }
+}
+#endif
+
 }; // namespace dr::mhp::__detail
 
 namespace dr::mhp {
 
 namespace detail = dr::__detail;
 
-/// Collective for_each on distributed range
+/// Collective for_each on distributed range. op is called with a tuple
+/// of mdspans centered on the element, one per operand, for every
+/// element of the first operand, so op reads the neighbors of the
+/// element with in(-1, 0, 0), in(0, 0, 1), and so on, for any rank.
+/// The neighbors in the leading dimension on another rank come from
+/// the halo, which must be exchanged before the call.
 template <typename... Ts>
 void stencil_for_each(auto op, is_mdspan_view auto &&...drs) {
   auto ranges = std::tie(drs...);
@@ -70,43 +175,44 @@ void stencil_for_each(auto op, is_mdspan_view auto &&...drs) {
           // Transform operand_infos into stencils
           auto stencils =
               detail::tuple_transform(operand_infos, [=](auto info) {
-                return md::mdspan(
-                    std::to_address(&info.first(index[0], index[1])),
-                    info.second);
+                return md::mdspan(std::to_address(&info.first(index)),
+                                  info.second);
               });
           op(stencils);
         };
-        // TODO: Extend sycl_utils.hpp to handle ranges > 1D. It uses
-        // ndrange and handles > 32 bits.
-        dr::__detail::parallel_for(
-            mhp::sycl_queue(),
-            sycl::range(mdspan0.extent(0), mdspan0.extent(1)), do_point)
-            .wait();
+        __detail::md_parallel_for(mdspan0.extents(), do_point).wait();
 #else
         assert(false);
 #endif
       } else {
-        // Given an index, invoke op on a tuple of stencils
-        auto invoke_index = [=](auto index) {
-          // Transform operand_infos into stencils
-          auto stencils =
-              detail::tuple_transform(operand_infos, [=](auto info) {
-                return md::mdspan(std::to_address(&info.first(index)),
-                                  info.second);
-              });
-          op(stencils);
-        };
-#if 0
-        // Does not vectorize. Something about loop index being forced into memory
-        detail::mdspan_foreach<mdspan0.rank(), decltype(invoke_index)>(
-            mdspan0.extents(), invoke_index);
-#else
-        for (std::size_t i = 0; i < mdspan0.extents().extent(0); i++) {
-          for (std::size_t j = 0; j < mdspan0.extents().extent(1); j++) {
-            invoke_index(std::array<std::size_t, 2>{i, j});
+        // Invoke op on a tuple of stencils for each element of a run
+        // of the last dimension. The stencils are centered on
+        // consecutive elements, so the unit stride loop vectorizes.
+        auto unit = __detail::unit_stride(detail::tuple_transform(
+            operand_infos, [](auto info) { return info.first; }));
+        auto invoke_run = [=](auto index, std::size_t n) {
+          auto firsts = detail::tuple_transform(operand_infos, [=](auto info) {
+            return std::make_tuple(
+                std::to_address(&info.first(index)),
+                info.first.stride(info.first.rank() - 1), info.second);
+          });
+          auto stencils = [&firsts](std::size_t j, bool strided) {
+            return detail::tuple_transform(firsts, [=](auto first) {
+              auto [p, stride, extents] = first;
+              return md::mdspan(p + j * (strided ? stride : 1), extents);
+            });
+          };
+          if (unit) {
+            for (std::size_t j = 0; j < n; j++) {
+              op(stencils(j, false));
+            }
+          } else {
+            for (std::size_t j = 0; j < n; j++) {
+              op(stencils(j, true));
+            }
           }
-        }
-#endif
+        };
+        __detail::md_for_each_rows(mdspan0.extents(), invoke_run);
       }
     }
   }
@@ -143,7 +249,7 @@ void for_each(F op, is_mdspan_view auto &&...drs) {
           // Transform mdspans into references
           auto references = detail::tie_transform(
               operand_mdspans, [index](auto mdspan) -> decltype(auto) {
-                return mdspan(index[0], index[1]);
+                return mdspan(index);
               });
           static_assert(
               std::invocable<F, decltype(references)> ||
@@ -159,44 +265,54 @@ void for_each(F op, is_mdspan_view auto &&...drs) {
             op(global_index, references);
           }
         };
-
-        // TODO: Extend sycl_utils.hpp to handle ranges > 1D. It uses
-        // ndrange and handles > 32 bits.
-
-        dr::__detail::parallel_for(
-            mhp::sycl_queue(),
-            sycl::range(mdspan0.extent(0), mdspan0.extent(1)), invoke_index)
-            .wait();
+        __detail::md_parallel_for(mdspan0.extents(), invoke_index).wait();
 #else
         assert(false);
 #endif
       } else {
-        // invoke op on a tuple of references created by using the mdspan's and
-        // index
-        auto invoke_index = [=](auto index) {
-          // Transform operand_infos into references
-          auto references = detail::tie_transform(
-              operand_mdspans,
-              [index](auto mdspan) -> decltype(auto) { return mdspan(index); });
-          static_assert(
-              std::invocable<F, decltype(references)> ||
-              std::invocable<F, decltype(index), decltype(references)>);
-          if constexpr (std::invocable<F, decltype(references)>) {
-            op(references);
-          } else if constexpr (std::invocable<F, decltype(index),
-                                              decltype(references)>) {
-            auto global_index = index;
-            for (std::size_t i = 0; i < rng::size(global_index); i++) {
-              global_index[i] += origin[i];
+        // Invoke op on a tuple of references for each element of a run
+        // of the last dimension, from pointers to the first element of
+        // the run
+        auto unit = __detail::unit_stride(operand_mdspans);
+        auto invoke_run = [=](auto index, std::size_t n) {
+          auto firsts = detail::tuple_transform(
+              operand_mdspans, [index](auto mdspan) {
+                return std::make_pair(&mdspan(index),
+                                      mdspan.stride(mdspan.rank() - 1));
+              });
+          auto global_index = index;
+          for (std::size_t i = 0; i < rng::size(global_index); i++) {
+            global_index[i] += origin[i];
+          }
+          auto invoke = [&](std::size_t j, auto references) {
+            static_assert(
+                std::invocable<F, decltype(references)> ||
+                std::invocable<F, decltype(index), decltype(references)>);
+            if constexpr (std::invocable<F, decltype(references)>) {
+              op(references);
+            } else {
+              auto element_index = global_index;
+              element_index[rng::size(element_index) - 1] += j;
+              op(element_index, references);
+            }
+          };
+          if (unit) {
+            for (std::size_t j = 0; j < n; j++) {
+              invoke(j, detail::tie_transform(
+                            firsts, [j](auto first) -> decltype(auto) {
+                              return first.first[j];
+                            }));
             }
-
-            op(global_index, references);
           } else {
-            assert(false);
+            for (std::size_t j = 0; j < n; j++) {
+              invoke(j, detail::tie_transform(
+                            firsts, [j](auto first) -> decltype(auto) {
+                              return first.first[j * first.second];
+                            }));
+            }
           }
         };
-        detail::mdspan_foreach<mdspan0.rank(), decltype(invoke_index)>(
-            mdspan0.extents(), invoke_index);
+        __detail::md_for_each_rows(mdspan0.extents(), invoke_run);
       }
     }
   }
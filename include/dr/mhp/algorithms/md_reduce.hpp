@@ -0,0 +1,425 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include <dr/detail/communicator.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/containers/distributed_mdarray.hpp>
+#include <dr/mhp/containers/mdarray_tiles.hpp>
+#include <dr/mhp/global.hpp>
+#include <dr/mhp/sycl_support.hpp>
+
+namespace dr::mhp::__detail {
+
+// A row major tile viewed as outer x extent x inner around an axis
+struct axis_shape {
+  std::size_t outer, extent, inner;
+};
+
+// Elements along the inner dimension handled by one task. The running
+// values of a block stay in the L1 cache while the axis is streamed.
+inline constexpr std::size_t axis_block = 1 << 11;
+// A reduction with fewer tasks than this also splits the axis
+inline constexpr std::size_t axis_tasks = 256;
+// Shortest piece of a split axis
+inline constexpr std::size_t axis_piece = 64;
+
+template <std::size_t Rank>
+axis_shape make_axis_shape(const dr::__detail::dr_extents<Rank> &shape,
+                           std::size_t axis) {
+  axis_shape s{1, shape[axis], 1};
+  for (std::size_t i = 0; i < axis; i++) {
+    s.outer *= shape[i];
+  }
+  for (std::size_t i = axis + 1; i < Rank; i++) {
+    s.inner *= shape[i];
+  }
+  return s;
+}
+
+// Calls fn(task) for tasks [0, n) in parallel
+template <typename Fn> void for_each_task(std::size_t n, Fn fn) {
+  std::vector<std::size_t> tasks(n);
+  std::iota(tasks.begin(), tasks.end(), 0);
+  std::for_each(std::execution::par_unseq, tasks.begin(), tasks.end(), fn);
+}
+
+// out[o][b] = in[o][first][b] op ... op in[o][last - 1][b] for the
+// elements b of a block. The inner loops are over contiguous b, so they
+// vectorize. A row (inner == 1) is reduced with std::reduce.
+template <typename T, typename Op>
+void reduce_axis_block(const T *in, T *out, axis_shape s, std::size_t o,
+                       std::size_t b0, std::size_t b1, std::size_t first,
+                       std::size_t last, Op op) {
+  const T *row = in + (o * s.extent + first) * s.inner;
+  if (s.inner == 1) {
+    out[o] =
+        std::reduce(std::execution::unseq, row + 1, row + (last - first),
+                    row[0], op);
+    return;
+  }
+  T *acc = out + o * s.inner;
+  for (std::size_t b = b0; b < b1; b++) {
+    acc[b] = row[b];
+  }
+  for (std::size_t k = first + 1; k < last; k++) {
+    row += s.inner;
+    for (std::size_t b = b0; b < b1; b++) {
+      acc[b] = op(acc[b], row[b]);
+    }
+  }
+}
+
+// Reduces a row major tile along the middle dimension of s, into an
+// outer x inner tile. Tasks are blocks of the inner dimension. When
+// there are too few of them, the axis is also split into pieces that
+// are reduced separately and combined in order.
+template <typename T, typename Op>
+void reduce_axis_local(const T *in, T *out, axis_shape s, Op op) {
+  // A rank without rows has an empty tile, and may have no memory
+  if (s.extent == 0 || s.outer == 0) {
+    return;
+  }
+  std::size_t blocks = dr::__detail::partition_up(s.inner, axis_block);
+  std::size_t tasks = s.outer * blocks;
+  if (tasks == 0) {
+    return;
+  }
+  std::size_t most = std::max(s.extent / axis_piece, std::size_t(1));
+  std::size_t pieces = std::clamp(axis_tasks / tasks, std::size_t(1), most);
+  std::size_t piece = dr::__detail::partition_up(s.extent, pieces);
+  pieces = dr::__detail::partition_up(s.extent, piece);
+
+  std::size_t size = s.outer * s.inner;
+  std::vector<T> partial(pieces > 1 ? pieces * size : 0);
+  for_each_task(tasks * pieces, [=, p = partial.data()](std::size_t t) {
+    std::size_t o = t / blocks % s.outer, i = t / tasks;
+    std::size_t b0 = t % blocks * axis_block;
+    std::size_t b1 = std::min(b0 + axis_block, s.inner);
+    std::size_t first = i * piece, last = std::min(first + piece, s.extent);
+    reduce_axis_block(in, pieces > 1 ? p + i * size : out, s, o, b0, b1,
+                      first, last, op);
+  });
+  if (pieces > 1) {
+    std::size_t size_blocks = dr::__detail::partition_up(size, axis_block);
+    for_each_task(size_blocks, [=, p = partial.data()](std::size_t t) {
+      std::size_t b0 = t * axis_block, b1 = std::min(b0 + axis_block, size);
+      for (std::size_t b = b0; b < b1; b++) {
+        out[b] = p[b];
+      }
+      for (std::size_t i = 1; i < pieces; i++) {
+        for (std::size_t b = b0; b < b1; b++) {
+          out[b] = op(out[b], p[i * size + b]);
+        }
+      }
+    });
+  }
+}
+
+// Inclusive scan of a row major tile along the middle dimension of s.
+// Tasks are blocks of the inner dimension, and each one streams the
+// axis with the previous output row of the block in cache.
+template <typename T, typename Op>
+void scan_axis_local(const T *in, T *out, axis_shape s, Op op) {
+  if (s.extent == 0 || s.outer == 0) {
+    return;
+  }
+  std::size_t blocks = dr::__detail::partition_up(s.inner, axis_block);
+  for_each_task(s.outer * blocks, [=](std::size_t t) {
+    std::size_t o = t / blocks, b0 = t % blocks * axis_block;
+    std::size_t b1 = std::min(b0 + axis_block, s.inner);
+    std::size_t first = o * s.extent * s.inner;
+    if (s.inner == 1) {
+      std::inclusive_scan(in + first, in + first + s.extent, out + first, op);
+      return;
+    }
+    for (std::size_t b = b0; b < b1; b++) {
+      out[first + b] = in[first + b];
+    }
+    for (std::size_t k = 1; k < s.extent; k++) {
+      const T *x = in + first + k * s.inner;
+      T *y = out + first + k * s.inner;
+      for (std::size_t b = b0; b < b1; b++) {
+        y[b] = op(y[b - s.inner], x[b]);
+      }
+    }
+  });
+}
+
+// out[i] = op(prefix[i % n], out[i]) for the rows of n elements of a
+// tile
+template <typename T, typename Op>
+void apply_prefix(const T *prefix, T *out, std::size_t rows, std::size_t n,
+                  Op op) {
+  std::size_t blocks = dr::__detail::partition_up(n, axis_block);
+  for_each_task(rows * blocks, [=](std::size_t t) {
+    T *y = out + t / blocks * n;
+    std::size_t b0 = t % blocks * axis_block;
+    std::size_t b1 = std::min(b0 + axis_block, n);
+    for (std::size_t b = b0; b < b1; b++) {
+      y[b] = op(prefix[b], y[b]);
+    }
+  });
+}
+
+// Collective. Combines the partial reductions of the ranks that hold
+// rows, which are the first ranks, and scatters the result to the
+// tiles of an array distributed by rows of row_size elements. partial
+// is the whole result on ranks with rows, and is ignored on the others.
+//
+// Predefined MPI operations on arithmetic types use
+// MPI_Reduce_scatter when every rank holds rows. Otherwise each rank
+// sends every owner its part with one alltoallv, and the owner
+// combines the parts in rank order, so op only needs to be
+// associative.
+template <typename T, typename Op>
+void reduce_scatter_rows(const std::vector<T> &partial,
+                         std::size_t row_ranks, std::size_t rows,
+                         std::size_t row_size, T *out, Op op) {
+  auto comm = default_comm();
+  std::size_t ranks = comm.size(); // dr-style ignore
+  std::size_t me = comm.rank();
+  std::size_t tile = dr::__detail::partition_up(rows, ranks);
+  std::vector<std::size_t> counts(ranks), offsets(ranks);
+  for (std::size_t q = 0; q < ranks; q++) {
+    counts[q] = tile_rows(rows, tile, q) * row_size;
+    offsets[q] = std::min(q * tile, rows) * row_size;
+  }
+  dr::drlog.debug("reduce scatter rows: ranks with rows: {} rows: {}\n",
+                  row_ranks, rows);
+
+  if constexpr (mpi_arithmetic<T>) {
+    if (mpi_op<Op, T>() != MPI_OP_NULL && row_ranks == ranks) {
+      std::vector<int> int_counts(counts.begin(), counts.end());
+      comm.reduce_scatter(partial.data(), out, int_counts.data(),
+                          mpi_op<Op, T>());
+      return;
+    }
+  }
+
+  bool has_rows = me < row_ranks;
+  std::vector<std::size_t> send_counts(ranks), receive_counts(ranks),
+      receive_offsets(ranks);
+  for (std::size_t q = 0; q < ranks; q++) {
+    send_counts[q] = has_rows ? counts[q] : 0;
+    receive_counts[q] = q < row_ranks ? counts[me] : 0;
+    receive_offsets[q] = std::min(q, row_ranks) * counts[me];
+  }
+  std::vector<T> receive(row_ranks * counts[me]);
+  comm.alltoallv(partial, send_counts, offsets, receive, receive_counts,
+                 receive_offsets);
+
+  std::size_t n = counts[me];
+  for_each_task(dr::__detail::partition_up(n, axis_block),
+                [=, r = receive.data()](std::size_t t) {
+                  std::size_t b0 = t * axis_block;
+                  std::size_t b1 = std::min(b0 + axis_block, n);
+                  for (std::size_t b = b0; b < b1; b++) {
+                    out[b] = r[b];
+                  }
+                  for (std::size_t q = 1; q < row_ranks; q++) {
+                    for (std::size_t b = b0; b < b1; b++) {
+                      out[b] = op(out[b], r[q * n + b]);
+                    }
+                  }
+                });
+}
+
+// Collective. Combines carry, the last row of the local scan, of every
+// rank before this one into prefix. Returns false on rank 0, which has
+// no prefix. The ranks that hold rows are the first ranks, so the
+// others never contribute.
+//
+// Predefined MPI operations on arithmetic types use MPI_Exscan.
+// Otherwise the carries are gathered and combined in rank order.
+template <typename T, typename Op>
+bool exclusive_carry(const std::vector<T> &carry, std::vector<T> &prefix,
+                     Op op) {
+  auto comm = default_comm();
+  std::size_t me = comm.rank(), n = rng::size(carry);
+  prefix.resize(n);
+
+  if constexpr (mpi_arithmetic<T>) {
+    if (mpi_op<Op, T>() != MPI_OP_NULL) {
+      comm.exscan(carry.data(), prefix.data(), n, mpi_op<Op, T>());
+      return me > 0;
+    }
+  }
+
+  std::vector<T> all(comm.size() * n); // dr-style ignore
+  comm.all_gather(carry.data(), all.data(), n);
+  if (me == 0) {
+    return false;
+  }
+  std::copy(all.begin(), all.begin() + n, prefix.begin());
+  for (std::size_t q = 1; q < me; q++) {
+    for (std::size_t b = 0; b < n; b++) {
+      prefix[b] = op(prefix[b], all[q * n + b]);
+    }
+  }
+  return true;
+}
+
+// Local tile of a distributed_mdarray on the host, and its shape. The
+// tile is copied when it is on a device.
+template <typename T, std::size_t Rank> struct host_tile {
+  host_tile(distributed_mdarray<T, Rank> &array) {
+    std::size_t ranks = default_comm().size(); // dr-style ignore
+    for (std::size_t i = 0; i < Rank; i++) {
+      shape[i] = array.extent(i);
+    }
+    std::size_t tile = dr::__detail::partition_up(shape[0], ranks);
+    shape[0] = tile_rows(shape[0], tile, default_comm().rank());
+    size = 1;
+    for (auto extent : shape) {
+      size *= extent;
+    }
+    device = local_tile_pointer<T>(array);
+    data = device;
+    if (mhp::use_sycl()) {
+      host.resize(size);
+      data = host.data();
+    }
+  }
+
+  // Copies the tile from the device
+  void get() {
+    if (mhp::use_sycl() && size > 0) {
+      sycl_copy(device, device + size, host.data());
+    }
+  }
+
+  // Copies the tile to the device
+  void put() {
+    if (mhp::use_sycl() && size > 0) {
+      sycl_copy(host.data(), host.data() + size, device);
+    }
+  }
+
+  dr::__detail::dr_extents<Rank> shape;
+  std::size_t size;
+  T *device, *data;
+  std::vector<T> host;
+};
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// An axis of a distributed_mdarray, for reduce and scan. The axis is a
+/// type of its own, so reduce(mdarray, 0) is still a reduction of all
+/// elements with init 0.
+struct axis {
+  std::size_t value;
+};
+
+/// Collective. Reduces a distributed_mdarray along axis with op, and
+/// returns a distributed_mdarray with the other axes. op must be
+/// associative and commutative, like for std::reduce.
+///
+/// Only the leading axis is distributed. A reduction along another
+/// axis reduces the local tile, and the result has the same rows on
+/// the same rank. A reduction along the leading axis reduces the local
+/// rows, then combines the partial results of the ranks with a reduce
+/// scatter, so every rank receives the part of the result it owns.
+/// The local reductions are split into blocks of the contiguous inner
+/// dimension that stay in cache, and the inner loops vectorize.
+template <typename T, std::size_t Rank, typename BinaryOp = std::plus<>>
+  requires(Rank > 1)
+distributed_mdarray<T, Rank - 1> reduce(distributed_mdarray<T, Rank> &in,
+                                        mhp::axis along,
+                                        BinaryOp op = BinaryOp()) {
+  std::size_t axis = along.value;
+  assert(axis < Rank && in.extent(axis) > 0);
+  dr::__detail::dr_extents<Rank - 1> shape;
+  for (std::size_t i = 0, j = 0; i < Rank; i++) {
+    if (i != axis) {
+      shape[j++] = in.extent(i);
+    }
+  }
+  distributed_mdarray<T, Rank - 1> out(shape);
+  __detail::host_tile<T, Rank> in_tile(in);
+  __detail::host_tile<T, Rank - 1> out_tile(out);
+  in_tile.get();
+  dr::drlog.debug("reduce: axis: {} local rows: {}\n", axis,
+                  in_tile.shape[0]);
+
+  if (axis > 0) {
+    __detail::reduce_axis_local(
+        in_tile.data, out_tile.data,
+        __detail::make_axis_shape(in_tile.shape, axis), op);
+  } else {
+    std::size_t ranks = default_comm().size(); // dr-style ignore
+    std::size_t tile = dr::__detail::partition_up(in.extent(0), ranks);
+    std::size_t row_ranks = dr::__detail::partition_up(in.extent(0), tile);
+    std::vector<T> partial;
+    if (in_tile.shape[0] > 0) {
+      partial.resize(in_tile.size / in_tile.shape[0]);
+      __detail::reduce_axis_local(
+          in_tile.data, partial.data(),
+          __detail::make_axis_shape(in_tile.shape, 0), op);
+    }
+    std::size_t row_size = 1;
+    for (std::size_t i = 1; i < Rank - 1; i++) {
+      row_size *= shape[i];
+    }
+    __detail::reduce_scatter_rows(partial, row_ranks, shape[0], row_size,
+                                  out_tile.data, op);
+  }
+
+  out_tile.put();
+  barrier();
+  return out;
+}
+
+/// Collective. Inclusive scan of a distributed_mdarray along axis with
+/// op, returned as a distributed_mdarray with the same shape. op must
+/// be associative.
+///
+/// A scan along an axis other than the leading one scans the local
+/// tile. A scan along the leading axis scans the local rows, combines
+/// the last rows of the ranks before this one with an exclusive scan
+/// over the ranks, and applies the result to the local rows.
+template <typename T, std::size_t Rank, typename BinaryOp = std::plus<>>
+distributed_mdarray<T, Rank> scan(distributed_mdarray<T, Rank> &in,
+                                  mhp::axis along, BinaryOp op = BinaryOp()) {
+  std::size_t axis = along.value;
+  assert(axis < Rank);
+  dr::__detail::dr_extents<Rank> shape;
+  for (std::size_t i = 0; i < Rank; i++) {
+    shape[i] = in.extent(i);
+  }
+  distributed_mdarray<T, Rank> out(shape);
+  __detail::host_tile<T, Rank> in_tile(in), out_tile(out);
+  in_tile.get();
+  auto s = __detail::make_axis_shape(in_tile.shape, axis);
+  dr::drlog.debug("scan: axis: {} local rows: {}\n", axis, in_tile.shape[0]);
+  __detail::scan_axis_local(in_tile.data, out_tile.data, s, op);
+
+  if (axis == 0) {
+    std::size_t rows = in_tile.shape[0];
+    std::vector<T> carry(s.inner), prefix;
+    if (rows > 0) {
+      auto last = out_tile.data + (rows - 1) * s.inner;
+      std::copy(last, last + s.inner, carry.begin());
+    }
+    if (__detail::exclusive_carry(carry, prefix, op) && rows > 0) {
+      __detail::apply_prefix(prefix.data(), out_tile.data, rows, s.inner, op);
+    }
+  }
+
+  out_tile.put();
+  barrier();
+  return out;
+}
+
+} // namespace dr::mhp
@@ -0,0 +1,295 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <iterator>
+#include <vector>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/detail/utils.hpp>
+#include <dr/mhp/algorithms/binary_search.hpp>
+#include <dr/mhp/algorithms/copy_if.hpp>
+#include <dr/mhp/global.hpp>
+#include <dr/mhp/sycl_support.hpp>
+
+namespace dr::mhp::__detail {
+
+// Copies n elements of a distributed range, starting at first, to dst
+template <typename T>
+void get_elements(dr::distributed_contiguous_iterator auto first,
+                  std::size_t n, T *dst) {
+  for (auto &&segment : dr::ranges::segments(first)) {
+    if (n == 0) {
+      break;
+    }
+    std::size_t size = std::min(std::size_t(rng::distance(segment)), n);
+    rng::begin(segment).get(dst, size);
+    dst += size;
+    n -= size;
+  }
+  assert(n == 0);
+}
+
+template <typename T>
+T get_element(dr::distributed_contiguous_iterator auto it) {
+  T value;
+  get_elements(it, 1, &value);
+  return value;
+}
+
+// Merge path: number of elements of a in the first d elements of the
+// merge of a and b. Ties take a first, like std::merge. Reads about
+// 2 log(d) elements, which may be on other ranks.
+template <typename T, typename Compare>
+std::size_t merge_path(auto a, std::size_t na, auto b, std::size_t nb,
+                       std::size_t d, Compare &comp) {
+  std::size_t lo = d > nb ? d - nb : 0, hi = std::min(d, na);
+  while (lo < hi) {
+    std::size_t i = lo + (hi - lo) / 2;
+    if (!comp(get_element<T>(b + (d - i - 1)), get_element<T>(a + i))) {
+      lo = i + 1;
+    } else {
+      hi = i;
+    }
+  }
+  return lo;
+}
+
+// Writes [first, first + n) of host memory to a local segment, which
+// may be in device memory
+template <typename T> void put_local(const T *first, std::size_t n, T *dst) {
+  if (mhp::use_sycl()) {
+    sycl_copy(first, first + n, dst);
+  } else {
+    std::copy(first, first + n, dst);
+  }
+}
+
+// Collective. Applies a set operation to sorted ranges a and b, and
+// writes the result to out. Returns the size of the result.
+//
+// The merge of a and b is split evenly between the ranks with merge
+// paths, and each split is moved to the first element with the same
+// value, so a value is never split between ranks. Each rank reads its
+// parts of a and b, applies op, and the results are redistributed to
+// out.
+template <typename Compare, typename Op>
+std::size_t set_operation(dr::distributed_contiguous_range auto &&a,
+                          dr::distributed_contiguous_range auto &&b,
+                          dr::distributed_contiguous_iterator auto out,
+                          Compare comp, Op op) {
+  using T = rng::range_value_t<decltype(a)>;
+  static_assert(std::is_same_v<T, rng::range_value_t<decltype(b)>>);
+  auto comm = default_comm();
+  std::size_t nprocs = comm.size(); // dr-style ignore
+  std::size_t na = rng::distance(a), nb = rng::distance(b);
+  auto a_first = rng::begin(a), b_first = rng::begin(b);
+
+  // Value at the start of the part of this rank of the merge
+  struct split {
+    T value;
+    bool valid;
+  };
+  std::size_t part = dr::__detail::partition_up(na + nb, nprocs);
+  std::size_t d = std::min(comm.rank() * part, na + nb);
+  split mine{T{}, false};
+  if (d < na + nb) {
+    std::size_t i = merge_path<T>(a_first, na, b_first, nb, d, comp);
+    std::size_t j = d - i;
+    if (i < na && (j == nb || !comp(get_element<T>(b_first + j),
+                                    get_element<T>(a_first + i)))) {
+      mine = {get_element<T>(a_first + i), true};
+    } else {
+      mine = {get_element<T>(b_first + j), true};
+    }
+  }
+  std::vector<split> splits(nprocs);
+  comm.all_gather(mine, splits);
+
+  // Elements before each split value, counted in the local segments
+  std::vector<std::size_t> positions(2 * nprocs);
+  auto count_before = [&](auto &&r, const T &value) {
+    std::size_t n = 0;
+    for (auto &&s : local_segments(r)) {
+      n += local_bound(std::to_address(rng::begin(s)), rng::distance(s),
+                       value, false, comp);
+    }
+    return n;
+  };
+  for (std::size_t q = 0; q < nprocs; q++) {
+    if (splits[q].valid) {
+      positions[2 * q] = count_before(a, splits[q].value);
+      positions[2 * q + 1] = count_before(b, splits[q].value);
+    }
+  }
+  comm.all_reduce(positions.data(), 2 * nprocs, MPI_SUM);
+  for (std::size_t q = 0; q < nprocs; q++) {
+    if (!splits[q].valid) {
+      positions[2 * q] = na;
+      positions[2 * q + 1] = nb;
+    }
+  }
+  auto first = [&](std::size_t q, std::size_t which) {
+    return q < nprocs ? positions[2 * q + which] : which == 0 ? na : nb;
+  };
+
+  std::size_t me = comm.rank();
+  std::size_t i0 = first(me, 0), i1 = first(me + 1, 0);
+  std::size_t j0 = first(me, 1), j1 = first(me + 1, 1);
+  std::vector<T> a_part(i1 - i0), b_part(j1 - j0), values;
+  get_elements(a_first + i0, i1 - i0, a_part.data());
+  get_elements(b_first + j0, j1 - j0, b_part.data());
+  op(a_part.begin(), a_part.end(), b_part.begin(), b_part.end(),
+     std::back_inserter(values), comp);
+  dr::drlog.debug("set operation: a: {} b: {} result: {}\n", i1 - i0, j1 - j0,
+                  rng::size(values));
+
+  std::array<std::size_t, 1> counts{rng::size(values)};
+  return redistribute<1>(values, counts, out)[0];
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective. Merges the sorted ranges a and b into out, and returns
+/// the end of the output. The merge is stable.
+///
+/// Every rank merges the part of the output that it owns. It finds the
+/// elements of a and b for the first and last position of its part
+/// with a merge path search, reads them, and merges them in place. No
+/// other data moves.
+template <dr::distributed_contiguous_range DR1,
+          dr::distributed_contiguous_range DR2,
+          dr::distributed_contiguous_iterator O,
+          typename Compare = std::less<>>
+O merge(DR1 &&a, DR2 &&b, O out, Compare comp = Compare()) {
+  using T = rng::range_value_t<DR1>;
+  std::size_t na = rng::distance(a), nb = rng::distance(b), n = na + nb;
+  auto a_first = rng::begin(a), b_first = rng::begin(b);
+  dr::drlog.debug("merge: {} + {}\n", na, nb);
+
+  std::size_t position = 0;
+  for (auto &&segment : dr::ranges::segments(out)) {
+    std::size_t first = position;
+    std::size_t last = std::min(position + rng::distance(segment), n);
+    position += rng::distance(segment);
+    if (first >= last || dr::ranges::rank(segment) != default_comm().rank()) {
+      continue;
+    }
+
+    std::size_t i0 =
+        __detail::merge_path<T>(a_first, na, b_first, nb, first, comp);
+    std::size_t i1 =
+        __detail::merge_path<T>(a_first, na, b_first, nb, last, comp);
+    std::size_t j0 = first - i0, j1 = last - i1;
+    std::vector<T> a_part(i1 - i0), b_part(j1 - j0);
+    __detail::get_elements(a_first + i0, i1 - i0, a_part.data());
+    __detail::get_elements(b_first + j0, j1 - j0, b_part.data());
+
+    T *local = std::to_address(dr::ranges::local(rng::begin(segment)));
+    if (mhp::use_sycl()) {
+      std::vector<T> merged(last - first);
+      std::merge(a_part.begin(), a_part.end(), b_part.begin(), b_part.end(),
+                 merged.begin(), comp);
+      __detail::put_local(merged.data(), rng::size(merged), local);
+    } else {
+      std::merge(a_part.begin(), a_part.end(), b_part.begin(), b_part.end(),
+                 local, comp);
+    }
+  }
+
+  barrier();
+  return out + n;
+}
+
+/// Collective. Writes the elements of sorted range a or sorted range b
+/// to out, like std::set_union, and returns the end of the output.
+template <dr::distributed_contiguous_range DR1,
+          dr::distributed_contiguous_range DR2,
+          dr::distributed_contiguous_iterator O,
+          typename Compare = std::less<>>
+O set_union(DR1 &&a, DR2 &&b, O out, Compare comp = Compare()) {
+  auto op = [](auto... args) { return std::set_union(args...); };
+  return out + __detail::set_operation(a, b, out, comp, op);
+}
+
+/// Collective. Writes the elements of sorted range a that are also in
+/// sorted range b to out, like std::set_intersection, and returns the
+/// end of the output.
+template <dr::distributed_contiguous_range DR1,
+          dr::distributed_contiguous_range DR2,
+          dr::distributed_contiguous_iterator O,
+          typename Compare = std::less<>>
+O set_intersection(DR1 &&a, DR2 &&b, O out, Compare comp = Compare()) {
+  auto op = [](auto... args) { return std::set_intersection(args...); };
+  return out + __detail::set_operation(a, b, out, comp, op);
+}
+
+/// Collective. Writes the elements of sorted range a that are not in
+/// sorted range b to out, like std::set_difference, and returns the
+/// end of the output.
+template <dr::distributed_contiguous_range DR1,
+          dr::distributed_contiguous_range DR2,
+          dr::distributed_contiguous_iterator O,
+          typename Compare = std::less<>>
+O set_difference(DR1 &&a, DR2 &&b, O out, Compare comp = Compare()) {
+  auto op = [](auto... args) { return std::set_difference(args...); };
+  return out + __detail::set_operation(a, b, out, comp, op);
+}
+
+/// Collective. Removes all but the first element of every run of
+/// consecutive elements of r that satisfy pred, and returns the new
+/// end of r. The elements after the new end keep their old values.
+///
+/// The first element of a segment is compared with the last element
+/// of the segment before it, from the table of boundary values that
+/// sort caches. The kept elements are redistributed to the front of r.
+template <dr::distributed_contiguous_range DR, typename Pred = std::equal_to<>>
+auto unique(DR &&r, Pred pred = Pred()) {
+  using T = rng::range_value_t<DR>;
+  auto &bounds = __detail::checked_bounds(r);
+  std::vector<T *> locals;
+  __detail::segment_layout<T>(r, &locals);
+
+  std::vector<T> values;
+  for (std::size_t i = 0; i < rng::size(locals); i++) {
+    if (locals[i] == nullptr) {
+      continue;
+    }
+    auto &s = bounds.segments[i];
+    std::vector<T> host;
+    const T *first = locals[i];
+    if (mhp::use_sycl()) {
+      host.resize(s.size);
+      __detail::sycl_copy(locals[i], locals[i] + s.size, host.data());
+      first = host.data();
+    }
+    std::size_t begin = 0;
+    if (i == 0) {
+      values.push_back(first[0]);
+      begin = 1;
+    }
+    const T *prev = i == 0 ? first : &bounds.segments[i - 1].last;
+    for (std::size_t k = begin; k < s.size; k++) {
+      if (!pred(*prev, first[k])) {
+        values.push_back(first[k]);
+      }
+      prev = first + k;
+    }
+  }
+
+  std::array<std::size_t, 1> counts{rng::size(values)};
+  dr::drlog.debug("unique: local: {}\n", counts[0]);
+  return rng::begin(r) +
+         __detail::redistribute<1>(values, counts, rng::begin(r))[0];
+}
+
+} // namespace dr::mhp
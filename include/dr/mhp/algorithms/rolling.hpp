@@ -0,0 +1,122 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/algorithms/adjacent_difference.hpp>
+#include <dr/mhp/global.hpp>
+
+namespace dr::mhp::__detail {
+
+// Window kernel for the extreme of every window of w elements, with a
+// monotonic deque. The deque holds the positions of the elements that
+// can still be the extreme of a later window, so pop(back, x) is true
+// when x makes back useless. Every element is pushed and popped at
+// most once.
+template <typename Pop> auto extreme_kernel(std::size_t w, Pop pop) {
+  return [w, pop](auto in, std::size_t before, std::size_t, auto *o,
+                  std::size_t n) {
+    // Ring buffer of positions, at most w are in the window
+    std::vector<std::ptrdiff_t> deque(w);
+    std::size_t head = 0, size = 0;
+    std::ptrdiff_t window = w;
+    for (std::ptrdiff_t j = -std::ptrdiff_t(before); j < std::ptrdiff_t(n);
+         j++) {
+      if (size > 0 && deque[head] <= j - window) {
+        head = (head + 1) % w;
+        size--;
+      }
+      while (size > 0 && pop(in[deque[(head + size - 1) % w]], in[j])) {
+        size--;
+      }
+      deque[(head + size++) % w] = j;
+      if (j >= 0) {
+        o[j] = in[deque[head]];
+      }
+    }
+  };
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective. Writes the mean of r[i - w + 1], ..., r[i] to out[i], or
+/// of r[0], ..., r[i] when i < w. out must be aligned with r. The sums
+/// are computed in the value type of out.
+///
+/// Every window is the end of one block of w elements and the start of
+/// the next, with blocks starting at multiples of w in r. The sum of a
+/// window is the suffix sum of the first block plus the prefix sum of
+/// the second, so it costs O(1) per element. The sums do not depend on
+/// how r is split between ranks and threads, and the results are the
+/// same for any number of ranks.
+template <dr::distributed_range DR, dr::distributed_iterator O>
+O rolling_mean(DR &&r, O out, std::size_t w) {
+  using U = std::iter_value_t<O>;
+  assert(w > 0);
+  auto kernel = [w](auto in, std::size_t before, std::size_t index, U *o,
+                    std::size_t n) {
+    // Sums to the end of each block, from the right
+    std::ptrdiff_t first = -std::ptrdiff_t(before), last = n;
+    std::vector<U> suffix(last - first);
+    for (std::ptrdiff_t j = last - 1; j >= first; j--) {
+      bool block_end = (index + j + 1) % w == 0 || j == last - 1;
+      suffix[j - first] =
+          block_end ? U(in[j]) : U(in[j]) + suffix[j + 1 - first];
+    }
+
+    // Sums from the start of each block, from the left. Elements
+    // before the first block start that is in reach are not used.
+    U prefix{};
+    for (std::ptrdiff_t j = first; j < last; j++) {
+      std::size_t g = index + j;
+      prefix = g % w == 0 || j == first ? U(in[j]) : prefix + U(in[j]);
+      if (j >= 0) {
+        U sum = g < w || g % w == w - 1
+                    ? prefix
+                    : suffix[g + 1 - w - index - first] + prefix;
+        o[j] = sum / U(std::min(g + 1, w));
+      }
+    }
+  };
+  __detail::window_transform<U>(r, out, w - 1, kernel);
+  return out + rng::distance(r);
+}
+
+/// Collective. Writes the largest of r[i - w + 1], ..., r[i] under
+/// comp to out[i], or of r[0], ..., r[i] when i < w. out must be
+/// aligned with r. The elements in front of every segment come from
+/// the halo of the container when it is at least w - 1 wide.
+template <dr::distributed_range DR, dr::distributed_iterator O,
+          typename Compare = std::less<>>
+O rolling_max(DR &&r, O out, std::size_t w, Compare comp = Compare()) {
+  assert(w > 0);
+  __detail::window_transform<std::iter_value_t<O>>(
+      r, out, w - 1,
+      __detail::extreme_kernel(
+          w, [comp](auto &&back, auto &&x) { return !comp(x, back); }));
+  return out + rng::distance(r);
+}
+
+/// Collective. Writes the smallest of r[i - w + 1], ..., r[i] under
+/// comp to out[i], like rolling_max.
+template <dr::distributed_range DR, dr::distributed_iterator O,
+          typename Compare = std::less<>>
+O rolling_min(DR &&r, O out, std::size_t w, Compare comp = Compare()) {
+  assert(w > 0);
+  __detail::window_transform<std::iter_value_t<O>>(
+      r, out, w - 1,
+      __detail::extreme_kernel(
+          w, [comp](auto &&back, auto &&x) { return !comp(back, x); }));
+  return out + rng::distance(r);
+}
+
+} // namespace dr::mhp
@@ -0,0 +1,423 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/detail/sycl_utils.hpp>
+#include <dr/mhp/algorithms/binary_search.hpp>
+#include <dr/mhp/algorithms/copy_if.hpp>
+#include <dr/mhp/global.hpp>
+#include <dr/mhp/sycl_support.hpp>
+
+namespace dr::mhp::__detail {
+
+// Value of a run, with a flag that is set when a run starts in the
+// elements that were combined. A value with the flag set does not
+// depend on anything before it. combine is the operator of a segmented
+// scan, and it is associative, so chunks, segments and ranks are
+// combined in any grouping.
+template <typename T> struct scan_carry {
+  T value;
+  bool head;
+};
+
+template <typename T, typename BinaryOp>
+scan_carry<T> combine(const scan_carry<T> &a, const scan_carry<T> &b,
+                      BinaryOp &op) {
+  return {b.head ? b.value : op(a.value, b.value), a.head || b.head};
+}
+
+// Elements scanned by one task. A work item on the device scans a
+// chunk serially, so device chunks are small.
+inline std::size_t scan_chunk() {
+  return mhp::use_sycl() ? std::size_t(1) << 8 : std::size_t(1) << 14;
+}
+
+// A chunk of a local segment. The first pass sets first_head and tail,
+// the second pass reads carry and continues.
+template <typename K, typename T> struct key_chunk {
+  const K *keys;
+  const T *in;
+  T *out;
+  std::size_t size;
+  // First chunk of its segment
+  bool first;
+  // Position of the first run that starts in the chunk, or size. The
+  // first element of a segment is not counted.
+  std::size_t first_head;
+  // Value of the last run of the chunk, in the chunk only
+  T tail;
+  // Value of the run at the element before the chunk, and whether the
+  // first element continues that run
+  T carry;
+  bool continues;
+};
+
+// Calls fn(c, chunks[c]) for every chunk, on the device when mhp uses
+// sycl. The chunks are copied to the device and back.
+template <typename C, typename Fn>
+void for_each_chunk(std::vector<C> &chunks, Fn fn) {
+  std::size_t n = rng::size(chunks);
+  if (n == 0) {
+    return;
+  }
+  if (mhp::use_sycl()) {
+#ifdef SYCL_LANGUAGE_VERSION
+    auto &q = sycl_queue();
+    C *device_chunks = sycl::malloc_device<C>(n, q);
+    q.copy(chunks.data(), device_chunks, n).wait();
+    dr::__detail::parallel_for(q, sycl::range<>(n),
+                               [=](auto idx) {
+                                 std::size_t c = idx;
+                                 fn(c, device_chunks[c]);
+                               })
+        .wait();
+    q.copy(device_chunks, chunks.data(), n).wait();
+    sycl::free(device_chunks, q);
+#else
+    assert(false);
+#endif
+  } else {
+    std::vector<std::size_t> ids(n);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::for_each(std::execution::par_unseq, ids.begin(), ids.end(),
+                  [&](std::size_t c) { fn(c, chunks[c]); });
+  }
+}
+
+// Collective. Entries for all nonempty segments, in the order of the
+// segments, with one all gather. ranks holds the rank of every
+// nonempty segment, and mine the entries of the local ones, in order.
+template <typename E>
+std::vector<E> gather_segments(const std::vector<std::size_t> &ranks,
+                               const std::vector<E> &mine) {
+  auto comm = default_comm();
+  std::size_t nprocs = comm.size(); // dr-style ignore
+  std::vector<int> counts(nprocs), offsets(nprocs);
+  for (auto rank : ranks) {
+    counts[rank] += sizeof(E);
+  }
+  std::exclusive_scan(counts.begin(), counts.end(), offsets.begin(), 0);
+  std::vector<E> gathered(rng::size(ranks)), all(rng::size(ranks));
+  comm.all_gatherv(mine.data(), counts.data(), offsets.data(),
+                   gathered.data());
+
+  // The entries of a rank are in the order of its segments
+  std::vector<std::size_t> next(nprocs);
+  for (std::size_t q = 0; q < nprocs; q++) {
+    next[q] = offsets[q] / sizeof(E);
+  }
+  for (std::size_t i = 0; i < rng::size(ranks); i++) {
+    all[i] = gathered[next[ranks[i]]++];
+  }
+  return all;
+}
+
+// Boundary keys and run values of a nonempty segment
+template <typename K, typename T> struct key_segment {
+  K first, last;
+  // Value of the first run, up to the first run that starts in the
+  // segment, and of the last run, in the segment only
+  T head_value, tail;
+  // A run starts in the segment, not counting its first element
+  bool inner_head;
+};
+
+// The first element of every segment that is not first starts a run
+// when its key does not match the last key of the segment before
+template <typename K, typename T, typename Pred>
+std::vector<bool> segment_heads(const std::vector<key_segment<K, T>> &table,
+                                Pred &pred) {
+  std::vector<bool> heads(rng::size(table), true);
+  for (std::size_t i = 1; i < rng::size(table); i++) {
+    heads[i] = !pred(table[i - 1].last, table[i].first);
+  }
+  return heads;
+}
+
+// Collective. Scans values by key into out. A run of values restarts
+// where !pred(previous key, key). The exclusive scan writes init at
+// the start of a run and op(init, inclusive value) after it.
+//
+// Every rank scans its local chunks in parallel, as if each chunk
+// started a run, and keeps the value of the last run of every chunk.
+// One all gather of the boundary keys and last run values of the
+// segments gives every rank the carry into its segments. A second
+// parallel pass applies the carry to the elements before the first
+// run that starts in a chunk, and shifts the values for the exclusive
+// scan.
+template <bool is_exclusive, typename T, typename Pred, typename BinaryOp>
+void scan_by_key_impl(dr::distributed_contiguous_range auto &&keys,
+                      dr::distributed_contiguous_range auto &&values,
+                      dr::distributed_contiguous_range auto &&out, T init,
+                      Pred pred, BinaryOp op) {
+  using K = rng::range_value_t<decltype(keys)>;
+  using chunk = key_chunk<K, T>;
+  assert(aligned(keys, values, out));
+  auto me = default_comm().rank();
+  std::size_t chunk_size = scan_chunk();
+
+  // Chunks of the local segments, and the nonempty segment of each
+  std::vector<std::size_t> ranks, local_index, first_chunk;
+  std::vector<chunk> chunks;
+  for (auto &&[ks, vs, os] :
+       rng::views::zip(dr::ranges::segments(keys), dr::ranges::segments(values),
+                       dr::ranges::segments(out))) {
+    std::size_t n = rng::distance(ks);
+    if (n == 0) {
+      continue;
+    }
+    ranks.push_back(dr::ranges::rank(ks));
+    if (dr::ranges::rank(ks) != me) {
+      continue;
+    }
+    local_index.push_back(rng::size(ranks) - 1);
+    first_chunk.push_back(rng::size(chunks));
+    const K *k = std::to_address(dr::ranges::local(rng::begin(ks)));
+    const T *in = std::to_address(dr::ranges::local(rng::begin(vs)));
+    T *o = std::to_address(dr::ranges::local(rng::begin(os)));
+    for (std::size_t i = 0; i < n; i += chunk_size) {
+      chunks.push_back({k + i, in + i, o + i, std::min(chunk_size, n - i),
+                        i == 0, 0, T{}, T{}, false});
+    }
+  }
+  first_chunk.push_back(rng::size(chunks));
+
+  // Pass 1: scan every chunk as if it started a run
+  for_each_chunk(chunks, [=](std::size_t, chunk &ch) {
+    std::size_t first_head = ch.size;
+    if (!ch.first && !pred(ch.keys[-1], ch.keys[0])) {
+      first_head = 0;
+    }
+    T run = ch.in[0];
+    ch.out[0] = run;
+    for (std::size_t i = 1; i < ch.size; i++) {
+      bool head = !pred(ch.keys[i - 1], ch.keys[i]);
+      first_head = head && first_head == ch.size ? i : first_head;
+      run = head ? ch.in[i] : op(run, ch.in[i]);
+      ch.out[i] = run;
+    }
+    ch.first_head = first_head;
+    ch.tail = run;
+  });
+
+  // The runs of the chunks combine to the runs of the segments. T{} is
+  // not an identity of every op, so the first chunk starts the value.
+  std::vector<key_segment<K, T>> mine;
+  for (std::size_t s = 0; s < rng::size(local_index); s++) {
+    auto &front = chunks[first_chunk[s]];
+    auto &back = chunks[first_chunk[s + 1] - 1];
+    scan_carry<T> run{front.tail, front.first_head < front.size};
+    for (std::size_t c = first_chunk[s] + 1; c < first_chunk[s + 1]; c++) {
+      auto &ch = chunks[c];
+      run = combine(run, {ch.tail, ch.first_head < ch.size}, op);
+    }
+    mine.push_back({local_value(front.keys),
+                    local_value(back.keys + back.size - 1), T{}, run.value,
+                    run.head});
+  }
+  auto table = gather_segments(ranks, mine);
+  auto heads = segment_heads(table, pred);
+
+  // Carry into every chunk. The first segment starts a run, so the
+  // carry into a chunk that continues a run is always set.
+  std::vector<scan_carry<T>> into(rng::size(table));
+  scan_carry<T> run{T{}, false};
+  for (std::size_t i = 0; i < rng::size(table); i++) {
+    into[i] = run;
+    run = combine(run, {table[i].tail, heads[i] || table[i].inner_head}, op);
+  }
+  for (std::size_t s = 0; s < rng::size(local_index); s++) {
+    std::size_t i = local_index[s];
+    run = into[i];
+    for (std::size_t c = first_chunk[s]; c < first_chunk[s + 1]; c++) {
+      auto &ch = chunks[c];
+      ch.carry = run.value;
+      ch.continues = ch.first ? !heads[i] : ch.first_head != 0;
+      bool head = (ch.first && heads[i]) || ch.first_head < ch.size;
+      run = combine(run, {ch.tail, head}, op);
+    }
+  }
+
+  // Pass 2: apply the carry to the elements before the first run that
+  // starts in the chunk
+  for_each_chunk(chunks, [=](std::size_t, chunk &ch) {
+    std::size_t fixed = ch.continues ? ch.first_head : 0;
+    if constexpr (is_exclusive) {
+      // Backwards, so every element reads the one before it before it
+      // is shifted
+      for (std::size_t i = ch.size - 1; i > 0; i--) {
+        T before =
+            i - 1 < fixed ? op(ch.carry, ch.out[i - 1]) : ch.out[i - 1];
+        bool head = !pred(ch.keys[i - 1], ch.keys[i]);
+        ch.out[i] = head ? init : op(init, before);
+      }
+      ch.out[0] = ch.continues ? op(init, ch.carry) : init;
+    } else {
+      for (std::size_t i = 0; i < fixed; i++) {
+        ch.out[i] = op(ch.carry, ch.out[i]);
+      }
+    }
+  });
+
+  dr::drlog.debug("scan by key: chunks: {} segments: {}\n", rng::size(chunks),
+                  rng::size(table));
+  barrier();
+}
+
+// Runs that start in a local segment, on the host. The first run may
+// continue a run from the segments before, and the last run may
+// continue in the segments after.
+template <typename K, typename T> struct local_runs {
+  std::size_t index;
+  std::vector<K> keys;
+  std::vector<T> values;
+};
+
+template <typename K, typename T, typename Pred, typename BinaryOp>
+key_segment<K, T> reduce_segment(const K *keys, const T *values,
+                                 std::size_t n, local_runs<K, T> &runs,
+                                 Pred &pred, BinaryOp &op) {
+  std::vector<K> host_keys;
+  std::vector<T> host_values;
+  if (mhp::use_sycl()) {
+    host_keys.resize(n);
+    host_values.resize(n);
+    sycl_copy(keys, keys + n, host_keys.data());
+    sycl_copy(values, values + n, host_values.data());
+    keys = host_keys.data();
+    values = host_values.data();
+  }
+
+  runs.keys.push_back(keys[0]);
+  runs.values.push_back(values[0]);
+  for (std::size_t i = 1; i < n; i++) {
+    if (pred(keys[i - 1], keys[i])) {
+      runs.values.back() = op(runs.values.back(), values[i]);
+    } else {
+      runs.keys.push_back(keys[i]);
+      runs.values.push_back(values[i]);
+    }
+  }
+  return {keys[0], keys[n - 1], runs.values.front(), runs.values.back(),
+          rng::size(runs.values) > 1};
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective. Writes the inclusive scan of every run of values to out,
+/// where a run is a group of consecutive elements whose keys satisfy
+/// pred, like oneDPL inclusive_scan_by_segment. keys, values and out
+/// must be aligned. values and out may be the same range.
+///
+/// Runs that cross segments are joined with a carry and a flag that
+/// says if a run started, combined in one all gather of the segment
+/// boundaries. The local passes run in parallel on chunks.
+template <dr::distributed_contiguous_range KR,
+          dr::distributed_contiguous_range VR,
+          dr::distributed_contiguous_range O, typename Pred = std::equal_to<>,
+          typename BinaryOp = std::plus<>>
+auto inclusive_scan_by_key(KR &&keys, VR &&values, O &&out,
+                           Pred pred = Pred(), BinaryOp op = BinaryOp()) {
+  using T = rng::range_value_t<VR>;
+  __detail::scan_by_key_impl<false>(keys, values, out, T{}, pred, op);
+  return rng::begin(out) + rng::distance(keys);
+}
+
+/// Collective. Writes the exclusive scan of every run of values to out,
+/// starting every run with init, like inclusive_scan_by_key.
+template <dr::distributed_contiguous_range KR,
+          dr::distributed_contiguous_range VR,
+          dr::distributed_contiguous_range O, typename T,
+          typename Pred = std::equal_to<>, typename BinaryOp = std::plus<>>
+auto exclusive_scan_by_key(KR &&keys, VR &&values, O &&out, T init,
+                           Pred pred = Pred(), BinaryOp op = BinaryOp()) {
+  using V = rng::range_value_t<VR>;
+  __detail::scan_by_key_impl<true>(keys, values, out, V(init), pred, op);
+  return rng::begin(out) + rng::distance(keys);
+}
+
+/// Collective. Writes the first key of every run of consecutive keys
+/// that satisfy pred to keys_out, and the reduction of its values to
+/// values_out. Returns the ends of both outputs.
+///
+/// A run that crosses segments is written by the rank that holds its
+/// first element, which adds the values of the segments after it from
+/// one all gather of the segment boundaries. The runs are
+/// redistributed to the outputs like copy_if.
+template <dr::distributed_contiguous_range KR,
+          dr::distributed_contiguous_range VR,
+          dr::distributed_contiguous_iterator KO,
+          dr::distributed_contiguous_iterator VO,
+          typename Pred = std::equal_to<>, typename BinaryOp = std::plus<>>
+std::pair<KO, VO> reduce_by_key(KR &&keys, VR &&values, KO keys_out,
+                                VO values_out, Pred pred = Pred(),
+                                BinaryOp op = BinaryOp()) {
+  using K = rng::range_value_t<KR>;
+  using T = rng::range_value_t<VR>;
+  assert(aligned(keys, values));
+  auto me = default_comm().rank();
+
+  std::vector<std::size_t> ranks;
+  std::vector<__detail::local_runs<K, T>> runs;
+  std::vector<__detail::key_segment<K, T>> mine;
+  for (auto &&[ks, vs] : rng::views::zip(dr::ranges::segments(keys),
+                                         dr::ranges::segments(values))) {
+    std::size_t n = rng::distance(ks);
+    if (n == 0) {
+      continue;
+    }
+    ranks.push_back(dr::ranges::rank(ks));
+    if (dr::ranges::rank(ks) == me) {
+      runs.push_back({rng::size(ranks) - 1, {}, {}});
+      mine.push_back(__detail::reduce_segment(
+          std::to_address(dr::ranges::local(rng::begin(ks))),
+          std::to_address(dr::ranges::local(rng::begin(vs))), n, runs.back(),
+          pred, op));
+    }
+  }
+  auto table = __detail::gather_segments(ranks, mine);
+  auto heads = __detail::segment_heads(table, pred);
+
+  // The first run of a segment belongs to the segment before when it
+  // continues. The last run takes the values of the segments after
+  // until a run starts.
+  std::vector<K> out_keys;
+  std::vector<T> out_values;
+  for (auto &r : runs) {
+    std::size_t i = r.index;
+    T last = r.values.back();
+    for (std::size_t j = i + 1; j < rng::size(table) && !heads[j]; j++) {
+      last = op(last, table[j].head_value);
+      if (table[j].inner_head) {
+        break;
+      }
+    }
+    r.values.back() = last;
+    std::size_t first = heads[i] ? 0 : 1;
+    out_keys.insert(out_keys.end(), r.keys.begin() + first, r.keys.end());
+    out_values.insert(out_values.end(), r.values.begin() + first,
+                      r.values.end());
+  }
+
+  std::array<std::size_t, 1> counts{rng::size(out_keys)};
+  dr::drlog.debug("reduce by key: local runs: {}\n", counts[0]);
+  auto n = __detail::redistribute<1>(out_keys, counts, keys_out)[0];
+  __detail::redistribute<1>(out_values, counts, values_out);
+  return {keys_out + n, values_out + n};
+}
+
+} // namespace dr::mhp
@@ -20,6 +20,7 @@
 #include <dr/detail/logger.hpp>
 #include <dr/detail/onedpl_direct_iterator.hpp>
 #include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/algorithms/binary_search.hpp>
 #include <dr/mhp/global.hpp>
 
 namespace dr::mhp {
@@ -300,6 +301,9 @@ void sort(R &r, Compare &&comp = Compare()) {
     __detail::dist_sort(r, comp);
     dr::mhp::barrier();
   }
+
+  // Searches on the sorted range start on the right rank
+  __detail::cache_bounds(r);
 }
 
 template <dr::distributed_iterator RandomIt, typename Compare = std::less<>>
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <tuple>
+
+#include <dr/detail/logger.hpp>
+#include <dr/detail/mdspan_shim.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/detail/utils.hpp>
+#include <dr/mhp/algorithms/md_for_each.hpp>
+#include <dr/mhp/containers/distributed_mdarray.hpp>
+#include <dr/mhp/containers/mdarray_tiles.hpp>
+#include <dr/mhp/global.hpp>
+#include <dr/mhp/halo.hpp>
+#include <dr/mhp/sycl_support.hpp>
+
+namespace dr::mhp::__detail {
+
+// Cost of a halo exchange, in stencil point updates. With a halo of
+// depth k, a step pays 1/k of an exchange and redundantly updates
+// about (k - 1) * radius * columns ghost points, which is smallest
+// for k = sqrt(exchange / (radius * columns)).
+inline constexpr std::size_t stencil_exchange_points = 1 << 16;
+
+// Steps between halo exchanges chosen by the cost model
+inline std::size_t temporal_depth(std::size_t columns, std::size_t radius,
+                                  std::size_t max_depth) {
+  double k = std::sqrt(double(stencil_exchange_points) /
+                       double(std::max(radius * columns, std::size_t(1))));
+  return std::clamp(std::size_t(k), std::size_t(1), max_depth);
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective. Applies a stencil of radius radius for steps steps,
+/// alternating between a and b, and returns the array that holds the
+/// result: a if steps is even, else b. op is called like the op of
+/// stencil_for_each with a tuple of 2 mdspans, (in, out), centered on
+/// the point. Points within radius of the edge of the array are not
+/// updated.
+///
+/// The halo is exchanged once every depth steps instead of every
+/// step. After an exchange, the steps before the next one also update
+/// the ghost rows that the following steps read, so the region that is
+/// updated shrinks by radius rows per step. a and b need a halo of at
+/// least depth * radius rows, and no more rows than a tile. If depth
+/// is 0, it is chosen by a cost model, limited by the halo.
+template <typename T, typename F>
+distributed_mdarray<T, 2> &
+temporal_stencil(F op, distributed_mdarray<T, 2> &a,
+                 distributed_mdarray<T, 2> &b, std::size_t steps,
+                 std::size_t radius = 1, std::size_t depth = 0) {
+  std::size_t rows = a.extent(0), columns = a.extent(1);
+  assert(b.extent(0) == rows && b.extent(1) == columns);
+  assert(radius > 0);
+
+  // The halo is in elements, the stencil needs rows
+  auto hb = halo(a).bounds();
+  std::size_t halo_rows = std::min(hb.prev, hb.next) / columns;
+  assert(halo_rows == std::min(halo(b).bounds().prev, halo(b).bounds().next) /
+                          columns);
+  std::size_t max_depth = halo_rows / radius;
+  assert(max_depth > 0);
+  if (depth == 0) {
+    depth = __detail::temporal_depth(columns, radius, max_depth);
+  }
+  assert(depth <= max_depth);
+
+  std::size_t rank = default_comm().rank();
+  std::size_t nprocs = default_comm().size(); // dr-style ignore
+  std::size_t tile = dr::__detail::partition_up(rows, nprocs);
+  assert(halo_rows <= tile);
+  std::size_t first_row = std::min(rank * tile, rows);
+  std::size_t local_rows = __detail::tile_rows(rows, tile, rank);
+  dr::drlog.debug("temporal stencil: steps: {} radius: {} depth: {} local "
+                  "rows: {}\n",
+                  steps, radius, depth, local_rows);
+
+  T *in = __detail::local_tile_pointer<T>(a.view());
+  T *out = __detail::local_tile_pointer<T>(b.view());
+  std::array<std::size_t, 2> extents{rows, columns};
+
+  // Rows relative to the tile can be negative in the halo
+  using signed_type = std::ptrdiff_t;
+  signed_type lowest = signed_type(radius) - signed_type(first_row);
+  signed_type highest =
+      signed_type(rows) - signed_type(radius) - signed_type(first_row);
+
+  for (std::size_t step = 0; step < steps; step++) {
+    if (step == 0 && depth > 1) {
+      // The ghost rows of b are read before they are exchanged. Their
+      // points near the edge of the array are never updated, so they
+      // need the values from the neighbors.
+      halo_group(halo(a), halo(b)).exchange();
+    } else if (step % depth == 0) {
+      halo(step % 2 ? b : a).exchange();
+    }
+
+    // Ghost rows still needed by the steps before the next exchange
+    std::size_t later = std::min(depth - 1 - step % depth, steps - 1 - step);
+    signed_type ghost = signed_type(later * radius);
+    signed_type first = std::max(-ghost, lowest);
+    signed_type last = std::min(signed_type(local_rows) + ghost, highest);
+
+    if (in != nullptr && first < last && columns > 2 * radius) {
+      std::size_t height = last - first, width = columns - 2 * radius;
+      T *in_origin = in + first * signed_type(columns) + radius;
+      T *out_origin = out + first * signed_type(columns) + radius;
+      auto do_point = [=](auto index) {
+        std::size_t offset = index[0] * columns + index[1];
+        op(std::tuple(md::mdspan(in_origin + offset, extents),
+                      md::mdspan(out_origin + offset, extents)));
+      };
+
+      if (mhp::use_sycl()) {
+#ifdef SYCL_LANGUAGE_VERSION
+        dr::__detail::parallel_for(mhp::sycl_queue(),
+                                   sycl::range(height, width), do_point)
+            .wait();
+#else
+        assert(false);
+#endif
+      } else {
+        // Tiled and threaded, like stencil_for_each
+        auto do_run = [=](auto index, std::size_t n) {
+          for (std::size_t j = 0; j < n; j++) {
+            do_point(std::array<std::size_t, 2>{index[0], index[1] + j});
+          }
+        };
+        __detail::md_for_each_rows(
+            dr::__detail::md_extents<2>(height, width), do_run);
+      }
+    }
+    std::swap(in, out);
+  }
+
+  barrier();
+  return steps % 2 ? b : a;
+}
+
+} // namespace dr::mhp
@@ -0,0 +1,231 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <optional>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/onedpl_direct_iterator.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/detail/utils.hpp>
+#include <dr/mhp/global.hpp>
+
+namespace dr::mhp::__detail {
+
+// Independent accumulators in a chunk. With 1, every step waits for
+// the previous one. With several, the steps overlap and the compiler
+// can keep the accumulators in a vector register.
+inline constexpr std::size_t reduce_accumulators = 8;
+// Elements reduced by one task
+inline constexpr std::size_t reduce_chunk = 1 << 14;
+
+// Reduce elements [0, n) of the transformed iterators, n > 0
+template <typename T, typename R, typename F, typename... Iters>
+T chunk_transform_reduce(std::size_t n, R &reduce_op, F &transform_op,
+                         Iters... first) {
+  auto at = [&](std::size_t i) { return T(transform_op(first[i]...)); };
+  constexpr std::size_t k = reduce_accumulators;
+  if (n < k) {
+    T sum = at(0);
+    for (std::size_t i = 1; i < n; i++) {
+      sum = reduce_op(sum, at(i));
+    }
+    return sum;
+  }
+
+  auto acc = [&]<std::size_t... j>(std::index_sequence<j...>) {
+    return std::array<T, k>{at(j)...};
+  }(std::make_index_sequence<k>{});
+  std::size_t i = k;
+  for (; i + k <= n; i += k) {
+    for (std::size_t j = 0; j < k; j++) {
+      acc[j] = reduce_op(acc[j], at(i + j));
+    }
+  }
+  for (; i < n; i++) {
+    acc[0] = reduce_op(acc[0], at(i));
+  }
+  for (std::size_t j = 1; j < k; j++) {
+    acc[0] = reduce_op(acc[0], acc[j]);
+  }
+  return acc[0];
+}
+
+// Reduce n > 0 transformed elements on the CPU, a chunk per task
+template <typename T, typename R, typename F, typename... Iters>
+T cpu_transform_reduce(std::size_t n, R &reduce_op, F &transform_op,
+                       Iters... first) {
+  std::size_t chunks = dr::__detail::partition_up(n, reduce_chunk);
+  std::vector<T> partials(chunks);
+  std::vector<std::size_t> ids(chunks);
+  std::iota(ids.begin(), ids.end(), 0);
+  std::for_each(std::execution::par_unseq, ids.begin(), ids.end(),
+                [&](std::size_t c) {
+                  std::size_t offset = c * reduce_chunk;
+                  partials[c] = chunk_transform_reduce<T>(
+                      std::min(reduce_chunk, n - offset), reduce_op,
+                      transform_op, (first + offset)...);
+                });
+
+  T sum = partials[0];
+  for (std::size_t c = 1; c < chunks; c++) {
+    sum = reduce_op(sum, partials[c]);
+  }
+  return sum;
+}
+
+// Raw pointers for contiguous segments, so the kernel vectorizes
+inline auto segment_begin(auto &&segment) {
+  if constexpr (rng::contiguous_range<decltype(segment)>) {
+    return rng::data(segment);
+  } else {
+    return rng::begin(segment);
+  }
+}
+
+// Reduce the transformed elements of a local segment, and the aligned
+// segment of the second range for the binary form
+template <typename T, typename R, typename F, typename S, typename... Ss>
+T segment_transform_reduce(R &reduce_op, F &transform_op, S &&segment,
+                           Ss &&...segments) {
+  std::size_t n = rng::distance(segment);
+  assert(n > 0);
+  if (mhp::use_sycl()) {
+    dr::drlog.debug("  with DPL\n");
+#ifdef SYCL_LANGUAGE_VERSION
+    // Peel the first element for the init
+    T first = transform_op(sycl_get(*rng::begin(segment)),
+                           sycl_get(*rng::begin(segments))...);
+    auto begin = dr::__detail::direct_iterator(rng::begin(segment));
+    return std::transform_reduce(
+        dpl_policy(), begin + 1, begin + n,
+        (dr::__detail::direct_iterator(rng::begin(segments)) + 1)..., first,
+        reduce_op, transform_op);
+#else
+    assert(false);
+    return T{};
+#endif
+  } else {
+    dr::drlog.debug("  with CPU\n");
+    return cpu_transform_reduce<T>(n, reduce_op, transform_op,
+                                   segment_begin(segment),
+                                   segment_begin(segments)...);
+  }
+}
+
+// Every rank gets init combined with the partial results of the ranks
+// that have local elements, with one collective
+template <typename T, typename R>
+T combine_ranks(const std::optional<T> &local, T init, R &reduce_op) {
+  struct partial {
+    T value;
+    bool valid;
+  };
+  auto comm = default_comm();
+  std::vector<partial> all(comm.size()); // dr-style ignore
+  comm.all_gather(partial{local.value_or(init), local.has_value()}, all);
+  for (auto &p : all) {
+    if (p.valid) {
+      init = reduce_op(init, p.value);
+    }
+  }
+  return init;
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective. Reduces transform_op(x) over the elements x of r with
+/// reduce_op, starting with init. Like std::transform_reduce,
+/// reduce_op must be associative and commutative. Local segments
+/// are reduced with several accumulators, on raw pointers when they
+/// are contiguous.
+template <dr::distributed_range DR, typename T, typename R, typename F>
+T transform_reduce(DR &&r, T init, R reduce_op, F transform_op) {
+  if (rng::empty(r)) {
+    return init;
+  }
+  assert(aligned(r));
+  dr::drlog.debug("transform_reduce\n");
+
+  std::optional<T> local;
+  for (auto &&s : local_segments(r)) {
+    if (rng::empty(s)) {
+      continue;
+    }
+    T partial =
+        __detail::segment_transform_reduce<T>(reduce_op, transform_op, s);
+    local = local ? T(reduce_op(*local, partial)) : partial;
+  }
+  return __detail::combine_ranks(local, init, reduce_op);
+}
+
+/// Collective. Reduces transform_op(x, y) over the pairs of elements
+/// of r1 and r2 with reduce_op, starting with init. r1 and r2 must be
+/// aligned.
+template <dr::distributed_range DR1, dr::distributed_range DR2, typename T,
+          typename R, typename F>
+T transform_reduce(DR1 &&r1, DR2 &&r2, T init, R reduce_op, F transform_op) {
+  if (rng::empty(r1)) {
+    return init;
+  }
+  assert(aligned(r1, r2));
+  dr::drlog.debug("transform_reduce: binary\n");
+
+  std::optional<T> local;
+  auto segments2 = local_segments(r2);
+  auto s2 = rng::begin(segments2);
+  for (auto &&s1 : local_segments(r1)) {
+    auto &&segment2 = *s2++;
+    if (rng::empty(s1)) {
+      continue;
+    }
+    T partial = __detail::segment_transform_reduce<T>(reduce_op, transform_op,
+                                                      s1, segment2);
+    local = local ? T(reduce_op(*local, partial)) : partial;
+  }
+  return __detail::combine_ranks(local, init, reduce_op);
+}
+
+/// Collective inner product of r1 and r2, plus init
+template <dr::distributed_range DR1, dr::distributed_range DR2, typename T>
+T transform_reduce(DR1 &&r1, DR2 &&r2, T init) {
+  return mhp::transform_reduce(std::forward<DR1>(r1), std::forward<DR2>(r2),
+                               init, std::plus<>(), std::multiplies<>());
+}
+
+/// Collective. Computes several reductions of transform_op(x) in one
+/// pass over r and one collective. init and reduce_ops have an element
+/// for each reduction, and element i of the result is the reduction
+/// with reduce op i, starting with init i.
+template <dr::distributed_range DR, typename... T, typename... R, typename F>
+std::tuple<T...> transform_reduce(DR &&r, std::tuple<T...> init,
+                                  std::tuple<R...> reduce_ops, F transform_op) {
+  static_assert(sizeof...(T) == sizeof...(R));
+  auto reduce_all = [reduce_ops](const auto &a, const auto &b) {
+    return [&]<std::size_t... i>(std::index_sequence<i...>) {
+      return std::tuple<T...>(
+          std::get<i>(reduce_ops)(std::get<i>(a), std::get<i>(b))...);
+    }(std::index_sequence_for<T...>{});
+  };
+  auto transform_all = [transform_op](auto &&x) {
+    auto value = transform_op(x);
+    return std::tuple<T...>(T(value)...);
+  };
+  return mhp::transform_reduce(std::forward<DR>(r), init, reduce_all,
+                               transform_all);
+}
+
+} // namespace dr::mhp
@@ -0,0 +1,138 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <numeric>
+#include <vector>
+
+#include <dr/detail/communicator.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/containers/distributed_mdarray.hpp>
+#include <dr/mhp/containers/mdarray_tiles.hpp>
+#include <dr/mhp/global.hpp>
+#include <dr/mhp/sycl_support.hpp>
+
+namespace dr::mhp::__detail {
+
+// Tiles at most this many elements are transposed with a simple loop
+inline constexpr std::size_t transpose_leaf = 256;
+// Columns of the local tile handled by one task
+inline constexpr std::size_t transpose_chunk = 128;
+
+// dst(j, i) = src(i, j) for a rows x cols tile. Splits the longer
+// dimension in half until the tile fits in cache, without knowing the
+// cache size.
+template <typename T>
+void transpose_tile(const T *src, std::size_t src_stride, T *dst,
+                    std::size_t dst_stride, std::size_t rows,
+                    std::size_t cols) {
+  if (rows * cols <= transpose_leaf || rows == 1 || cols == 1) {
+    for (std::size_t i = 0; i < rows; i++) {
+      for (std::size_t j = 0; j < cols; j++) {
+        dst[j * dst_stride + i] = src[i * src_stride + j];
+      }
+    }
+  } else if (rows >= cols) {
+    std::size_t half = rows / 2;
+    transpose_tile(src, src_stride, dst, dst_stride, half, cols);
+    transpose_tile(src + half * src_stride, src_stride, dst + half,
+                   dst_stride, rows - half, cols);
+  } else {
+    std::size_t half = cols / 2;
+    transpose_tile(src, src_stride, dst, dst_stride, rows, half);
+    transpose_tile(src + half, src_stride, dst + half * dst_stride,
+                   dst_stride, rows, cols - half);
+  }
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Collective transpose of a 2D distributed_mdarray. out must have the
+/// shape of in with the extents swapped, and must not alias in.
+///
+/// Every rank transposes its tile into a send buffer, so the block for
+/// each destination is contiguous, exchanges the blocks with one
+/// alltoall, and copies the received blocks into its tile of out.
+template <typename T>
+void transpose(distributed_mdarray<T, 2> &in, distributed_mdarray<T, 2> &out) {
+  std::size_t m = in.extent(0), n = in.extent(1);
+  assert(out.extent(0) == n && out.extent(1) == m);
+  auto comm = default_comm();
+  std::size_t ranks = comm.size();
+  std::size_t rank = comm.rank();
+
+  // in is distributed by tiles of in_tile rows, out by tiles of
+  // out_tile rows, which are out_tile columns of in
+  std::size_t in_tile = dr::__detail::partition_up(m, ranks);
+  std::size_t out_tile = dr::__detail::partition_up(n, ranks);
+  std::size_t my_rows = __detail::tile_rows(m, in_tile, rank);
+  std::size_t my_out_rows = __detail::tile_rows(n, out_tile, rank);
+  // Blocks are padded to the same size so a single alltoall can be
+  // used
+  std::size_t block = in_tile * out_tile;
+  dr::drlog.debug("transpose: {}x{} rows: {} block: {}\n", m, n, my_rows,
+                  block);
+
+  T *in_tile_ptr = __detail::local_tile_pointer<T>(in);
+  T *out_tile_ptr = __detail::local_tile_pointer<T>(out);
+
+  // The kernels run on the host, so device tiles are staged
+  std::vector<T> in_host, out_host;
+  if (mhp::use_sycl()) {
+    in_host.resize(my_rows * n);
+    out_host.resize(my_out_rows * m);
+    __detail::sycl_copy(in_tile_ptr, in_tile_ptr + my_rows * n,
+                        in_host.data());
+    in_tile_ptr = in_host.data();
+  }
+  T *out_ptr = mhp::use_sycl() ? out_host.data() : out_tile_ptr;
+
+  // Column j of in goes to rank j / out_tile, and row j % out_tile of
+  // its block. The send buffer is the transpose of the local tile,
+  // stored with a row stride of in_tile.
+  std::vector<T> send(ranks * block), receive(ranks * block);
+  std::vector<std::size_t> chunks(
+      dr::__detail::partition_up(n, __detail::transpose_chunk));
+  std::iota(chunks.begin(), chunks.end(), 0);
+  std::for_each(std::execution::par_unseq, chunks.begin(), chunks.end(),
+                [=, s = send.data()](std::size_t c) {
+                  std::size_t first = c * __detail::transpose_chunk;
+                  std::size_t cols =
+                      std::min(__detail::transpose_chunk, n - first);
+                  __detail::transpose_tile(in_tile_ptr + first, n,
+                                           s + first * in_tile, in_tile,
+                                           my_rows, cols);
+                });
+
+  comm.alltoall(send, receive, block);
+
+  // Row i of the block from rank r is row i of out, starting at
+  // column r * in_tile
+  std::vector<std::size_t> out_rows(my_out_rows);
+  std::iota(out_rows.begin(), out_rows.end(), 0);
+  std::for_each(std::execution::par_unseq, out_rows.begin(), out_rows.end(),
+                [=, r = receive.data()](std::size_t i) {
+                  for (std::size_t source = 0; source < ranks; source++) {
+                    auto b = r + source * block + i * in_tile;
+                    std::copy(b,
+                              b + __detail::tile_rows(m, in_tile, source),
+                              out_ptr + i * m + source * in_tile);
+                  }
+                });
+
+  if (mhp::use_sycl()) {
+    __detail::sycl_copy(out_host.data(), out_host.data() + my_out_rows * m,
+                        out_tile_ptr);
+  }
+
+  barrier();
+}
+
+} // namespace dr::mhp
@@ -0,0 +1,148 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <vector>
+
+#include <dr/detail/communicator.hpp>
+#include <dr/detail/index.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/mdspan_shim.hpp>
+#include <dr/detail/utils.hpp>
+#include <dr/mhp/global.hpp>
+
+namespace dr::mhp {
+
+namespace tile {
+
+// Special constant to indicate tile dimensions of
+// {ceil(m / p_m), ceil(n / p_n)} should be chosen, which is a block
+// distribution over the process grid
+inline constexpr std::size_t div = std::numeric_limits<std::size_t>::max();
+
+} // namespace tile
+
+} // namespace dr::mhp
+
+namespace dr::mhp::__detail {
+
+// Number of rows (or columns) of a matrix dimension that are stored at
+// coordinate coord of a process grid dimension with procs processes,
+// when tiles of size tile are dealt out cyclically
+inline std::size_t local_extent(std::size_t extent, std::size_t tile,
+                                std::size_t procs, std::size_t coord) {
+  std::size_t tiles = dr::__detail::partition_up(extent, tile);
+  if (coord >= tiles) {
+    return 0;
+  }
+  std::size_t local_tiles = (tiles - coord - 1) / procs + 1;
+  std::size_t local = local_tiles * tile;
+  // Only the last tile can be partial
+  if ((tiles - 1) % procs == coord) {
+    local -= tiles * tile - extent;
+  }
+  return local;
+}
+
+// Global row (or column) of local row (or column) i
+inline std::size_t global_offset(std::size_t i, std::size_t tile,
+                                 std::size_t procs, std::size_t coord) {
+  return ((i / tile) * procs + coord) * tile + i % tile;
+}
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Dense matrix distributed block-cyclically over a 2D process grid.
+/// The matrix is divided into tiles, and tile (i, j) is stored on the
+/// process at (i % grid rows, j % grid columns). With the default tile
+/// shape, every process stores one tile.
+///
+/// A process stores all its tiles as a single row major local matrix,
+/// so a row of tiles along a grid row is contiguous.
+template <typename T> class distributed_dense_matrix {
+public:
+  using value_type = T;
+  using size_type = std::size_t;
+  using key_type = dr::index<>;
+
+  /// Collective constructor. The grid has grid_rows rows, or a shape
+  /// chosen by MPI_Dims_create if grid_rows is 0.
+  distributed_dense_matrix(key_type shape,
+                           key_type tile_shape = {tile::div, tile::div},
+                           std::size_t grid_rows = 0)
+      : shape_(shape), grid_(std::make_shared<dr::process_grid>(
+                           default_comm(), grid_rows)) {
+    key_type grid_shape = this->grid_shape();
+    auto resolve = [](std::size_t size, std::size_t extent,
+                      std::size_t procs) {
+      if (size == tile::div) {
+        size = dr::__detail::partition_up(extent, procs);
+      }
+      return std::max(size, std::size_t(1));
+    };
+    tile_shape_ = {resolve(tile_shape[0], shape_[0], grid_shape[0]),
+                   resolve(tile_shape[1], shape_[1], grid_shape[1])};
+
+    local_shape_ = {__detail::local_extent(shape_[0], tile_shape_[0],
+                                           grid_->rows(), grid_->row()),
+                    __detail::local_extent(shape_[1], tile_shape_[1],
+                                           grid_->columns(), grid_->column())};
+    local_.resize(local_shape_[0] * local_shape_[1]);
+    dr::drlog.debug("dense matrix: {}x{} tile: {}x{} grid: {}x{} local: "
+                    "{}x{}\n",
+                    shape_[0], shape_[1], tile_shape_[0], tile_shape_[1],
+                    grid_shape[0], grid_shape[1], local_shape_[0],
+                    local_shape_[1]);
+  }
+
+  size_type size() const { return shape_[0] * shape_[1]; }
+  key_type shape() const { return shape_; }
+  key_type tile_shape() const { return tile_shape_; }
+  /// Shape of the process grid
+  key_type grid_shape() const { return {grid_->rows(), grid_->columns()}; }
+  const dr::process_grid &grid() const { return *grid_; }
+
+  /// Rank that stores tile tile_index
+  std::size_t tile_rank(key_type tile_index) const {
+    return (tile_index[0] % grid_->rows()) * grid_->columns() +
+           tile_index[1] % grid_->columns();
+  }
+
+  /// Rank that stores element index
+  std::size_t rank(key_type index) const {
+    return tile_rank({index[0] / tile_shape_[0], index[1] / tile_shape_[1]});
+  }
+
+  /// Shape of the local matrix
+  key_type local_shape() const { return local_shape_; }
+  T *local_data() { return local_.data(); }
+  const T *local_data() const { return local_.data(); }
+  auto local_mdspan() {
+    return md::mdspan(local_.data(), local_shape_[0], local_shape_[1]);
+  }
+
+  /// Global index of element local_index of the local matrix
+  key_type global_index(key_type local_index) const {
+    return {__detail::global_offset(local_index[0], tile_shape_[0],
+                                    grid_->rows(), grid_->row()),
+            __detail::global_offset(local_index[1], tile_shape_[1],
+                                    grid_->columns(), grid_->column())};
+  }
+
+private:
+  key_type shape_;
+  key_type tile_shape_;
+  key_type local_shape_;
+  // Shared by copies, which use the same grid
+  std::shared_ptr<dr::process_grid> grid_;
+  std::vector<T> local_;
+};
+
+} // namespace dr::mhp
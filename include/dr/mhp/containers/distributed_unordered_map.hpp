@@ -0,0 +1,607 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <dr/detail/communicator.hpp>
+#include <dr/detail/normal_distributed_iterator.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/detail/segments_tools.hpp>
+#include <dr/mhp/global.hpp>
+
+namespace dr::mhp::__detail {
+
+// Scramble the bits of a hash. std::hash is the identity for integers,
+// and both the owner rank and the slot in the local table are taken
+// from the hash.
+inline std::uint64_t mix_hash(std::uint64_t h) {
+  h ^= h >> 30;
+  h *= 0xbf58476d1ce4e5b9ull;
+  h ^= h >> 27;
+  h *= 0x94d049bb133111ebull;
+  h ^= h >> 31;
+  return h;
+}
+
+//
+// Open addressing hash table with linear probing. Entries are stored
+// densely in insertion order, so the table can be iterated as a
+// contiguous range. The slots hold the upper 32 bits of the hash and
+// the position of the entry, which keeps probing in a small array and
+// avoids touching the entries for most mismatches.
+//
+// Erase uses backward shift deletion, so there are no tombstones. The
+// last entry is moved into the hole to keep the entries dense.
+//
+// The table is only accessed on the host, so the entries are in host
+// memory, also when the rest of mhp uses device memory.
+//
+template <typename K, typename V, typename Hash> class flat_hash_table {
+public:
+  using value_type = std::pair<K, V>;
+
+  flat_hash_table(Hash hash = Hash()) : hash_(hash) {}
+
+  // Destructor frees entries, so cannot copy
+  flat_hash_table(const flat_hash_table &) = delete;
+  flat_hash_table &operator=(const flat_hash_table &) = delete;
+
+  ~flat_hash_table() {
+    clear();
+    std::allocator<value_type>().deallocate(entries_, capacity_);
+  }
+
+  std::size_t size() const { return size_; }
+  value_type *data() const { return entries_; }
+
+  std::uint64_t hash(const K &key) const { return mix_hash(hash_(key)); }
+  Hash hash_function() const { return hash_; }
+
+  value_type *find(const K &key, std::uint64_t h) const {
+    if (rng::empty(slots_)) {
+      return nullptr;
+    }
+    for (auto s = home(h);; s = next(s)) {
+      auto &slot = slots_[s];
+      if (slot.index == empty) {
+        return nullptr;
+      }
+      if (slot.fingerprint == fingerprint(h) &&
+          entries_[slot.index].first == key) {
+        return entries_ + slot.index;
+      }
+    }
+  }
+
+  // Insert key with value if not present. Returns the entry and true if
+  // it was inserted.
+  std::pair<value_type *, bool> try_emplace(const K &key, std::uint64_t h,
+                                            const V &value) {
+    if (auto entry = find(key, h)) {
+      return {entry, false};
+    }
+    reserve(size_ + 1);
+    auto s = home(h);
+    while (slots_[s].index != empty) {
+      s = next(s);
+    }
+    assert(size_ < empty);
+    slots_[s] = {fingerprint(h), std::uint32_t(size_)};
+    std::construct_at(entries_ + size_, key, value);
+    return {entries_ + size_++, true};
+  }
+
+  bool erase(const K &key, std::uint64_t h) {
+    auto entry = find(key, h);
+    if (entry == nullptr) {
+      return false;
+    }
+    std::size_t index = entry - entries_;
+    remove_slot(slot_of(index, h));
+
+    // Move the last entry into the hole
+    std::size_t last = size_ - 1;
+    if (index != last) {
+      slots_[slot_of(last, hash(entries_[last].first))].index = index;
+      entries_[index] = std::move(entries_[last]);
+    }
+    std::destroy_at(entries_ + last);
+    size_--;
+    return true;
+  }
+
+  // Make room for n entries
+  void reserve(std::size_t n) {
+    if (n > capacity_) {
+      grow_entries(std::max(n, 2 * capacity_));
+    }
+    if (n * max_load_denominator > rng::size(slots_) * max_load_numerator) {
+      rehash(std::bit_ceil(std::max(min_slots, n * max_load_denominator /
+                                                   max_load_numerator +
+                                               1)));
+    }
+  }
+
+  void clear() {
+    std::destroy(entries_, entries_ + size_);
+    size_ = 0;
+    std::fill(slots_.begin(), slots_.end(), slot{0, empty});
+  }
+
+private:
+  struct slot {
+    std::uint32_t fingerprint;
+    std::uint32_t index;
+  };
+  static constexpr std::uint32_t empty =
+      std::numeric_limits<std::uint32_t>::max();
+  static constexpr std::size_t min_slots = 16;
+  // Linear probing degrades quickly above 3/4 full
+  static constexpr std::size_t max_load_numerator = 3;
+  static constexpr std::size_t max_load_denominator = 4;
+
+  static std::uint32_t fingerprint(std::uint64_t h) { return h >> 32; }
+
+  // The home slot is the top bits of the fingerprint, so it can be
+  // recomputed from the slot when entries are shifted
+  std::size_t home(std::uint64_t h) const { return home_of(fingerprint(h)); }
+  std::size_t home_of(std::uint32_t fp) const {
+    return std::size_t(fp) >> shift_;
+  }
+  std::size_t next(std::size_t s) const {
+    return (s + 1) & (rng::size(slots_) - 1);
+  }
+
+  std::size_t slot_of(std::size_t index, std::uint64_t h) const {
+    auto s = home(h);
+    while (slots_[s].index != index) {
+      s = next(s);
+    }
+    return s;
+  }
+
+  void remove_slot(std::size_t hole) {
+    auto mask = rng::size(slots_) - 1;
+    for (auto s = next(hole); slots_[s].index != empty; s = next(s)) {
+      // Shift back unless the entry would move before its home
+      auto distance = (s - home_of(slots_[s].fingerprint)) & mask;
+      if (((s - hole) & mask) <= distance) {
+        slots_[hole] = slots_[s];
+        hole = s;
+      }
+    }
+    slots_[hole].index = empty;
+  }
+
+  void grow_entries(std::size_t capacity) {
+    auto entries = std::allocator<value_type>().allocate(capacity);
+    std::uninitialized_move(entries_, entries_ + size_, entries);
+    std::destroy(entries_, entries_ + size_);
+    std::allocator<value_type>().deallocate(entries_, capacity_);
+    entries_ = entries;
+    capacity_ = capacity;
+  }
+
+  void rehash(std::size_t nslots) {
+    assert(nslots <= std::size_t(empty));
+    slots_.assign(nslots, slot{0, empty});
+    shift_ = 32 - std::countr_zero(nslots);
+    for (std::size_t i = 0; i < size_; i++) {
+      auto h = hash(entries_[i].first);
+      auto s = home(h);
+      while (slots_[s].index != empty) {
+        s = next(s);
+      }
+      slots_[s] = {fingerprint(h), std::uint32_t(i)};
+    }
+  }
+
+  Hash hash_;
+  std::vector<slot> slots_;
+  std::size_t shift_ = 32;
+  value_type *entries_ = nullptr;
+  std::size_t size_ = 0;
+  std::size_t capacity_ = 0;
+};
+
+//
+// Sends items to their owner ranks with alltoallv, and replies back
+// in the original order
+//
+struct owner_exchange {
+  // For each slot in the send buffer, the position of the item in the
+  // caller's batch
+  std::vector<std::size_t> positions;
+  std::vector<std::size_t> send_counts, send_displs;
+  std::vector<std::size_t> recv_counts, recv_displs;
+
+  owner_exchange(communicator comm, const std::vector<std::size_t> &owners) {
+    std::size_t nranks = comm.size();
+    send_counts.assign(nranks, 0);
+    for (auto owner : owners) {
+      send_counts[owner]++;
+    }
+    send_displs = displacements(send_counts);
+
+    // Counting sort by owner
+    positions.resize(rng::size(owners));
+    auto next = send_displs;
+    for (std::size_t i = 0; i < rng::size(owners); i++) {
+      positions[next[owners[i]]++] = i;
+    }
+
+    recv_counts.resize(nranks);
+    comm.alltoall(send_counts, recv_counts, 1);
+    recv_displs = displacements(recv_counts);
+  }
+
+  std::size_t received() const {
+    return rng::empty(recv_counts) ? 0
+                                   : recv_displs.back() + recv_counts.back();
+  }
+
+  // Send items to the owners. Items are received grouped by source rank,
+  // in the order they were passed.
+  template <typename T>
+  std::vector<T> forward(communicator comm,
+                         rng::random_access_range auto &&items) {
+    std::vector<T> send(rng::size(positions)), recv(received());
+    for (std::size_t i = 0; i < rng::size(positions); i++) {
+      send[i] = items[positions[i]];
+    }
+    comm.alltoallv(send, send_counts, send_displs, recv, recv_counts,
+                   recv_displs);
+    return recv;
+  }
+
+  // Reply to forwarded items. Replies are in the order of the items
+  // passed to the constructor.
+  template <typename T>
+  std::vector<T> respond(communicator comm, const std::vector<T> &replies) {
+    std::vector<T> recv(rng::size(positions)), result(rng::size(positions));
+    comm.alltoallv(replies, recv_counts, recv_displs, recv, send_counts,
+                   send_displs);
+    for (std::size_t i = 0; i < rng::size(positions); i++) {
+      result[positions[i]] = recv[i];
+    }
+    return result;
+  }
+
+private:
+  static std::vector<std::size_t>
+  displacements(const std::vector<std::size_t> &counts) {
+    std::vector<std::size_t> displs(rng::size(counts));
+    std::exclusive_scan(counts.begin(), counts.end(), displs.begin(),
+                        std::size_t(0));
+    return displs;
+  }
+};
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+template <typename DM> class dum_segment_iterator {
+public:
+  using value_type = typename DM::value_type;
+  using difference_type = typename DM::difference_type;
+
+  dum_segment_iterator() = default;
+  dum_segment_iterator(DM *dm, std::size_t segment_index, std::size_t rank,
+                       std::size_t index)
+      : dm_(dm), segment_index_(segment_index), rank_(rank), index_(index) {}
+
+  auto operator<=>(const dum_segment_iterator &other) const noexcept {
+    assert(dm_ == other.dm_);
+    return segment_index_ == other.segment_index_
+               ? index_ <=> other.index_
+               : segment_index_ <=> other.segment_index_;
+  }
+  bool operator==(const dum_segment_iterator &other) const noexcept {
+    return (*this <=> other) == 0;
+  }
+
+  auto &operator+=(difference_type n) {
+    assert(dm_ != nullptr);
+    index_ += n;
+    return *this;
+  }
+  auto &operator-=(difference_type n) { return *this += (-n); }
+  difference_type operator-(const dum_segment_iterator &other) const noexcept {
+    assert(dm_ != nullptr && dm_ == other.dm_);
+    return difference_type(index_) - difference_type(other.index_);
+  }
+
+  auto &operator++() { return *this += 1; }
+  auto &operator--() { return *this -= 1; }
+  auto operator++(int) {
+    auto prev = *this;
+    *this += 1;
+    return prev;
+  }
+  auto operator--(int) {
+    auto prev = *this;
+    *this -= 1;
+    return prev;
+  }
+  auto operator+(difference_type n) const {
+    auto p = *this;
+    p += n;
+    return p;
+  }
+  auto operator-(difference_type n) const {
+    auto p = *this;
+    p -= n;
+    return p;
+  }
+  friend auto operator+(difference_type n, const dum_segment_iterator &other) {
+    return other + n;
+  }
+
+  // Only entries on this rank can be dereferenced. Use find() for
+  // remote keys.
+  value_type &operator*() const { return *local(); }
+  value_type &operator[](difference_type n) const { return *(*this + n); }
+
+  auto rank() const {
+    assert(dm_ != nullptr);
+    return rank_;
+  }
+
+  value_type *local() const {
+    assert(dm_ != nullptr);
+    assert(rank_ == default_comm().rank()); // trying to read non-owned memory
+    return dm_->table_.data() + index_;
+  }
+
+  auto segments() const {
+    assert(dm_ != nullptr);
+    return dr::__detail::drop_segments(dm_->segments(), segment_index_,
+                                       index_);
+  }
+
+private:
+  DM *dm_ = nullptr;
+  std::size_t segment_index_ = 0;
+  std::size_t rank_ = 0;
+  std::size_t index_ = 0;
+}; // dum_segment_iterator
+
+template <typename DM> class dum_segment {
+private:
+  using iterator = dum_segment_iterator<DM>;
+
+public:
+  using difference_type = std::ptrdiff_t;
+  dum_segment() = default;
+  dum_segment(DM *dm, std::size_t segment_index, std::size_t rank,
+              std::size_t size)
+      : dm_(dm), segment_index_(segment_index), rank_(rank), size_(size) {
+    assert(dm_ != nullptr);
+  }
+
+  auto size() const { return size_; }
+
+  auto begin() const { return iterator(dm_, segment_index_, rank_, 0); }
+  auto end() const { return begin() + size(); }
+
+  auto &operator[](difference_type n) const { return *(begin() + n); }
+
+  bool is_local() const { return rank_ == default_comm().rank(); }
+
+private:
+  DM *dm_ = nullptr;
+  std::size_t segment_index_ = 0;
+  std::size_t rank_ = 0;
+  std::size_t size_ = 0;
+}; // dum_segment
+
+/// Distributed hash map. Keys are assigned to ranks by hash. Every
+/// rank stores its keys in an open addressing table with the entries
+/// in flat storage. Each local table is a segment, so algorithms like
+/// for_each and reduce work on the entries of the map.
+///
+/// Updates and lookups are collective and take a batch of keys from
+/// every rank. Keys and values are sent as bytes, so they must be
+/// trivially copyable.
+template <typename K, typename V, typename Hash = std::hash<K>>
+class distributed_unordered_map {
+  static_assert(std::is_trivially_copyable_v<K> &&
+                std::is_trivially_copyable_v<V>);
+
+public:
+  using key_type = K;
+  using mapped_type = V;
+  using value_type = std::pair<K, V>;
+  using size_type = std::size_t;
+  using difference_type = std::ptrdiff_t;
+  using hasher = Hash;
+
+private:
+  using segment_type = dum_segment<distributed_unordered_map>;
+  using segments_type = rng::views::all_t<const std::vector<segment_type> &>;
+
+public:
+  using iterator = dr::normal_distributed_iterator<segments_type>;
+
+  // Segments point to the map, so cannot copy or move
+  distributed_unordered_map(const distributed_unordered_map &) = delete;
+  distributed_unordered_map &
+  operator=(const distributed_unordered_map &) = delete;
+
+  /// Constructor
+  distributed_unordered_map(Hash hash = Hash()) : table_(hash) {}
+
+  /// Returns iterator to beginning
+  auto begin() const { return iterator(segments(), 0, 0); }
+  /// Returns iterator to end
+  auto end() const { return iterator(segments(), rng::size(segments_), 0); }
+
+  /// Returns number of entries on all ranks
+  auto size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  /// Returns segments, one for every rank that has entries
+  auto segments() const { return rng::views::all(segments_); }
+
+  /// Rank that owns key
+  std::size_t rank(const K &key) const {
+    return owner(table_.hash(key));
+  }
+
+  /// Collective insert. Every rank passes a range of key/value pairs.
+  /// Keys that are already in the map keep their value. For a key
+  /// inserted by several ranks, the value from the lowest rank is used.
+  void insert(rng::forward_range auto &&pairs) {
+    auto received = exchange_pairs(pairs);
+    for (auto &[key, value] : received) {
+      table_.try_emplace(key, table_.hash(key), value);
+    }
+    update_segments();
+  }
+
+  /// Collective insert or update. For keys in the map, the value
+  /// becomes op(value, v), otherwise v is inserted. op must be
+  /// associative and commutative. Updates for the same key are
+  /// combined before they are sent.
+  void upsert(rng::forward_range auto &&pairs, auto &&op) {
+    __detail::flat_hash_table<K, V, Hash> combined(table_.hash_function());
+    combined.reserve(rng::distance(pairs));
+    for (auto &&[key, value] : pairs) {
+      auto [entry, inserted] =
+          combined.try_emplace(key, combined.hash(key), value);
+      if (!inserted) {
+        entry->second = op(entry->second, value);
+      }
+    }
+
+    auto received = exchange_pairs(
+        rng::subrange(combined.data(), combined.data() + rng::size(combined)));
+    table_.reserve(rng::size(table_) + rng::size(received));
+    for (auto &[key, value] : received) {
+      auto [entry, inserted] = table_.try_emplace(key, table_.hash(key), value);
+      if (!inserted) {
+        entry->second = op(entry->second, value);
+      }
+    }
+    update_segments();
+  }
+
+  /// Collective lookup. Every rank passes a range of keys, and receives
+  /// the value for each key, or nullopt if the key is not in the map.
+  std::vector<std::optional<V>> find(rng::forward_range auto &&keys) {
+    struct reply {
+      V value;
+      bool found;
+    };
+
+    auto [exchange, received] = exchange_keys(keys);
+    std::vector<reply> replies(rng::size(received));
+    for (std::size_t i = 0; i < rng::size(received); i++) {
+      auto &key = received[i];
+      if (auto entry = table_.find(key, table_.hash(key))) {
+        replies[i] = {entry->second, true};
+      } else {
+        replies[i] = {V{}, false};
+      }
+    }
+
+    auto comm = default_comm();
+    auto answers = exchange.respond(comm, replies);
+    std::vector<std::optional<V>> result(rng::size(answers));
+    for (std::size_t i = 0; i < rng::size(answers); i++) {
+      if (answers[i].found) {
+        result[i] = answers[i].value;
+      }
+    }
+    return result;
+  }
+
+  /// Collective erase. Every rank passes a range of keys. Returns the
+  /// number of entries erased on all ranks.
+  std::size_t erase(rng::forward_range auto &&keys) {
+    auto [exchange, received] = exchange_keys(keys);
+    std::size_t erased = 0;
+    for (auto &key : received) {
+      erased += table_.erase(key, table_.hash(key));
+    }
+    update_segments();
+    return default_comm().all_reduce(erased, MPI_SUM);
+  }
+
+  /// Collective. Remove all entries.
+  void clear() {
+    table_.clear();
+    update_segments();
+  }
+
+private:
+  std::size_t owner(std::uint64_t h) const {
+    return h % default_comm().size(); // dr-style ignore
+  }
+
+  auto owners(rng::forward_range auto &&keys) const {
+    std::vector<std::size_t> result;
+    for (auto &&key : keys) {
+      result.push_back(owner(table_.hash(key)));
+    }
+    return result;
+  }
+
+  std::vector<value_type> exchange_pairs(rng::forward_range auto &&pairs) {
+    auto comm = default_comm();
+    std::vector<value_type> items;
+    std::vector<std::size_t> item_owners;
+    for (auto &&[key, value] : pairs) {
+      items.emplace_back(key, value);
+      item_owners.push_back(owner(table_.hash(key)));
+    }
+    __detail::owner_exchange exchange(comm, item_owners);
+    return exchange.forward<value_type>(comm, items);
+  }
+
+  auto exchange_keys(rng::forward_range auto &&keys) {
+    auto comm = default_comm();
+    std::vector<K> items(rng::begin(keys), rng::end(keys));
+    __detail::owner_exchange exchange(comm, owners(items));
+    auto received = exchange.forward<K>(comm, items);
+    return std::pair(std::move(exchange), std::move(received));
+  }
+
+  // Every rank needs the size of every segment
+  void update_segments() {
+    auto comm = default_comm();
+    std::vector<std::size_t> sizes(comm.size());
+    comm.all_gather(rng::size(table_), sizes);
+
+    segments_.clear();
+    size_ = 0;
+    for (std::size_t rank = 0; rank < rng::size(sizes); rank++) {
+      if (sizes[rank] > 0) {
+        segments_.emplace_back(this, rng::size(segments_), rank, sizes[rank]);
+        size_ += sizes[rank];
+      }
+    }
+  }
+
+  friend dum_segment_iterator<distributed_unordered_map>;
+
+  __detail::flat_hash_table<K, V, Hash> table_;
+  std::vector<segment_type> segments_;
+  std::size_t size_ = 0;
+};
+
+} // namespace dr::mhp
@@ -127,10 +127,16 @@ public:
 
   ~distributed_vector() {
     if (!finalized()) {
-      fence();
-      active_wins().erase(win_.mpi_win());
-      win_.free();
-      __detail::allocator<T>().deallocate(data_, data_size_);
+      if (pool_block_) {
+        // Pooled storage is reused after the next fence, no need to
+        // synchronize here
+        __detail::pool_release(*pool_block_);
+      } else {
+        fence();
+        active_wins().erase(win_.mpi_win());
+        win_.free();
+        __detail::allocator<T>().deallocate(data_, data_size_);
+      }
       data_ = nullptr;
       delete halo_;
     }
@@ -149,6 +155,15 @@ public:
 
   auto segments() const { return rng::views::all(segments_); }
 
+  /// Complete RMA targeting this vector. Collective. A fence covers a
+  /// whole MPI window, so for a vector in the window pool it also
+  /// completes RMA targeting the other vectors in the same pool window.
+  /// Other windows are not synchronized, unlike mhp::fence().
+  void fence() {
+    win_.fence();
+    active_wins().clear_dirty(win_.mpi_win());
+  }
+
 private:
   void init(auto size, auto dist) {
     size_ = size;
@@ -166,7 +181,13 @@ private:
                                      hb.prev / gran, hb.next / gran});
 
     data_size_ = segment_size_ + hb.prev + hb.next;
-    if (size_ > 0) {
+    // Device memory cannot come from the window pool
+    if (size_ > 0 && !mhp::use_sycl()) {
+      pool_block_ = __detail::pool_allocate(data_size_ * sizeof(T));
+    }
+    if (pool_block_) {
+      data_ = static_cast<T *>(pool_block_->data);
+    } else if (size_ > 0) {
       data_ = __detail::allocator<T>().allocate(data_size_);
     }
 
@@ -178,9 +199,13 @@ private:
                              std::min(segment_size_, size - i));
     }
 
-    win_.create(default_comm(), data_, data_size_ * sizeof(T));
-    active_wins().insert(win_.mpi_win());
-    fence();
+    if (pool_block_) {
+      win_ = pool_block_->win;
+    } else {
+      win_.create(default_comm(), data_, data_size_ * sizeof(T));
+      active_wins().insert(win_.mpi_win());
+      fence();
+    }
   }
 
   friend dv_segment_iterator<distributed_vector>;
@@ -194,6 +219,7 @@ private:
   std::size_t size_;
   std::vector<dv_segment<distributed_vector>> segments_;
   dr::rma_window win_;
+  std::optional<__detail::window_pool::block> pool_block_;
 };
 
 template <typename T> auto &halo(const distributed_vector<T> &dv) {
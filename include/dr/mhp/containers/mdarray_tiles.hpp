@@ -0,0 +1,35 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <memory>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/global.hpp>
+
+namespace dr::mhp::__detail {
+
+// Rows of a distributed_mdarray that are stored on rank. The tile size
+// is the same on every rank, and the last tiles may be partial or
+// empty.
+inline std::size_t tile_rows(std::size_t extent, std::size_t tile,
+                             std::size_t rank) {
+  std::size_t first = std::min(rank * tile, extent);
+  return std::min(first + tile, extent) - first;
+}
+
+// Pointer to the local tile of a distributed_mdarray
+template <typename T> T *local_tile_pointer(auto &&mdarray) {
+  for (auto &&segment : dr::ranges::segments(mdarray)) {
+    if (dr::ranges::rank(segment) == default_comm().rank()) {
+      return std::to_address(dr::ranges::local(rng::begin(segment)));
+    }
+  }
+  return nullptr;
+}
+
+} // namespace dr::mhp::__detail
@@ -145,10 +145,22 @@ public:
                     size);
     dv_->win_.put(dst, size * sizeof(*dst), segment_index_,
                   segment_offset * sizeof(*dst));
+    active_wins().mark_dirty(dv_->win_.mpi_win());
   }
 
   void put(const value_type &value) const { put(&value, 1); }
 
+  void accumulate(const value_type *src, std::size_t size, MPI_Op op) const
+    requires mpi_arithmetic<value_type>
+  {
+    assert(dv_ != nullptr);
+    assert(segment_index_ * dv_->segment_size_ + index_ < dv_->size());
+    auto segment_offset = index_ + dv_->distribution_.halo().prev;
+    dv_->win_.accumulate(src, size, segment_index_,
+                         segment_offset * sizeof(*src), op);
+    active_wins().mark_dirty(dv_->win_.mpi_win());
+  }
+
   auto rank() const {
     assert(dv_ != nullptr);
     return segment_index_;
@@ -159,28 +171,37 @@ public:
     assert(dv_ != nullptr);
 #endif
     const auto my_process_segment_index = dv_->win_.communicator().rank();
+    const auto hb = dv_->distribution_.halo();
 
     if (my_process_segment_index == segment_index_)
-      return dv_->data_ + index_ + dv_->distribution_.halo().prev;
+      return dv_->data_ + index_ + hb.prev;
+
+    // sliding view needs local iterators that point to the halo. With a
+    // periodic halo, the last segment is also before the first one.
+    const auto num_segments = rng::size(dv_->segments_);
+    bool wraps = hb.periodic && num_segments > 1;
+    bool in_next = my_process_segment_index + 1 == segment_index_ ||
+                   (wraps && my_process_segment_index + 1 == num_segments &&
+                    segment_index_ == 0);
+    bool in_prev = my_process_segment_index == segment_index_ + 1 ||
+                   (wraps && my_process_segment_index == 0 &&
+                    segment_index_ + 1 == num_segments);
 #ifndef SYCL_LANGUAGE_VERSION
-    assert(!dv_->distribution_.halo().periodic); // not implemented
+    // The halo of a periodic vector wraps to the last segment only if
+    // it is full and stored on the last rank
+    [[maybe_unused]] const auto ranks =
+        dv_->win_.communicator().size(); // dr-style ignore
+    assert(!wraps || (num_segments == ranks &&
+                      rng::size(dv_->segments_.back()) == dv_->segment_size_));
 #endif
-    // sliding view needs local iterators that point to the halo
-    if (my_process_segment_index + 1 == segment_index_) {
-#ifndef SYCL_LANGUAGE_VERSION
-      assert(index_ <= dv_->distribution_.halo()
-                           .next); // <= instead of < to cover end() case
-#endif
-      return dv_->data_ + dv_->distribution_.halo().prev + index_ +
-             dv_->segment_size_;
+
+    // <= instead of < to cover end() case
+    if (in_next && index_ <= hb.next) {
+      return dv_->data_ + hb.prev + index_ + dv_->segment_size_;
     }
 
-    if (my_process_segment_index == segment_index_ + 1) {
-#ifndef SYCL_LANGUAGE_VERSION
-      assert(dv_->segment_size_ - index_ <= dv_->distribution_.halo().prev);
-#endif
-      return dv_->data_ + dv_->distribution_.halo().prev + index_ -
-             dv_->segment_size_;
+    if (in_prev && dv_->segment_size_ - index_ <= hb.prev) {
+      return dv_->data_ + hb.prev + index_ - dv_->segment_size_;
     }
 
 #ifndef SYCL_LANGUAGE_VERSION
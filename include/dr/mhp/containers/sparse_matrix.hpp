@@ -0,0 +1,359 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <algorithm>
+#include <execution>
+#include <fstream>
+#include <memory>
+#include <numeric>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <dr/detail/communicator.hpp>
+#include <dr/detail/index.hpp>
+#include <dr/detail/logger.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/mhp/global.hpp>
+#include <dr/mhp/halo.hpp>
+#include <dr/mhp/sycl_support.hpp>
+
+namespace dr::mhp::__detail {
+
+// Rows or columns are distributed like a distributed_vector of the
+// same size: rank r owns [r * n, (r + 1) * n) for n = ceil(size / ranks)
+inline std::size_t block_size(std::size_t size, std::size_t ranks) {
+  return std::max((size + ranks - 1) / ranks, std::size_t(1));
+}
+
+// Compressed sparse rows for the rows on one rank
+template <typename T, typename I> struct csr_block {
+  std::vector<I> rowptr;
+  std::vector<I> colind;
+  std::vector<T> values;
+
+  std::size_t nnz() const { return rng::size(values); }
+
+  // y = A * x, or y += A * x if accumulate
+  void multiply(T *y, const T *x, bool accumulate,
+                const std::vector<std::size_t> &rows) const {
+    auto row_product = [=, this](std::size_t i) {
+      T sum = accumulate ? y[i] : T(0);
+      for (auto k = rowptr[i]; k < rowptr[i + 1]; k++) {
+        sum += values[k] * x[colind[k]];
+      }
+      y[i] = sum;
+    };
+    std::for_each(std::execution::par_unseq, rows.begin(), rows.end(),
+                  row_product);
+  }
+};
+
+} // namespace dr::mhp::__detail
+
+namespace dr::mhp {
+
+/// Sparse matrix distributed by blocks of rows. The rows on a rank
+/// match the segment of a distributed_vector with the same number of
+/// elements, so y = A * x can be computed without moving y.
+///
+/// The columns that a rank needs from other ranks are found at
+/// construction, and a halo is built to fetch them from x.
+template <typename T, typename I = long> class sparse_matrix {
+public:
+  using value_type = T;
+  using index_type = I;
+  using size_type = std::size_t;
+
+  // Halo points to the x buffer, so cannot copy. Moving keeps the
+  // buffer in place.
+  sparse_matrix(const sparse_matrix &) = delete;
+  sparse_matrix &operator=(const sparse_matrix &) = delete;
+  sparse_matrix(sparse_matrix &&) = default;
+
+  /// Collective constructor. entries is a range of (row, column,
+  /// value) tuples. A rank keeps the entries for the rows it owns and
+  /// ignores the rest, so every rank may pass the whole matrix.
+  /// Duplicate entries are summed.
+  sparse_matrix(dr::index<std::size_t> shape,
+                rng::forward_range auto &&entries)
+      : shape_(shape) {
+    auto comm = default_comm();
+    auto ranks = comm.size();
+    auto rank = comm.rank();
+    row_block_ = __detail::block_size(shape_[0], ranks);
+    col_block_ = __detail::block_size(shape_[1], ranks);
+    row_first_ = std::min(rank * row_block_, shape_[0]);
+    row_last_ = std::min(row_first_ + row_block_, shape_[0]);
+    col_first_ = std::min(rank * col_block_, shape_[1]);
+    col_last_ = std::min(col_first_ + col_block_, shape_[1]);
+
+    std::vector<std::tuple<std::size_t, std::size_t, T>> local;
+    for (auto &&[i, j, v] : entries) {
+      assert(std::size_t(i) < shape_[0] && std::size_t(j) < shape_[1]);
+      if (std::size_t(i) >= row_first_ && std::size_t(i) < row_last_) {
+        local.emplace_back(i, j, v);
+      }
+    }
+    std::sort(std::execution::par_unseq, local.begin(), local.end(),
+              [](const auto &a, const auto &b) {
+                return std::pair(std::get<0>(a), std::get<1>(a)) <
+                       std::pair(std::get<0>(b), std::get<1>(b));
+              });
+
+    // Off-rank columns, sorted so the columns from each owner are
+    // contiguous
+    for (auto &[i, j, v] : local) {
+      if (!owned_column(j)) {
+        ghosts_.push_back(j);
+      }
+    }
+    std::sort(ghosts_.begin(), ghosts_.end());
+    ghosts_.erase(std::unique(ghosts_.begin(), ghosts_.end()), ghosts_.end());
+
+    build_blocks(local);
+    build_halo(comm);
+  }
+
+  /// Returns shape of the matrix
+  auto shape() const { return shape_; }
+  /// Number of stored values on this rank
+  auto local_nnz() const { return diagonal_.nnz() + off_diagonal_.nnz(); }
+  /// Number of stored values on all ranks
+  auto nnz() const { return nnz_; }
+  /// Rows on this rank
+  auto local_rows() const { return std::pair(row_first_, row_last_); }
+
+  /// Calls op(i, j, v) with global indices for every stored value on
+  /// this rank, row by row
+  void for_each_local(auto &&op) const {
+    std::size_t nlocal_cols = col_last_ - col_first_;
+    for (std::size_t row = 0; row < row_last_ - row_first_; row++) {
+      for (auto k = diagonal_.rowptr[row]; k < diagonal_.rowptr[row + 1];
+           k++) {
+        op(row_first_ + row, col_first_ + diagonal_.colind[k],
+           diagonal_.values[k]);
+      }
+      for (auto k = off_diagonal_.rowptr[row];
+           k < off_diagonal_.rowptr[row + 1]; k++) {
+        op(row_first_ + row, ghosts_[off_diagonal_.colind[k] - nlocal_cols],
+           off_diagonal_.values[k]);
+      }
+    }
+  }
+
+  /// Collective y = A * x for the rows on this rank. x and y point to
+  /// the local segments of vectors distributed like the columns and
+  /// rows of the matrix.
+  void multiply(T *y, T *x) {
+    std::size_t nrows = row_last_ - row_first_;
+    std::size_t nlocal_cols = col_last_ - col_first_;
+
+    // The kernels run on the host, so device data is staged
+    T *out = y;
+    if (mhp::use_sycl()) {
+      __detail::sycl_copy(x, x + nlocal_cols, x_buffer_.data());
+      out = y_buffer_.data();
+    } else {
+      std::copy(x, x + nlocal_cols, x_buffer_.data());
+    }
+
+    // Overlap the ghost exchange with the diagonal block
+    halo_->exchange_begin();
+    diagonal_.multiply(out, x_buffer_.data(), false, rows_);
+    halo_->exchange_finalize();
+    off_diagonal_.multiply(out, x_buffer_.data(), true, ghost_rows_);
+
+    if (mhp::use_sycl()) {
+      __detail::sycl_copy(out, out + nrows, y);
+    }
+  }
+
+private:
+  bool owned_column(std::size_t j) const {
+    return j >= col_first_ && j < col_last_;
+  }
+
+  // Split the local rows into the block that multiplies the local part
+  // of x and the block that multiplies the ghosts. Column indices are
+  // offsets into the x buffer.
+  void build_blocks(const auto &local) {
+    std::size_t nrows = row_last_ - row_first_;
+    std::size_t nlocal_cols = col_last_ - col_first_;
+    for (auto block : {&diagonal_, &off_diagonal_}) {
+      block->rowptr.assign(nrows + 1, 0);
+    }
+
+    for (std::size_t k = 0; k < rng::size(local);) {
+      auto [i, j, v] = local[k];
+      // Sum duplicates
+      for (k++; k < rng::size(local) && std::get<0>(local[k]) == i &&
+                std::get<1>(local[k]) == j;
+           k++) {
+        v += std::get<2>(local[k]);
+      }
+
+      auto row = i - row_first_;
+      if (owned_column(j)) {
+        diagonal_.colind.push_back(j - col_first_);
+        diagonal_.values.push_back(v);
+        diagonal_.rowptr[row + 1]++;
+      } else {
+        auto ghost = std::lower_bound(ghosts_.begin(), ghosts_.end(), j) -
+                     ghosts_.begin();
+        off_diagonal_.colind.push_back(nlocal_cols + ghost);
+        off_diagonal_.values.push_back(v);
+        off_diagonal_.rowptr[row + 1]++;
+      }
+    }
+    for (auto block : {&diagonal_, &off_diagonal_}) {
+      std::inclusive_scan(block->rowptr.begin(), block->rowptr.end(),
+                          block->rowptr.begin());
+    }
+
+    rows_.resize(nrows);
+    std::iota(rows_.begin(), rows_.end(), 0);
+    // Only rows with off-rank columns need a second pass
+    for (std::size_t row = 0; row < nrows; row++) {
+      if (off_diagonal_.rowptr[row + 1] > off_diagonal_.rowptr[row]) {
+        ghost_rows_.push_back(row);
+      }
+    }
+
+    x_buffer_.resize(nlocal_cols + rng::size(ghosts_));
+    y_buffer_.resize(nrows);
+    nnz_ = default_comm().all_reduce(local_nnz(), MPI_SUM);
+    dr::drlog.debug("sparse_matrix: rows: {}-{} nnz: {} ghosts: {}\n",
+                    row_first_, row_last_, local_nnz(), rng::size(ghosts_));
+  }
+
+  // Tell the owners which columns this rank needs, and build a halo
+  // that sends them into the ghost part of the x buffer
+  void build_halo(communicator comm) {
+    auto ranks = comm.size();
+    std::size_t nlocal_cols = col_last_ - col_first_;
+
+    std::vector<std::size_t> send_counts(ranks, 0), recv_counts(ranks);
+    for (auto j : ghosts_) {
+      send_counts[j / col_block_]++;
+    }
+    comm.alltoall(send_counts, recv_counts, 1);
+
+    std::vector<std::size_t> send_displs(ranks), recv_displs(ranks);
+    std::exclusive_scan(send_counts.begin(), send_counts.end(),
+                        send_displs.begin(), std::size_t(0));
+    std::exclusive_scan(recv_counts.begin(), recv_counts.end(),
+                        recv_displs.begin(), std::size_t(0));
+    std::vector<std::size_t> requested(recv_displs.back() +
+                                       recv_counts.back());
+    comm.alltoallv(ghosts_, send_counts, send_displs, requested, recv_counts,
+                   recv_displs);
+
+    using index_map = typename unstructured_halo<T>::index_map;
+    std::vector<index_map> owned, halo;
+    for (std::size_t r = 0; r < ranks; r++) {
+      if (recv_counts[r] > 0) {
+        std::vector<std::size_t> indices;
+        for (std::size_t k = 0; k < recv_counts[r]; k++) {
+          indices.push_back(requested[recv_displs[r] + k] - col_first_);
+        }
+        owned.emplace_back(r, indices);
+      }
+      if (send_counts[r] > 0) {
+        std::vector<std::size_t> indices(send_counts[r]);
+        std::iota(indices.begin(), indices.end(),
+                  nlocal_cols + send_displs[r]);
+        halo.emplace_back(r, indices);
+      }
+    }
+    halo_ = std::make_unique<unstructured_halo<T>>(comm, x_buffer_.data(),
+                                                   owned, halo);
+  }
+
+  dr::index<std::size_t> shape_;
+  std::size_t row_block_, col_block_;
+  std::size_t row_first_, row_last_, col_first_, col_last_;
+  std::size_t nnz_ = 0;
+
+  __detail::csr_block<T, I> diagonal_, off_diagonal_;
+  std::vector<std::size_t> rows_, ghost_rows_;
+  // Global indices of off-rank columns
+  std::vector<std::size_t> ghosts_;
+  // Local part of x followed by the ghosts
+  std::vector<T> x_buffer_;
+  // Staging for y when it is in device memory
+  std::vector<T> y_buffer_;
+  std::unique_ptr<unstructured_halo<T>> halo_;
+};
+
+/// Collective read of a Matrix Market file. Every rank reads the file
+/// and keeps the rows it owns.
+template <typename T, typename I = long>
+sparse_matrix<T, I> mmread(std::string file_path, bool one_indexed = true) {
+  std::ifstream f(file_path);
+  if (!f.is_open()) {
+    throw std::runtime_error("mmread: cannot open " + file_path);
+  }
+
+  std::string buf, item;
+  std::getline(f, buf);
+  std::istringstream header(buf);
+  std::vector<std::string> banner;
+  while (header >> item) {
+    banner.push_back(item);
+  }
+  if (rng::size(banner) < 5 || banner[0] != "%%MatrixMarket" ||
+      banner[1] != "matrix" || banner[2] != "coordinate") {
+    throw std::runtime_error(file_path +
+                             " could not be parsed as a Matrix Market file.");
+  }
+  bool pattern = banner[3] == "pattern";
+  bool symmetric = banner[4] == "symmetric";
+  if (!symmetric && banner[4] != "general") {
+    throw std::runtime_error(file_path + " has an unsupported matrix type");
+  }
+
+  do {
+    std::getline(f, buf);
+  } while (buf[0] == '%');
+  std::size_t m, n, nnz;
+  std::istringstream(buf) >> m >> n >> nnz;
+
+  auto comm = default_comm();
+  auto row_block = __detail::block_size(m, comm.size());
+  auto first = comm.rank() * row_block, last = first + row_block;
+  auto mine = [=](std::size_t i) { return i >= first && i < last; };
+
+  std::vector<std::tuple<std::size_t, std::size_t, T>> entries;
+  while (std::getline(f, buf)) {
+    std::size_t i, j;
+    T v(1);
+    std::istringstream line(buf);
+    line >> i >> j;
+    if (!pattern) {
+      line >> v;
+    }
+    if (one_indexed) {
+      i--;
+      j--;
+    }
+    if (i >= m || j >= n) {
+      throw std::runtime_error("mmread: file has nonzero out of bounds.");
+    }
+    if (mine(i)) {
+      entries.emplace_back(i, j, v);
+    }
+    if (symmetric && i != j && mine(j)) {
+      entries.emplace_back(j, i, v);
+    }
+  }
+
+  return sparse_matrix<T, I>({m, n}, entries);
+}
+
+} // namespace dr::mhp
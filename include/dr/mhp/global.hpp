@@ -10,11 +10,41 @@
 #endif
 #include <dr/detail/sycl_utils.hpp>
 #include <dr/mhp/sycl_support.hpp>
+#include <dr/mhp/window_pool.hpp>
 
 namespace dr::mhp {
 
 namespace __detail {
 
+//
+// Windows used by containers, in creation order. Windows are created
+// collectively, so the order is the same on every rank. MPI handles
+// are not comparable across ranks, so the order is used to agree on
+// which windows need synchronization.
+//
+class window_set {
+public:
+  void insert(MPI_Win win) { wins_.push_back(win); }
+  void erase(MPI_Win win) {
+    std::erase(wins_, win);
+    dirty_.erase(win);
+  }
+
+  auto begin() const { return wins_.begin(); }
+  auto end() const { return wins_.end(); }
+  auto size() const { return rng::size(wins_); }
+
+  // Window was the target of RMA that completes at the next fence
+  void mark_dirty(MPI_Win win) { dirty_.insert(win); }
+  bool dirty(MPI_Win win) const { return dirty_.contains(win); }
+  void clear_dirty(MPI_Win win) { dirty_.erase(win); }
+  void clear_dirty() { dirty_.clear(); }
+
+private:
+  std::vector<MPI_Win> wins_;
+  std::set<MPI_Win> dirty_;
+};
+
 struct global_context {
   void init() {
     void *data = nullptr;
@@ -29,6 +59,7 @@ struct global_context {
   }
 
   ~global_context() {
+    window_pool_.free();
     root_win_.fence();
     root_win_.free();
   }
@@ -50,9 +81,10 @@ struct global_context {
   bool use_sycl_ = false;
   dr::communicator comm_;
   // container owns the window, we just track MPI handle
-  std::set<MPI_Win> wins_;
+  window_set wins_;
   dr::rma_window root_win_;
   std::vector<char> root_scratchpad_;
+  window_pool window_pool_;
 };
 
 inline global_context *global_context_ = nullptr;
@@ -102,18 +134,92 @@ inline bool finalized() { return __detail::finalized_; }
 inline std::size_t rank() { return default_comm().rank(); }
 inline std::size_t nprocs() { return default_comm().size(); } // dr-style ignore
 
-inline std::set<MPI_Win> &active_wins() { return __detail::gcontext()->wins_; }
+inline __detail::window_set &active_wins() {
+  return __detail::gcontext()->wins_;
+}
 
 inline void barrier() { __detail::gcontext()->comm_.barrier(); }
 inline auto use_sycl() { return __detail::gcontext()->use_sycl_; }
 
+namespace __detail {
+
+// True if the window has separate public and private copies, so local
+// stores are only visible to remote reads after a synchronization of
+// the window
+inline bool separate_model(MPI_Win win) {
+  int *model, flag;
+  MPI_Win_get_attr(win, MPI_WIN_MODEL, &model, &flag);
+  return flag && *model == MPI_WIN_SEPARATE;
+}
+
+} // namespace __detail
+
+/// Complete RMA on all windows and synchronize processes. Only windows
+/// that were the target of a put on some rank since the last fence,
+/// or that use the separate memory model, are fenced.
 inline void fence() {
-  dr::drlog.debug("fence\n");
-  for (auto win : __detail::gcontext()->wins_) {
-    MPI_Win_fence(0, win);
+  auto &wins = active_wins();
+  dr::drlog.debug("fence: {} windows\n", rng::size(wins));
+
+  // Each rank only knows the RMA it issued. Agree on the windows
+  // that need a fence. In the unified memory model, the allreduce
+  // orders local stores before later remote reads. In the separate
+  // model, local stores reach the public copy of the window only by
+  // synchronizing the window, so those windows are always fenced.
+  std::vector<unsigned char> dirty;
+  dirty.reserve(rng::size(wins));
+  for (auto win : wins) {
+    dirty.push_back(wins.dirty(win) || __detail::separate_model(win));
+  }
+  MPI_Allreduce(MPI_IN_PLACE, dirty.data(), rng::size(dirty),
+                MPI_UNSIGNED_CHAR, MPI_MAX, default_comm().mpi_comm());
+
+  std::size_t i = 0;
+  for (auto win : wins) {
+    if (dirty[i++]) {
+      MPI_Win_fence(0, win);
+    }
+  }
+  wins.clear_dirty();
+
+  // RMA to released blocks is complete, they can be reused
+  __detail::gcontext()->window_pool_.reclaim();
+}
+
+namespace __detail {
+
+// Storage for a container from the window pool. Collective, but
+// only synchronizes when the pool runs out of space. Returns nullopt
+// if the request is too large for the pool.
+inline std::optional<window_pool::block> pool_allocate(std::size_t size) {
+  auto &pool = gcontext()->window_pool_;
+  if (!pool.pooled(size)) {
+    return std::nullopt;
+  }
+
+  if (auto b = pool.allocate(size)) {
+    return b;
   }
+
+  // Reuse released blocks before adding an arena
+  if (pool.pending()) {
+    mhp::fence();
+    if (auto b = pool.allocate(size)) {
+      return b;
+    }
+  }
+
+  active_wins().insert(pool.grow(default_comm()));
+  return pool.allocate(size);
 }
 
+// Return container storage to the window pool. Not collective.
+inline void pool_release(const window_pool::block &b) {
+  gcontext()->window_pool_.release(b);
+}
+
+} // namespace __detail
+
 inline void init() {
   __detail::initialize_mpi();
   assert(__detail::global_context_ == nullptr &&
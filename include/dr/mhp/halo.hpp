@@ -4,9 +4,47 @@
 
 #pragma once
 
+#include <cstring>
+#include <functional>
+
+#include <dr/detail/mdspan_utils.hpp>
 #include <dr/mhp/global.hpp>
 #include <dr/mhp/sycl_support.hpp>
 
+namespace dr::mhp::__detail {
+
+// Derived datatype for the elements of an mdspan over memory, in
+// order. Built from the last dimension out with byte strides, so it
+// describes any strided layout. The base type is bytes, so it matches
+// a contiguous receive of the same number of bytes.
+template <dr::__detail::mdspan_like Mdspan>
+MPI_Datatype mdspan_datatype(const Mdspan &mdspan) {
+  using T = typename Mdspan::value_type;
+  MPI_Datatype type;
+  MPI_Type_contiguous(sizeof(T), MPI_BYTE, &type);
+  for (std::size_t d = Mdspan::rank(); d-- > 0;) {
+    MPI_Datatype outer;
+    MPI_Type_create_hvector(mdspan.extent(d), 1, mdspan.stride(d) * sizeof(T),
+                            type, &outer);
+    MPI_Type_free(&type);
+    type = outer;
+  }
+  MPI_Type_commit(&type);
+  return type;
+}
+
+// Datatype that a group is sent and received with, or
+// MPI_DATATYPE_NULL if it is contiguous
+template <typename Group> MPI_Datatype group_datatype(Group &g) {
+  if constexpr (requires { g.datatype(); }) {
+    return g.datatype();
+  } else {
+    return MPI_DATATYPE_NULL;
+  }
+}
+
+} // namespace dr::mhp::__detail
+
 namespace dr::mhp {
 
 template <typename Group> class halo_impl {
@@ -76,7 +114,7 @@ public:
 
   /// Begin a halo reduction
   void reduce_begin() {
-    receive(owned_groups_);
+    receive(owned_groups_, true);
     send(halo_groups_);
   }
 
@@ -88,7 +126,7 @@ public:
                   MPI_STATUS_IGNORE);
       drlog.debug("Completed: {}\n", completed);
       auto &g = *map_[completed];
-      if (g.receive && g.buffered) {
+      if (g.receive && g.buffer_size() > 0) {
         g.unpack(op);
       }
     }
@@ -108,6 +146,31 @@ public:
     }
   }
 
+  /// One-sided halo reduction. Each halo group is combined into the
+  /// owned data of its owner with MPI_Accumulate, and the reduction
+  /// completes with a fence, so owners do not combine the contributions
+  /// themselves. Uses the two-sided reduction when op has no native MPI
+  /// operation, or when the data is not an arithmetic type.
+  void reduce_accumulate(const auto &op) {
+    MPI_Op mpi_op = native_op(op);
+    if (mpi_op == MPI_OP_NULL || !rma_enabled()) {
+      reduce_begin();
+      reduce_finalize(op);
+      return;
+    }
+
+    drlog.debug("Halo reduce accumulate\n");
+    win_.fence();
+    std::size_t i = 0;
+    for (auto &g : halo_groups_) {
+      if constexpr (mpi_arithmetic<T>) {
+        win_.accumulate(g.data_pointer(), g.data_size(), g.rank(),
+                        target_displacements_[i++], mpi_op);
+      }
+    }
+    win_.fence();
+  }
+
   struct second_op {
     T operator()(T &a, T &b) const { return b; }
   } second;
@@ -128,7 +191,15 @@ public:
     T operator()(T &a, T &b) const { return a * b; }
   } multiplies;
 
+  /// Groups that are sent in an exchange
+  std::vector<Group> &owned_groups() { return owned_groups_; }
+  /// Groups that are received in an exchange
+  std::vector<Group> &halo_groups() { return halo_groups_; }
+
   ~halo_impl() {
+    if (!win_.null()) {
+      win_.free();
+    }
     if (buffer_) {
       memory_.deallocate(buffer_, buffer_size_);
       buffer_ = nullptr;
@@ -136,22 +207,113 @@ public:
   }
 
 private:
+  template <typename Op> static MPI_Op native_op(const Op &) {
+    if constexpr (std::is_same_v<Op, plus_op>) {
+      return MPI_SUM;
+    } else if constexpr (std::is_same_v<Op, max_op>) {
+      return MPI_MAX;
+    } else if constexpr (std::is_same_v<Op, min_op>) {
+      return MPI_MIN;
+    } else if constexpr (std::is_same_v<Op, multiplies_op>) {
+      return MPI_PROD;
+    } else if constexpr (std::is_same_v<Op, second_op>) {
+      return MPI_REPLACE;
+    } else {
+      return MPI_OP_NULL;
+    }
+  }
+
+  // Collective. On the first call, decides if all ranks can use RMA.
+  // If so, creates a window over the owned groups and sends every
+  // owner's displacement of each owned group to the rank that reduces
+  // into it.
+  bool rma_enabled() {
+    if (rma_state_ != rma_state::unknown) {
+      return rma_state_ == rma_state::enabled;
+    }
+
+    // Buffered groups keep their data in a staging buffer, and groups
+    // with a datatype are not contiguous
+    int enabled = mpi_arithmetic<T>;
+    for (auto &g : owned_groups_) {
+      enabled = enabled && !g.buffered &&
+                __detail::group_datatype(g) == MPI_DATATYPE_NULL;
+    }
+    for (auto &g : halo_groups_) {
+      enabled = enabled && !g.buffered &&
+                __detail::group_datatype(g) == MPI_DATATYPE_NULL;
+    }
+    enabled = comm_.all_reduce(enabled, MPI_MIN);
+    rma_state_ = enabled ? rma_state::enabled : rma_state::disabled;
+    drlog.debug("Halo rma enabled: {}\n", enabled);
+    if (!enabled) {
+      return false;
+    }
+
+    // The window covers all the owned groups
+    T *first = nullptr, *last = nullptr;
+    for (auto &g : owned_groups_) {
+      T *p = g.data_pointer();
+      first = first ? std::min(first, p) : p;
+      last = std::max(last, p + g.data_size());
+    }
+    win_.create(comm_, first, (last - first) * sizeof(T));
+
+    std::vector<std::size_t> displacements;
+    for (auto &g : owned_groups_) {
+      displacements.push_back((g.data_pointer() - first) * sizeof(T));
+    }
+    target_displacements_.resize(rng::size(halo_groups_));
+    std::vector<MPI_Request> requests;
+    requests.reserve(rng::size(owned_groups_) + rng::size(halo_groups_));
+    std::size_t i = 0;
+    for (auto &g : halo_groups_) {
+      requests.emplace_back();
+      comm_.irecv(&target_displacements_[i++], 1, g.rank(), g.tag(),
+                  &requests.back());
+    }
+    i = 0;
+    for (auto &g : owned_groups_) {
+      requests.emplace_back();
+      comm_.isend(&displacements[i++], 1, g.rank(), g.tag(), &requests.back());
+    }
+    MPI_Waitall(rng::size(requests), requests.data(), MPI_STATUSES_IGNORE);
+    return true;
+  }
+
   void send(std::vector<Group> &sends) {
     for (auto &g : sends) {
       g.pack();
       g.receive = false;
       drlog.debug("Sending: {}\n", g.request_index);
-      comm_.isend(g.data_pointer(), g.data_size(), g.rank(), g.tag(),
-                  &requests_[g.request_index]);
+      MPI_Datatype type = __detail::group_datatype(g);
+      if (type != MPI_DATATYPE_NULL) {
+        comm_.isend_type(g.data_pointer(), type, g.rank(), g.tag(),
+                         &requests_[g.request_index]);
+      } else {
+        comm_.isend(g.data_pointer(), g.data_size(), g.rank(), g.tag(),
+                    &requests_[g.request_index]);
+      }
     }
   }
 
-  void receive(std::vector<Group> &receives) {
+  // A reduction receives into the buffer when there is one, so the
+  // data can be combined with op
+  void receive(std::vector<Group> &receives, bool combine = false) {
     for (auto &g : receives) {
       g.receive = true;
       drlog.debug("Receiving: {}\n", g.request_index);
-      comm_.irecv(g.data_pointer(), g.data_size(), g.rank(), g.tag(),
-                  &requests_[g.request_index]);
+      MPI_Datatype type = __detail::group_datatype(g);
+      if (combine && g.buffer_size() > 0) {
+        comm_.irecv(g.buffer, g.data_size(), g.rank(), g.tag(),
+                    &requests_[g.request_index]);
+      } else if (type != MPI_DATATYPE_NULL) {
+        comm_.irecv_type(g.data_pointer(), type, g.rank(), g.tag(),
+                         &requests_[g.request_index]);
+      } else {
+        comm_.irecv(g.data_pointer(), g.data_size(), g.rank(), g.tag(),
+                    &requests_[g.request_index]);
+      }
     }
   }
 
@@ -162,6 +324,12 @@ private:
   std::vector<MPI_Request> requests_;
   std::vector<Group *> map_;
   Memory memory_;
+
+  enum class rma_state { unknown, enabled, disabled };
+  rma_state rma_state_ = rma_state::unknown;
+  dr::rma_window win_;
+  // For each halo group, byte displacement in the owner's window
+  std::vector<std::size_t> target_displacements_;
 };
 
 template <typename T, typename Memory = default_memory<T>> class index_group {
@@ -209,7 +377,22 @@ public:
     });
   }
 
+  void unpack() {
+    T *dpt = data_;
+    auto n = indices_size_;
+    auto *ipt = indices_;
+    auto *b = buffer;
+    memory_.offload([=]() {
+      for (std::size_t i = 0; i < n; i++) {
+        dpt[ipt[i]] = b[i];
+      }
+    });
+  }
+
   void pack() {
+    if (!buffered) {
+      return;
+    }
     T *dpt = data_;
     auto n = indices_size_;
     auto *ipt = indices_;
@@ -307,6 +490,17 @@ public:
 #endif
   }
 
+  void unpack(const auto &op) {
+    T *dpt = data_.data();
+    auto n = rng::size(data_);
+    auto *b = buffer;
+    memory_.offload([=]() {
+      for (std::size_t i = 0; i < n; i++) {
+        dpt[i] = op(dpt[i], b[i]);
+      }
+    });
+  }
+
   void unpack() {
     if (buffered) {
       if (mhp::use_sycl()) {
@@ -367,22 +561,30 @@ public:
   span_halo() : span_halo_impl<T, Memory>(communicator(), {}, {}) {}
 
   span_halo(communicator comm, T *data, std::size_t size, halo_bounds hb)
-      : span_halo_impl<T, Memory>(comm, owned_groups(comm, {data, size}, hb),
-                                  halo_groups(comm, {data, size}, hb)) {
+      : span_halo_impl<T, Memory>(comm,
+                                  make_owned_groups(comm, {data, size}, hb),
+                                  make_halo_groups(comm, {data, size}, hb)),
+        bounds_(hb) {
     check(size, hb);
   }
 
   span_halo(communicator comm, std::span<T> span, halo_bounds hb)
-      : span_halo_impl<T, Memory>(comm, owned_groups(comm, span, hb),
-                                  halo_groups(comm, span, hb)) {}
+      : span_halo_impl<T, Memory>(comm, make_owned_groups(comm, span, hb),
+                                  make_halo_groups(comm, span, hb)),
+        bounds_(hb) {}
+
+  /// Width of the halo, in elements
+  halo_bounds bounds() const { return bounds_; }
 
 private:
+  halo_bounds bounds_;
+
   void check(auto size, auto hb) {
     assert(size >= hb.prev + hb.next + std::max(hb.prev, hb.next));
   }
 
   static std::vector<group_type>
-  owned_groups(communicator comm, std::span<T> span, halo_bounds hb) {
+  make_owned_groups(communicator comm, std::span<T> span, halo_bounds hb) {
     std::vector<group_type> owned;
     drlog.debug(nostd::source_location::current(),
                 "owned groups {}/{} first/last\n", comm.first(), comm.last());
@@ -399,7 +601,7 @@ private:
   }
 
   static std::vector<group_type>
-  halo_groups(communicator comm, std::span<T> span, halo_bounds hb) {
+  make_halo_groups(communicator comm, std::span<T> span, halo_bounds hb) {
     std::vector<group_type> halo;
     if (hb.prev > 0 && (hb.periodic || !comm.first())) {
       halo.emplace_back(span.first(hb.prev), comm.prev(),
@@ -413,6 +615,321 @@ private:
   }
 };
 
+/// Group for a face of a multidimensional array. A face is strided
+/// unless it is a block of whole rows. MPI sends and receives the face
+/// in place, described by a derived datatype. If use_datatype is
+/// false, or the memory is shared with a device, the face is packed
+/// into the halo buffer instead.
+template <typename T, std::size_t Rank, typename Memory = default_memory<T>>
+class mdspan_group {
+public:
+  using element_type = T;
+  using memory_type = Memory;
+  using face_type =
+      md::mdspan<T, dr::__detail::md_extents<Rank>, md::layout_stride>;
+  T *buffer = nullptr;
+  std::size_t request_index = 0;
+  bool receive = false;
+  bool buffered = false;
+
+  mdspan_group(face_type face, std::size_t rank, communicator::tag tag,
+               bool use_datatype = true, const Memory &memory = Memory())
+      : memory_(memory), face_(face), rank_(rank), tag_(tag) {
+    buffered = !use_datatype;
+#ifdef SYCL_LANGUAGE_VERSION
+    if (use_sycl() && sycl_mem_kind() == sycl::usm::alloc::shared) {
+      buffered = true;
+    }
+#endif
+    size_ = 1;
+    for (std::size_t d = 0; d < Rank; d++) {
+      size_ *= face_.extent(d);
+    }
+    if (!buffered) {
+      datatype_ = __detail::mdspan_datatype(face_);
+    }
+  }
+
+  mdspan_group(const mdspan_group &o)
+      : buffer(o.buffer), request_index(o.request_index), receive(o.receive),
+        buffered(o.buffered), memory_(o.memory_), face_(o.face_),
+        rank_(o.rank_), tag_(o.tag_), size_(o.size_) {
+    if (o.datatype_ != MPI_DATATYPE_NULL) {
+      MPI_Type_dup(o.datatype_, &datatype_);
+    }
+  }
+
+  mdspan_group &operator=(const mdspan_group &) = delete;
+
+  // The buffer holds the face in row major order, like mdspan_unpack
+  void unpack(const auto &op) {
+    auto face = face_;
+    auto *data = face.data_handle();
+    auto *b = buffer;
+    std::size_t n = face.extent(Rank - 1), stride = face.stride(Rank - 1);
+    memory_.offload([=]() {
+      dr::__detail::mdspan_foreach_run(
+          face, [=](std::size_t offset, std::size_t run) {
+            T *in = b + run * n;
+            for (std::size_t i = 0; i < n; i++) {
+              data[offset + i * stride] = op(data[offset + i * stride], in[i]);
+            }
+          });
+    });
+  }
+
+  void unpack() {
+    if (buffered) {
+      auto face = face_;
+      auto *b = buffer;
+      memory_.offload([=]() { dr::__detail::mdspan_unpack(b, face); });
+    }
+  }
+
+  void pack() {
+    if (buffered) {
+      auto face = face_;
+      auto *b = buffer;
+      memory_.offload([=]() { dr::__detail::mdspan_pack(face, b); });
+    }
+  }
+
+  // Reductions combine from the buffer, so there is always one
+  std::size_t buffer_size() { return size_; }
+
+  std::size_t data_size() { return size_; }
+
+  T *data_pointer() {
+    if (buffered) {
+      return buffer;
+    } else {
+      return face_.data_handle();
+    }
+  }
+
+  MPI_Datatype datatype() { return buffered ? MPI_DATATYPE_NULL : datatype_; }
+
+  std::size_t rank() { return rank_; }
+
+  auto tag() { return tag_; }
+
+  ~mdspan_group() {
+    int finalized;
+    MPI_Finalized(&finalized);
+    if (datatype_ != MPI_DATATYPE_NULL && !finalized) {
+      MPI_Type_free(&datatype_);
+    }
+  }
+
+private:
+  Memory memory_;
+  face_type face_;
+  std::size_t rank_;
+  communicator::tag tag_;
+  std::size_t size_;
+  MPI_Datatype datatype_ = MPI_DATATYPE_NULL;
+};
+
+template <typename T, std::size_t Rank, typename Memory>
+using mdspan_halo_impl = halo_impl<mdspan_group<T, Rank, Memory>>;
+
+/// Halo of a multidimensional array, given as the faces that are sent
+/// to and received from each neighbor. Faces are usually strided
+/// submdspans of the local array, which MPI sends without packing.
+/// Faces exchanged with the same neighbor and tag are matched in
+/// order, so use different tags when the order differs, e.g. for the
+/// two faces of a periodic dimension with 2 processes.
+template <typename T, std::size_t Rank, typename Memory = default_memory<T>>
+class mdspan_halo : public mdspan_halo_impl<T, Rank, Memory> {
+public:
+  using group_type = mdspan_group<T, Rank, Memory>;
+  using face_type = typename group_type::face_type;
+
+  struct face_map {
+    std::size_t rank;
+    face_type face;
+    communicator::tag tag = communicator::tag::halo_index;
+  };
+
+  ///
+  /// Constructor
+  ///
+  mdspan_halo(communicator comm, const std::vector<face_map> &owned,
+              const std::vector<face_map> &halo, bool use_datatype = true,
+              const Memory &memory = Memory())
+      : mdspan_halo_impl<T, Rank, Memory>(
+            comm, make_groups(owned, use_datatype, memory),
+            make_groups(halo, use_datatype, memory), memory) {}
+
+private:
+  static std::vector<group_type> make_groups(const std::vector<face_map> &map,
+                                             bool use_datatype,
+                                             const Memory &memory) {
+    std::vector<group_type> groups;
+    groups.reserve(rng::size(map));
+    for (auto const &[rank, face, tag] : map) {
+      groups.emplace_back(face, rank, tag, use_datatype, memory);
+    }
+    return groups;
+  }
+};
+
+namespace __detail {
+
+// Copy between host memory and memory that may be on the device
+inline void halo_copy_bytes(void *dst, const void *src, std::size_t bytes) {
+  auto s = static_cast<const std::byte *>(src);
+  if (mhp::use_sycl()) {
+    sycl_copy(s, s + bytes, static_cast<std::byte *>(dst));
+  } else {
+    std::memcpy(dst, src, bytes);
+  }
+}
+
+} // namespace __detail
+
+/// Exchanges the halos of several containers together. The boundary
+/// data that goes to the same neighbor in the same direction is packed
+/// into one message, so exchanging n fields sends 1 message per
+/// neighbor and direction instead of n. Halos can hold different
+/// element types. Every rank must add the halos in the same order, and
+/// the halos must outlive the group.
+class halo_group {
+public:
+  halo_group() = default;
+
+  template <typename... Halos> halo_group(Halos &...halos) {
+    (add(halos), ...);
+  }
+
+  /// Add the owned and halo groups of a halo
+  template <typename Halo> void add(Halo &halo) {
+    for (auto &g : halo.owned_groups()) {
+      add_part(sends_, g);
+    }
+    for (auto &g : halo.halo_groups()) {
+      add_part(receives_, g);
+    }
+    for (auto &m : receives_) {
+      m.buffer.resize(m.bytes);
+    }
+    for (auto &m : sends_) {
+      m.buffer.resize(m.bytes);
+    }
+    requests_.resize(rng::size(receives_) + rng::size(sends_));
+  }
+
+  /// Begin a halo exchange of all the halos
+  void exchange_begin() {
+    drlog.debug("Halo group exchange begin: {}/{} receives/sends\n",
+                rng::size(receives_), rng::size(sends_));
+    std::size_t i = 0;
+    for (auto &m : receives_) {
+      comm_.irecv(m.buffer.data(), m.bytes, m.rank, m.tag, &requests_[i++]);
+    }
+    for (auto &m : sends_) {
+      std::size_t offset = 0;
+      for (auto &p : m.parts) {
+        p.pack(m.buffer.data() + offset);
+        offset += p.bytes;
+      }
+      comm_.isend(m.buffer.data(), m.bytes, m.rank, m.tag, &requests_[i++]);
+    }
+  }
+
+  /// Complete a halo exchange of all the halos
+  void exchange_finalize() {
+    for (int pending = rng::size(requests_); pending > 0; pending--) {
+      int completed;
+      MPI_Waitany(rng::size(requests_), requests_.data(), &completed,
+                  MPI_STATUS_IGNORE);
+      if (std::size_t(completed) < rng::size(receives_)) {
+        auto &m = receives_[completed];
+        std::size_t offset = 0;
+        for (auto &p : m.parts) {
+          p.unpack(m.buffer.data() + offset);
+          offset += p.bytes;
+        }
+      }
+    }
+    drlog.debug("Halo group exchange finalize\n");
+  }
+
+  void exchange() {
+    exchange_begin();
+    exchange_finalize();
+  }
+
+private:
+  // The data of one group inside a message
+  struct part {
+    std::size_t bytes;
+    std::function<void(std::byte *)> pack;
+    std::function<void(const std::byte *)> unpack;
+  };
+
+  // All the groups for a neighbor and direction
+  struct message {
+    std::size_t rank;
+    communicator::tag tag;
+    std::size_t bytes = 0;
+    std::vector<part> parts;
+    std::vector<std::byte> buffer;
+  };
+
+  template <typename Group>
+  static void add_part(std::vector<message> &messages, Group &g) {
+    using T = typename Group::element_type;
+    auto it = rng::find_if(messages, [&g](auto &m) {
+      return m.rank == g.rank() && m.tag == g.tag();
+    });
+    if (it == messages.end()) {
+      messages.push_back({g.rank(), g.tag()});
+      it = messages.end() - 1;
+    }
+
+    std::size_t bytes = g.data_size() * sizeof(T);
+    // Groups with a datatype are packed by MPI
+    auto pack = [&g, bytes](std::byte *dst) {
+      MPI_Datatype type = __detail::group_datatype(g);
+      if (type != MPI_DATATYPE_NULL) {
+        int position = 0;
+        MPI_Pack(g.data_pointer(), 1, type, dst, bytes, &position,
+                 default_comm().mpi_comm());
+        return;
+      }
+      g.pack();
+      __detail::halo_copy_bytes(dst, g.data_pointer(), bytes);
+    };
+    auto unpack = [&g, bytes](const std::byte *src) {
+      MPI_Datatype type = __detail::group_datatype(g);
+      if (type != MPI_DATATYPE_NULL) {
+        int position = 0;
+        MPI_Unpack(src, bytes, &position, g.data_pointer(), 1, type,
+                   default_comm().mpi_comm());
+        return;
+      }
+      __detail::halo_copy_bytes(g.data_pointer(), src, bytes);
+      if (g.buffered) {
+        g.unpack();
+      }
+    };
+    it->parts.push_back({bytes, pack, unpack});
+    it->bytes += bytes;
+  }
+
+  communicator comm_ = default_comm();
+  std::vector<message> receives_, sends_;
+  std::vector<MPI_Request> requests_;
+};
+
+/// Exchange the halos of several containers with one message per
+/// neighbor and direction. Use a halo_group to overlap the exchange
+/// with computation, or to avoid setting up the group every time.
+template <typename... Halos> void exchange_all(Halos &...halos) {
+  halo_group(halos...).exchange();
+}
+
 } // namespace dr::mhp
 
 #ifdef DR_FORMAT
@@ -20,7 +20,8 @@ template <typename T> T sycl_get(T &v) {
   return temp;
 }
 
-template <typename T> void sycl_copy(T *begin, T *end, T *dst) {
+template <typename T>
+void sycl_copy(const T *begin, const T *end, T *dst) {
   sycl_queue().memcpy(dst, begin, (end - begin) * sizeof(T)).wait();
 }
 
@@ -65,7 +66,8 @@ template <typename T> T sycl_get(T &v) {
   return v;
 }
 
-template <typename T> void sycl_copy(T *begin, T *end, T *dst) {
+template <typename T>
+void sycl_copy(const T *begin, const T *end, T *dst) {
   assert(false);
 }
 
@@ -107,7 +107,8 @@ private:
       std::size_t segment_index = std::get<0>(v);
       std::size_t end = (segment_index + 1) * tile_shape[0];
       if (end > full_shape[0]) {
-        clipped[0] -= end - full_shape[0];
+        // Trailing segments may be empty
+        clipped[0] -= std::min(end - full_shape[0], clipped[0]);
       }
       return __detail::md_segment(
           segment_index_to_global_origin(segment_index, full_shape, tile_shape),
@@ -14,8 +14,9 @@ namespace __detail {
 
 struct sliding_fn {
 
-  // one can not use local algorithms if n is not equal to halo_bounds.prev + 1
-  // + halo_bounds.next
+  // one can not use local algorithms if n is greater than halo_bounds.prev +
+  // 1 + halo_bounds.next, or if the halo is asymmetric and n is not equal
+  // to halo_bounds.prev + 1 + halo_bounds.next
   template <typename Rng, typename Int>
     requires rng::viewable_range<Rng> && rng::forward_range<Rng> &&
              rng::detail::integer_like_<Int>
@@ -44,11 +45,22 @@ auto segments_(V &&v) {
     // need to reverse engineer `n` which was passed to sliding_view
     elements_to_take = rng::size(v);
     const auto slide_size = elements_to_skip_in_base - elements_to_take + 1;
-    // TODO: this code assumes that halo is symmetric, thus odd (center + 2n)
-    // note, it is not an assertion preventing all wrong use cases
-    // other ones are caught by assert during attempt to read outside halo
-    assert(slide_size % 2 == 1);
+    // A window belongs to the segment of its center. A window that
+    // covers exactly the halo can be asymmetric, and its center is
+    // halo.prev elements from its beginning. Otherwise the window must
+    // be symmetric, thus odd (center + 2n). Note, it is not an
+    // assertion preventing all wrong use cases, other ones are caught
+    // by assert during attempt to read outside halo
     elements_to_skip_in_base = slide_size / 2;
+    [[maybe_unused]] bool asymmetric = false;
+    if constexpr (requires { rng::begin(base_segments[0]).halo_bounds(); }) {
+      auto hb = rng::begin(base_segments[0]).halo_bounds();
+      if (hb.prev + hb.next + 1 == slide_size) {
+        elements_to_skip_in_base = hb.prev;
+        asymmetric = true;
+      }
+    }
+    assert(asymmetric || slide_size % 2 == 1);
   }
 
   return dr::mhp::views::segmented(
@@ -0,0 +1,150 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <bit>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include <dr/detail/communicator.hpp>
+#include <dr/detail/logger.hpp>
+
+namespace dr::mhp::__detail {
+
+//
+// Pool of pre-registered RMA windows. Containers sub-allocate their
+// storage from large arenas instead of creating a window each, so
+// constructing and destroying a container does not require collective
+// synchronization.
+//
+// Containers are constructed and destroyed collectively, in the same
+// order on every rank, and the request size is the same on every
+// rank. The pool is deterministic, so every rank hands out the same
+// offset for a request and no communication is needed to agree on
+// it. Growing the pool is the only collective operation, and every
+// rank reaches it for the same request.
+//
+// A released block may still be the target of RMA issued before the
+// release. It is not reused until the next synchronization (see
+// reclaim()).
+//
+class window_pool {
+public:
+  struct block {
+    dr::rma_window win;
+    void *data = nullptr;
+    std::size_t size_class = 0;
+    std::size_t arena = 0;
+  };
+
+  window_pool(std::size_t arena_size = default_arena_size)
+      : arena_size_(arena_size) {}
+
+  // Destructor frees windows, so cannot copy
+  window_pool(const window_pool &) = delete;
+  window_pool &operator=(const window_pool &) = delete;
+
+  ~window_pool() {
+    assert(rng::empty(arenas_) && "Call free() before delete");
+  }
+
+  /// Size of the block used for a request of size bytes
+  static std::size_t size_class(std::size_t size) {
+    return std::bit_ceil(std::max(size, min_block_size));
+  }
+
+  /// True if a request of size bytes is served by the pool
+  bool pooled(std::size_t size) const {
+    return size > 0 && size_class(size) <= arena_size_ / max_blocks_fraction;
+  }
+
+  /// Allocate from free blocks or unused arena space. Not collective.
+  std::optional<block> allocate(std::size_t size) {
+    assert(pooled(size));
+    auto sc = size_class(size);
+
+    auto &free_list = free_[sc];
+    if (!rng::empty(free_list)) {
+      auto b = free_list.back();
+      free_list.pop_back();
+      drlog.debug("window pool: reuse {} bytes arena: {}\n", sc, b.arena);
+      return b;
+    }
+
+    // Bump allocate. Offsets are multiples of the size class, so
+    // blocks are aligned for any element type.
+    for (std::size_t i = 0; i < rng::size(arenas_); i++) {
+      auto &a = arenas_[i];
+      auto offset = (a.used + sc - 1) / sc * sc;
+      if (offset + sc <= arena_size_) {
+        a.used = offset + sc;
+        drlog.debug("window pool: new {} bytes arena: {} offset: {}\n", sc, i,
+                    offset);
+        auto win = a.win.subwindow(offset);
+        return block{win, win.local_data<void>(), sc, i};
+      }
+    }
+
+    return std::nullopt;
+  }
+
+  /// Add an arena. Collective.
+  MPI_Win grow(communicator comm) {
+    drlog.debug("window pool: grow to {} arenas\n", rng::size(arenas_) + 1);
+    arena a;
+    a.win.allocate(comm, arena_size_);
+    a.win.fence();
+    arenas_.push_back(a);
+    return a.win.mpi_win();
+  }
+
+  /// Return a block to the pool. Not collective.
+  void release(const block &b) { pending_.push_back(b); }
+
+  /// Released blocks that cannot be reused before the next fence
+  bool pending() const { return !rng::empty(pending_); }
+
+  /// Make released blocks available for reuse. Call after all RMA
+  /// targeting the released blocks has completed.
+  void reclaim() {
+    for (auto &b : pending_) {
+      free_[b.size_class].push_back(b);
+    }
+    pending_.clear();
+  }
+
+  /// Free all arenas. Collective.
+  void free() {
+    for (auto &a : arenas_) {
+      a.win.fence();
+      a.win.free();
+    }
+    arenas_.clear();
+    free_.clear();
+    pending_.clear();
+  }
+
+  static constexpr std::size_t default_arena_size = 64 * 1024 * 1024;
+
+private:
+  // Smallest block, keeps blocks cache line aligned
+  static constexpr std::size_t min_block_size = 256;
+  // Requests larger than arena_size_ / max_blocks_fraction get their
+  // own window
+  static constexpr std::size_t max_blocks_fraction = 4;
+
+  struct arena {
+    dr::rma_window win;
+    std::size_t used = 0;
+  };
+
+  std::size_t arena_size_;
+  std::vector<arena> arenas_;
+  std::map<std::size_t, std::vector<block>> free_;
+  std::vector<block> pending_;
+};
+
+} // namespace dr::mhp::__detail
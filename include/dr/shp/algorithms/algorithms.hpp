@@ -9,6 +9,7 @@
 #include <dr/shp/algorithms/execution_policy.hpp>
 #include <dr/shp/algorithms/fill.hpp>
 #include <dr/shp/algorithms/for_each.hpp>
+#include <dr/shp/algorithms/generate_random.hpp>
 #include <dr/shp/algorithms/inclusive_scan.hpp>
 #include <dr/shp/algorithms/iota.hpp>
 #include <dr/shp/algorithms/matrix/matrix_algorithms.hpp>
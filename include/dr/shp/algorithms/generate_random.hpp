@@ -0,0 +1,37 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#pragma once
+
+#include <cstdint>
+
+#include <dr/concepts/concepts.hpp>
+#include <dr/detail/random.hpp>
+#include <dr/detail/ranges_shim.hpp>
+#include <dr/shp/algorithms/for_each.hpp>
+#include <dr/views/iota.hpp>
+
+namespace dr::shp {
+
+// Fills r with random values from dist, like mhp::generate_random. The
+// values are the same as mhp for the same seed.
+template <dr::distributed_range R, typename D>
+void generate_random(R &&r, const D &dist, std::uint64_t seed) {
+  dr::__detail::counter_distribution<D> counter_dist(dist);
+  auto key = dr::__detail::random_key(seed);
+  auto indices =
+      rng::views::iota(std::uint64_t(0), std::uint64_t(rng::distance(r)));
+
+  for_each(par_unseq, views::zip(indices, r), [=](auto &&elem) {
+    auto &&[i, v] = elem;
+    v = dr::__detail::random_value(counter_dist, key, i);
+  });
+}
+
+template <dr::distributed_iterator Iter, typename D>
+void generate_random(Iter begin, Iter end, const D &dist, std::uint64_t seed) {
+  generate_random(rng::subrange(begin, end), dist, seed);
+}
+
+} // namespace dr::shp
@@ -0,0 +1,65 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+// Fixture
+template <typename DistVecT> class GenerateRandomTest : public testing::Test {
+public:
+};
+
+TYPED_TEST_SUITE(GenerateRandomTest, AllTypes);
+
+// Values of n elements computed on one rank
+template <typename DistVecT, typename D>
+auto serial_random(std::size_t n, const D &dist, std::uint64_t seed) {
+  dr::__detail::counter_distribution<D> counter_dist(dist);
+  auto key = dr::__detail::random_key(seed);
+  LocalVec<DistVecT> v(n);
+  for (std::size_t i = 0; i < n; i++) {
+    v[i] = dr::__detail::random_value(counter_dist, key, i);
+  }
+  return v;
+}
+
+TYPED_TEST(GenerateRandomTest, Range) {
+  using T = typename TypeParam::value_type;
+  std::uniform_int_distribution<T> dist(-50, 50);
+  TypeParam v(23);
+  xhp::generate_random(v, dist, 7);
+  EXPECT_EQ(serial_random<TypeParam>(23, dist, 7), v);
+}
+
+TYPED_TEST(GenerateRandomTest, Iter) {
+  using T = typename TypeParam::value_type;
+  std::uniform_int_distribution<T> dist(0, 1000);
+  TypeParam v(23, 99);
+  xhp::generate_random(v.begin() + 3, v.end(), dist, 7);
+
+  // Element i of the subrange gets the value of element i of a range
+  auto expected = serial_random<TypeParam>(20, dist, 7);
+  expected.insert(expected.begin(), 3, 99);
+  EXPECT_EQ(expected, v);
+}
+
+TYPED_TEST(GenerateRandomTest, Seed) {
+  using T = typename TypeParam::value_type;
+  std::uniform_int_distribution<T> dist(0, 1000000);
+  TypeParam v0(23), v1(23);
+  xhp::generate_random(v0, dist, 7);
+  xhp::generate_random(v1, dist, 8);
+  EXPECT_FALSE(is_equal(v0, v1));
+}
+
+TEST(GenerateRandom, Philox) {
+  // Known answers of Philox4x32-10
+  dr::__detail::philox_counter expected = {0x6627e8d5, 0xe169c58d, 0xbc57ac4c,
+                                           0x9b00dbd8};
+  EXPECT_EQ(expected, dr::__detail::philox4x32({0, 0, 0, 0}, {0, 0}));
+  expected = {0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1};
+  EXPECT_EQ(expected,
+            dr::__detail::philox4x32(
+                {0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344},
+                {0xa4093822, 0x299f31d0}));
+}
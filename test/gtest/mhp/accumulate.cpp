@@ -0,0 +1,99 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+// Fixture
+
+template <typename T> class AccumulateMHP : public testing::Test {
+public:
+};
+
+TYPED_TEST_SUITE(AccumulateMHP, AllTypes);
+
+TYPED_TEST(AccumulateMHP, Dense) {
+  Ops1<TypeParam> ops(100);
+
+  // Every rank updates every element, in reverse order
+  std::vector<std::size_t> indices;
+  std::vector<typename TypeParam::value_type> values;
+  for (std::size_t i = ops.vec.size(); i-- > 0;) {
+    indices.push_back(i);
+    values.push_back(i);
+  }
+
+  dr::mhp::accumulate_at(ops.dist_vec, indices, values);
+
+  for (std::size_t i = 0; i < ops.vec.size(); i++) {
+    ops.vec[i] += comm_size * i;
+  }
+  EXPECT_TRUE(equal(ops.vec, ops.dist_vec));
+}
+
+TYPED_TEST(AccumulateMHP, Sparse) {
+  Ops1<TypeParam> ops(100);
+
+  // A few scattered indices with duplicates on every rank
+  std::vector<std::size_t> indices = {97, 3, 50, 3, comm_rank};
+  std::vector<typename TypeParam::value_type> values = {1, 2, 3, 4, 5};
+
+  dr::mhp::accumulate_at(ops.dist_vec, indices, values);
+
+  for (std::size_t i = 0; i < comm_size; i++) {
+    ops.vec[97] += 1;
+    ops.vec[3] += 2 + 4;
+    ops.vec[50] += 3;
+    ops.vec[i] += 5;
+  }
+  EXPECT_TRUE(equal(ops.vec, ops.dist_vec));
+}
+
+TYPED_TEST(AccumulateMHP, Max) {
+  Ops1<TypeParam> ops(20);
+
+  std::vector<std::size_t> indices = {5, 5, 17};
+  std::vector<typename TypeParam::value_type> values = {
+      1000 + int(comm_rank), 0, 50};
+  auto max = [](auto a, auto b) { return std::max(a, b); };
+
+  dr::mhp::accumulate_at(ops.dist_vec, indices, values, max);
+
+  ops.vec[5] = 1000 + comm_size - 1;
+  EXPECT_TRUE(equal(ops.vec, ops.dist_vec));
+}
+
+TYPED_TEST(AccumulateMHP, Histogram) {
+  TypeParam dv(100);
+  dr::mhp::iota(dv, 0);
+  // Bin is value % 7, and some values are out of range
+  dr::mhp::for_each(dv, [](auto &v) { v = v % 8; });
+  TypeParam bins(7);
+  dr::mhp::fill(bins, 0);
+
+  dr::mhp::histogram(dv, bins);
+
+  LocalVec<TypeParam> ref(7, 0);
+  for (std::size_t i = 0; i < 100; i++) {
+    if (i % 8 < 7) {
+      ref[i % 8]++;
+    }
+  }
+  EXPECT_TRUE(equal(ref, bins));
+}
+
+TYPED_TEST(AccumulateMHP, HistogramManyBins) {
+  TypeParam dv(10);
+  dr::mhp::iota(dv, 0);
+  dr::mhp::for_each(dv, [](auto &v) { v = v * 9 % 100; });
+  TypeParam bins(100);
+  dr::mhp::fill(bins, 1);
+
+  dr::mhp::histogram(dv, bins);
+
+  LocalVec<TypeParam> ref(100, 1);
+  for (std::size_t i = 0; i < 10; i++) {
+    ref[i * 9 % 100]++;
+  }
+  EXPECT_TRUE(equal(ref, bins));
+}
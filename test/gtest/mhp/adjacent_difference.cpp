@@ -0,0 +1,125 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include <chrono>
+#include <thread>
+
+#include "xhp-tests.hpp"
+
+// Fixture
+template <typename T> class AdjacentMHP : public testing::Test {
+public:
+};
+
+TYPED_TEST_SUITE(AdjacentMHP, AllTypes);
+
+// Values are runs of 3 equal values, with a few values out of order
+void runs_of_3(auto &ops) {
+  auto third = [](auto &x) { x = x % 7 == 0 ? 0 : x / 3; };
+  dr::mhp::for_each(ops.dist_vec, third);
+  rng::for_each(ops.vec, third);
+}
+
+TYPED_TEST(AdjacentMHP, AdjacentDifference) {
+  Ops1<TypeParam> ops(23);
+  runs_of_3(ops);
+  TypeParam dist_out(23);
+  LocalVec<TypeParam> out(23);
+
+  std::adjacent_difference(ops.vec.begin(), ops.vec.end(), out.begin());
+  auto dist_end = dr::mhp::adjacent_difference(ops.dist_vec, dist_out.begin());
+  EXPECT_EQ(dist_out.end(), dist_end);
+  EXPECT_EQ(out, dist_out);
+
+  // In place
+  dr::mhp::adjacent_difference(ops.dist_vec, ops.dist_vec.begin());
+  EXPECT_EQ(out, ops.dist_vec);
+}
+
+TYPED_TEST(AdjacentMHP, AdjacentDifferenceInPlaceLate) {
+  // Without a halo, a rank reads the element in front of its segment
+  // from the rank that owns it. The odd ranks start late, so they would
+  // read elements that the even ranks already overwrote, unless the
+  // reads finish before the writes on every rank.
+  std::size_t n = 5 * comm_size;
+  Ops1<TypeParam> ops(n);
+  LocalVec<TypeParam> out(n);
+  std::adjacent_difference(ops.vec.begin(), ops.vec.end(), out.begin());
+
+  if (comm_rank % 2) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  }
+  dr::mhp::adjacent_difference(ops.dist_vec, ops.dist_vec.begin());
+  EXPECT_EQ(out, ops.dist_vec);
+}
+
+TYPED_TEST(AdjacentMHP, AdjacentDifferenceHalo) {
+  Ops1<TypeParam> ops(23);
+  TypeParam dist_vec(23, dr::mhp::distribution().halo(1));
+  dr::mhp::copy(ops.dist_vec, dist_vec.begin());
+  TypeParam dist_out(23);
+  LocalVec<TypeParam> out(23);
+
+  std::adjacent_difference(ops.vec.begin(), ops.vec.end(), out.begin(),
+                           std::plus<>());
+  dr::mhp::adjacent_difference(dist_vec, dist_out.begin(), std::plus<>());
+  EXPECT_EQ(out, dist_out);
+}
+
+TYPED_TEST(AdjacentMHP, IsSorted) {
+  Ops1<TypeParam> ops(23);
+  EXPECT_TRUE(dr::mhp::is_sorted(ops.dist_vec));
+  EXPECT_EQ(ops.dist_vec.end(), dr::mhp::is_sorted_until(ops.dist_vec));
+
+  runs_of_3(ops);
+  auto until = std::is_sorted_until(ops.vec.begin(), ops.vec.end());
+  EXPECT_EQ(until - ops.vec.begin(),
+            dr::mhp::is_sorted_until(ops.dist_vec) - ops.dist_vec.begin());
+  EXPECT_FALSE(dr::mhp::is_sorted(ops.dist_vec));
+}
+
+TYPED_TEST(AdjacentMHP, RunLengthEncode) {
+  Ops1<TypeParam> ops(23);
+  runs_of_3(ops);
+  TypeParam dist_values(23), dist_counts(23);
+  LocalVec<TypeParam> values, counts;
+
+  for (std::size_t i = 0; i < 23; i++) {
+    if (i > 0 && ops.vec[i - 1] == ops.vec[i]) {
+      counts.back()++;
+    } else {
+      values.push_back(ops.vec[i]);
+      counts.push_back(1);
+    }
+  }
+  auto [values_end, counts_end] = dr::mhp::run_length_encode(
+      ops.dist_vec, dist_values.begin(), dist_counts.begin());
+  EXPECT_TRUE(
+      is_equal(values, rng::subrange(dist_values.begin(), values_end)));
+  EXPECT_TRUE(
+      is_equal(counts, rng::subrange(dist_counts.begin(), counts_end)));
+}
+
+TYPED_TEST(AdjacentMHP, Rolling) {
+  Ops1<TypeParam> ops(23);
+  runs_of_3(ops);
+  TypeParam dist_out(23);
+
+  for (std::size_t w : {1, 4, 9, 30}) {
+    LocalVec<TypeParam> max(23), min(23), mean(23);
+    for (std::size_t i = 0; i < 23; i++) {
+      auto first = ops.vec.begin() + (i + 1 >= w ? i + 1 - w : 0);
+      auto last = ops.vec.begin() + i + 1;
+      max[i] = *std::max_element(first, last);
+      min[i] = *std::min_element(first, last);
+      mean[i] = std::accumulate(first, last, 0) / (last - first);
+    }
+    dr::mhp::rolling_max(ops.dist_vec, dist_out.begin(), w);
+    EXPECT_EQ(max, dist_out) << w;
+    dr::mhp::rolling_min(ops.dist_vec, dist_out.begin(), w);
+    EXPECT_EQ(min, dist_out) << w;
+    dr::mhp::rolling_mean(ops.dist_vec, dist_out.begin(), w);
+    EXPECT_EQ(mean, dist_out) << w;
+  }
+}
@@ -63,3 +63,29 @@ TEST(Communicator, Allgather) {
 
   EXPECT_TRUE(equal(vec_ref, vec_dst));
 }
+
+TEST(Communicator, Split) {
+  auto comm = dr::mhp::default_comm();
+  // Even and odd ranks, in reverse order
+  auto sub = comm.split(comm_rank % 2, comm_size - comm_rank);
+
+  EXPECT_EQ((comm_size - comm_rank % 2 + 1) / 2, sub.size());
+  EXPECT_EQ(sub.size() - 1 - comm_rank / 2, sub.rank());
+  sub.free();
+}
+
+TEST(Communicator, ProcessGrid) {
+  dr::process_grid grid(dr::mhp::default_comm());
+  EXPECT_EQ(comm_size, grid.rows() * grid.columns());
+  EXPECT_EQ(comm_rank, grid.row() * grid.columns() + grid.column());
+  EXPECT_EQ(grid.columns(), grid.row_comm().size());
+  EXPECT_EQ(grid.column(), grid.row_comm().rank());
+  EXPECT_EQ(grid.rows(), grid.column_comm().size());
+  EXPECT_EQ(grid.row(), grid.column_comm().rank());
+
+  // Sum of the ranks in my grid row
+  std::size_t sum = grid.row_comm().all_reduce(comm_rank, MPI_SUM);
+  std::size_t first = grid.row() * grid.columns();
+  EXPECT_EQ(grid.columns() * first + grid.columns() * (grid.columns() - 1) / 2,
+            sum);
+}
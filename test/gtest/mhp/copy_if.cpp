@@ -0,0 +1,69 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+// Fixture
+template <typename T> class CopyIfMHP : public testing::Test {
+public:
+};
+
+TYPED_TEST_SUITE(CopyIfMHP, AllTypes);
+
+TYPED_TEST(CopyIfMHP, CopyIf) {
+  Ops2<TypeParam> ops(23);
+  auto odd = [](auto x) { return x % 2 == 1; };
+
+  auto end = rng::copy_if(ops.vec0, ops.vec1.begin(), odd).out;
+  auto dist_end = dr::mhp::copy_if(ops.dist_vec0, ops.dist_vec1.begin(), odd);
+  EXPECT_EQ(end - ops.vec1.begin(), dist_end - ops.dist_vec1.begin());
+  EXPECT_EQ(ops.vec1, ops.dist_vec1);
+}
+
+TYPED_TEST(CopyIfMHP, CopyIfOffset) {
+  Ops2<TypeParam> ops(23);
+  auto big = [](auto x) { return x > 110; };
+
+  rng::copy_if(ops.vec0, ops.vec1.begin() + 3, big);
+  dr::mhp::copy_if(ops.dist_vec0, ops.dist_vec1.begin() + 3, big);
+  EXPECT_EQ(ops.vec1, ops.dist_vec1);
+}
+
+TYPED_TEST(CopyIfMHP, CopyIfNone) {
+  Ops2<TypeParam> ops(23);
+
+  auto dist_end = dr::mhp::copy_if(ops.dist_vec0, ops.dist_vec1.begin(),
+                                   [](auto) { return false; });
+  EXPECT_EQ(ops.dist_vec1.begin(), dist_end);
+  EXPECT_EQ(ops.vec1, ops.dist_vec1);
+}
+
+TYPED_TEST(CopyIfMHP, RemoveIf) {
+  Ops1<TypeParam> ops(23);
+  auto multiple_of_3 = [](auto x) { return x % 3 == 0; };
+
+  auto end = std::remove_if(ops.vec.begin(), ops.vec.end(), multiple_of_3);
+  auto dist_end = dr::mhp::remove_if(ops.dist_vec, multiple_of_3);
+  EXPECT_EQ(end - ops.vec.begin(), dist_end - ops.dist_vec.begin());
+  EXPECT_EQ(ops.vec, ops.dist_vec);
+}
+
+TYPED_TEST(CopyIfMHP, Remove) {
+  Ops1<TypeParam> ops(23);
+
+  auto end = std::remove(ops.vec.begin(), ops.vec.end(), 111);
+  auto dist_end = dr::mhp::remove(ops.dist_vec, 111);
+  EXPECT_EQ(end - ops.vec.begin(), dist_end - ops.dist_vec.begin());
+  EXPECT_EQ(ops.vec, ops.dist_vec);
+}
+
+TYPED_TEST(CopyIfMHP, Partition) {
+  Ops1<TypeParam> ops(23);
+  auto odd = [](auto x) { return x % 2 == 1; };
+
+  auto middle = std::stable_partition(ops.vec.begin(), ops.vec.end(), odd);
+  auto dist_middle = dr::mhp::partition(ops.dist_vec, odd);
+  EXPECT_EQ(middle - ops.vec.begin(), dist_middle - ops.dist_vec.begin());
+  EXPECT_EQ(ops.vec, ops.dist_vec);
+}
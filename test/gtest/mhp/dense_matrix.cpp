@@ -0,0 +1,83 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+using Matrix = dr::mhp::distributed_dense_matrix<double>;
+using Index = dr::index<>;
+
+// Small integers, so the products are exact
+static double a_value(std::size_t i, std::size_t l) {
+  return double((i + 2 * l) % 5);
+}
+static double b_value(std::size_t l, std::size_t j) {
+  return double((l * j) % 3) - 1;
+}
+
+template <typename F> static void fill_matrix(Matrix &x, F value) {
+  auto local = x.local_mdspan();
+  for (std::size_t i = 0; i < local.extent(0); i++) {
+    for (std::size_t j = 0; j < local.extent(1); j++) {
+      auto index = x.global_index({i, j});
+      local(i, j) = value(index[0], index[1]);
+    }
+  }
+}
+
+static void check_gemm(std::size_t m, std::size_t n, std::size_t k,
+                       Index a_tile, Index b_tile, Index c_tile) {
+  Matrix a({m, k}, a_tile), b({k, n}, b_tile), c({m, n}, c_tile);
+  fill_matrix(a, a_value);
+  fill_matrix(b, b_value);
+  fill_matrix(c, [](auto, auto) { return -1.0; });
+
+  dr::mhp::gemm(a, b, c);
+
+  auto local = c.local_mdspan();
+  for (std::size_t i = 0; i < local.extent(0); i++) {
+    for (std::size_t j = 0; j < local.extent(1); j++) {
+      auto index = c.global_index({i, j});
+      double ref = 0;
+      for (std::size_t l = 0; l < k; l++) {
+        ref += a_value(index[0], l) * b_value(l, index[1]);
+      }
+      EXPECT_EQ(ref, local(i, j))
+          << fmt::format("i: {} j: {}\n", index[0], index[1]);
+    }
+  }
+}
+
+TEST(MhpTests, DenseMatrixDistribution) {
+  std::size_t m = 23, n = 17;
+  Matrix a({m, n}, {4, 3});
+
+  // Every element is stored once, on the rank that owns its tile
+  auto local = a.local_shape();
+  std::size_t elements = local[0] * local[1];
+  EXPECT_EQ(m * n, dr::mhp::default_comm().all_reduce(elements, MPI_SUM));
+  for (std::size_t i = 0; i < local[0]; i++) {
+    for (std::size_t j = 0; j < local[1]; j++) {
+      auto index = a.global_index({i, j});
+      EXPECT_LT(index[0], m);
+      EXPECT_LT(index[1], n);
+      EXPECT_EQ(comm_rank, a.rank(index));
+    }
+  }
+}
+
+TEST(MhpTests, DenseMatrixGemmBlock) {
+  auto div = dr::mhp::tile::div;
+  check_gemm(17, 13, 29, {div, div}, {div, div}, {div, div});
+}
+
+TEST(MhpTests, DenseMatrixGemmBlockCyclic) {
+  // Tiles of a and b along k do not line up
+  check_gemm(40, 50, 60, {7, 11}, {3, 5}, {7, 5});
+}
+
+TEST(MhpTests, DenseMatrixGemmLarge) {
+  // More than one panel per tile
+  auto div = dr::mhp::tile::div;
+  check_gemm(70, 90, 300, {div, div}, {div, div}, {div, div});
+}
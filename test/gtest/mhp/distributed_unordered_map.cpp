@@ -0,0 +1,113 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+using DUM = dr::mhp::distributed_unordered_map<long, long>;
+
+// Every rank inserts n different keys: i * comm_size + comm_rank -> i
+static auto insert_keys(DUM &map, long n) {
+  std::vector<std::pair<long, long>> pairs;
+  for (long i = 0; i < n; i++) {
+    pairs.emplace_back(i * comm_size + comm_rank, i);
+  }
+  map.insert(pairs);
+}
+
+TEST(MhpTests, DistributedUnorderedMapInsertFind) {
+  DUM map;
+  EXPECT_TRUE(map.empty());
+  insert_keys(map, 100);
+  EXPECT_EQ(100 * comm_size, map.size());
+
+  // Every rank looks up all keys, and a few that are missing
+  std::vector<long> keys;
+  for (long k = 0; k < long(100 * comm_size) + 5; k++) {
+    keys.push_back(k);
+  }
+  auto found = map.find(keys);
+  ASSERT_EQ(keys.size(), found.size());
+  for (std::size_t i = 0; i < keys.size(); i++) {
+    if (keys[i] < long(100 * comm_size)) {
+      ASSERT_TRUE(found[i].has_value());
+      EXPECT_EQ(keys[i] / long(comm_size), *found[i]);
+    } else {
+      EXPECT_FALSE(found[i].has_value());
+    }
+  }
+
+  // Inserting an existing key keeps the value
+  std::vector<std::pair<long, long>> again = {{0, 1000}};
+  map.insert(again);
+  EXPECT_EQ(100 * comm_size, map.size());
+  EXPECT_EQ(0, *map.find(std::vector<long>{0})[0]);
+}
+
+TEST(MhpTests, DistributedUnorderedMapUpsert) {
+  DUM map;
+
+  // Count words, every rank sees every word with duplicates
+  std::vector<std::pair<long, long>> words;
+  for (long i = 0; i < 300; i++) {
+    words.emplace_back(i % 30, 1);
+  }
+  map.upsert(words, std::plus<>{});
+  map.upsert(words, std::plus<>{});
+
+  EXPECT_EQ(30, map.size());
+  std::vector<long> keys(30);
+  rng::iota(keys, 0);
+  for (auto count : map.find(keys)) {
+    EXPECT_EQ(long(20 * comm_size), *count);
+  }
+}
+
+TEST(MhpTests, DistributedUnorderedMapErase) {
+  DUM map;
+  insert_keys(map, 50);
+
+  // Only rank 0 erases, including keys that are missing
+  std::vector<long> keys;
+  if (comm_rank == 0) {
+    for (long k = 0; k < long(10 * comm_size); k++) {
+      keys.push_back(k);
+      keys.push_back(k + 1000000);
+    }
+  }
+  EXPECT_EQ(10 * comm_size, map.erase(keys));
+  EXPECT_EQ(40 * comm_size, map.size());
+
+  std::vector<long> all(50 * comm_size);
+  rng::iota(all, 0);
+  auto found = map.find(all);
+  for (std::size_t k = 0; k < all.size(); k++) {
+    EXPECT_EQ(k >= 10 * comm_size, found[k].has_value());
+  }
+
+  map.clear();
+  EXPECT_TRUE(map.empty());
+}
+
+TEST(MhpTests, DistributedUnorderedMapAlgorithms) {
+  DUM map;
+  insert_keys(map, 100);
+
+  // Segments hold the local entries
+  std::size_t local_size = 0;
+  for (auto &&segment : dr::mhp::local_segments(map)) {
+    for (auto &[key, value] : segment) {
+      EXPECT_EQ(comm_rank, map.rank(key));
+      local_size++;
+    }
+  }
+  EXPECT_EQ(map.size(),
+            dr::mhp::default_comm().all_reduce(local_size, MPI_SUM));
+
+  dr::mhp::for_each(map, [](auto &entry) { entry.second *= 2; });
+
+  auto values =
+      dr::mhp::views::transform(map, [](auto &&entry) { return entry.second; });
+  // Every rank inserted 0..99, doubled
+  EXPECT_EQ(long(comm_size) * 99 * 100, dr::mhp::reduce(values));
+}
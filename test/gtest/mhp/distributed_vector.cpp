@@ -113,3 +113,44 @@ TEST(MhpTests, DistributedVectorGranularity) {
     previous_size = segment.size();
   }
 }
+
+TEST(MhpTests, DistributedVectorTemporaries) {
+  const std::size_t n = 10;
+  DV dv(n);
+  dr::mhp::iota(dv, 100);
+
+  // Short-lived vectors share pooled windows with dv
+  for (std::size_t i = 0; i < 100; i++) {
+    DV tmp(n + i, 7);
+    EXPECT_EQ(tmp[n + i - 1], 7);
+    dr::mhp::fence();
+  }
+
+  if (comm_rank == 0) {
+    dv[2] = 2;
+  }
+  dr::mhp::fence();
+  EXPECT_EQ(dv[2], 2);
+  EXPECT_EQ(dv[n - 1], 100 + n - 1);
+}
+
+TEST(MhpTests, DistributedVectorFence) {
+  const std::size_t n = 10;
+  DV dv(n), other(n, 5);
+
+  if (comm_rank == 0) {
+    for (std::size_t i = 0; i < n; i++) {
+      dv[i] = i + 10;
+    }
+  }
+  // Only synchronizes dv
+  dv.fence();
+
+  for (std::size_t i = 0; i < n; i++) {
+    EXPECT_EQ(dv[i], i + 10);
+  }
+
+  // Nothing written since the last fence
+  dr::mhp::fence();
+  EXPECT_EQ(other[n - 1], 5);
+}
@@ -0,0 +1,74 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+using C = std::complex<double>;
+using Mdarray3 = dr::mhp::distributed_mdarray<C, 3>;
+
+static C input(std::size_t i, std::size_t j, std::size_t k) {
+  return C(std::sin(1.3 * i + 0.7 * j + 0.1 * k),
+           std::cos(0.5 * i + 0.3 * j * k));
+}
+
+static void fill_input(Mdarray3 &a) {
+  if (comm_rank == 0) {
+    for (std::size_t i = 0; i < a.extent(0); i++) {
+      for (std::size_t j = 0; j < a.extent(1); j++) {
+        for (std::size_t k = 0; k < a.extent(2); k++) {
+          a.mdspan()(i, j, k) = input(i, j, k);
+        }
+      }
+    }
+  }
+  dr::mhp::fence();
+}
+
+// Naive DFT of one element
+static C dft(std::array<std::size_t, 3> shape, std::size_t k0, std::size_t k1,
+             std::size_t k2) {
+  auto [n0, n1, n2] = shape;
+  C sum = 0;
+  for (std::size_t i = 0; i < n0; i++) {
+    for (std::size_t j = 0; j < n1; j++) {
+      for (std::size_t k = 0; k < n2; k++) {
+        double phase = double(i * k0 % n0) / n0 + double(j * k1 % n1) / n1 +
+                       double(k * k2 % n2) / n2;
+        sum += input(i, j, k) * std::polar(1.0, -2 * std::numbers::pi * phase);
+      }
+    }
+  }
+  return sum;
+}
+
+static void check_fft(std::array<std::size_t, 3> shape) {
+  auto [n0, n1, n2] = shape;
+  Mdarray3 in(shape), out({n1, n0, n2}), back(shape);
+  fill_input(in);
+
+  dr::mhp::fft(in, out);
+  for (std::size_t k1 = 0; k1 < n1; k1++) {
+    for (std::size_t k0 = 0; k0 < n0; k0++) {
+      for (std::size_t k2 = 0; k2 < n2; k2++) {
+        C value = out.mdspan()(k1, k0, k2);
+        EXPECT_NEAR(0, std::abs(dft(shape, k0, k1, k2) - value), 1e-10)
+            << fmt::format("k: {} {} {}\n", k0, k1, k2);
+      }
+    }
+  }
+
+  dr::mhp::fft(out, back, false);
+  for (std::size_t i = 0; i < n0; i++) {
+    for (std::size_t j = 0; j < n1; j++) {
+      for (std::size_t k = 0; k < n2; k++) {
+        C value = back.mdspan()(i, j, k);
+        EXPECT_NEAR(0, std::abs(input(i, j, k) - value), 1e-12);
+      }
+    }
+  }
+}
+
+TEST(MhpTests, FftPowerOfTwo) { check_fft({8, 4, 16}); }
+
+TEST(MhpTests, FftMixedRadix) { check_fft({6, 9, 5}); }
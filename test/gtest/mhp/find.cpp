@@ -0,0 +1,67 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+// Fixture
+template <typename T> class FindMHP : public testing::Test {
+public:
+};
+
+TYPED_TEST_SUITE(FindMHP, AllTypes);
+
+TYPED_TEST(FindMHP, FindIf) {
+  Ops1<TypeParam> ops(23);
+  auto ge = [](auto v) { return [v](auto x) { return x >= v; }; };
+
+  for (int v : {100, 107, 111, 122, 123}) {
+    auto expected = rng::find_if(ops.vec, ge(v)) - ops.vec.begin();
+    auto actual = dr::mhp::find_if(ops.dist_vec, ge(v));
+    EXPECT_EQ(expected, actual - ops.dist_vec.begin()) << v;
+  }
+}
+
+TYPED_TEST(FindMHP, Find) {
+  Ops1<TypeParam> ops(23);
+
+  EXPECT_EQ(ops.dist_vec.begin() + 12, dr::mhp::find(ops.dist_vec, 112));
+  EXPECT_EQ(ops.dist_vec.end(), dr::mhp::find(ops.dist_vec, 99));
+}
+
+TYPED_TEST(FindMHP, AnyAllNone) {
+  Ops1<TypeParam> ops(23);
+  auto odd = [](auto x) { return x % 2 == 1; };
+  auto positive = [](auto x) { return x > 0; };
+
+  EXPECT_TRUE(dr::mhp::any_of(ops.dist_vec, odd));
+  EXPECT_FALSE(dr::mhp::all_of(ops.dist_vec, odd));
+  EXPECT_TRUE(dr::mhp::all_of(ops.dist_vec, positive));
+  EXPECT_TRUE(dr::mhp::none_of(ops.dist_vec, [](auto x) { return x > 122; }));
+}
+
+TYPED_TEST(FindMHP, Count) {
+  Ops1<TypeParam> ops(23);
+  auto odd = [](auto x) { return x % 2 == 1; };
+
+  EXPECT_EQ(rng::count_if(ops.vec, odd),
+            long(dr::mhp::count_if(ops.dist_vec, odd)));
+  EXPECT_EQ(1, int(dr::mhp::count(ops.dist_vec, 105)));
+}
+
+TYPED_TEST(FindMHP, MismatchEqual) {
+  Ops2<TypeParam> ops(23);
+  dr::mhp::copy(ops.dist_vec0, ops.dist_vec1.begin());
+
+  EXPECT_TRUE(dr::mhp::equal(ops.dist_vec0, ops.dist_vec1));
+  auto [end0, end1] = dr::mhp::mismatch(ops.dist_vec0, ops.dist_vec1);
+  EXPECT_EQ(ops.dist_vec0.end(), end0);
+  EXPECT_EQ(ops.dist_vec1.end(), end1);
+
+  ops.dist_vec1[17] = 0;
+  fence();
+  EXPECT_FALSE(dr::mhp::equal(ops.dist_vec0, ops.dist_vec1));
+  auto [it0, it1] = dr::mhp::mismatch(ops.dist_vec0, ops.dist_vec1);
+  EXPECT_EQ(17, it0 - ops.dist_vec0.begin());
+  EXPECT_EQ(17, it1 - ops.dist_vec1.begin());
+}
@@ -0,0 +1,86 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+// Fixture
+
+template <typename T> class GatherScatterMHP : public testing::Test {
+public:
+};
+
+TYPED_TEST_SUITE(GatherScatterMHP, AllTypes);
+
+TYPED_TEST(GatherScatterMHP, Gather) {
+  Ops1<TypeParam> ops(23);
+
+  // Different indices on every rank, with duplicates
+  std::vector<std::size_t> indices;
+  for (std::size_t i = 0; i < 50; i++) {
+    indices.push_back((i * 7 + comm_rank * 3) % ops.vec.size());
+  }
+
+  std::vector<typename TypeParam::value_type> result(indices.size());
+  dr::mhp::gather(ops.dist_vec, indices, result.begin());
+
+  for (std::size_t i = 0; i < indices.size(); i++) {
+    EXPECT_EQ(ops.vec[indices[i]], result[i]);
+  }
+}
+
+TYPED_TEST(GatherScatterMHP, GatherEmpty) {
+  Ops1<TypeParam> ops(10);
+
+  // Only rank 0 has indices
+  std::vector<std::size_t> indices;
+  if (comm_rank == 0) {
+    indices = {9, 0, 5};
+  }
+
+  std::vector<typename TypeParam::value_type> result(indices.size());
+  dr::mhp::gather(ops.dist_vec, indices, result.begin());
+
+  for (std::size_t i = 0; i < indices.size(); i++) {
+    EXPECT_EQ(ops.vec[indices[i]], result[i]);
+  }
+}
+
+TYPED_TEST(GatherScatterMHP, Scatter) {
+  Ops1<TypeParam> ops(23);
+
+  // Every rank writes a disjoint subset, in reverse order
+  std::vector<std::size_t> indices;
+  std::vector<typename TypeParam::value_type> values;
+  for (std::size_t i = ops.vec.size(); i-- > 0;) {
+    if (i % comm_size == comm_rank) {
+      indices.push_back(i);
+      values.push_back(1000 + i);
+    }
+  }
+
+  dr::mhp::scatter(values, indices, ops.dist_vec);
+
+  for (std::size_t i = 0; i < ops.vec.size(); i++) {
+    ops.vec[i] = 1000 + i;
+  }
+  EXPECT_TRUE(equal(ops.vec, ops.dist_vec));
+}
+
+TYPED_TEST(GatherScatterMHP, ScatterDuplicates) {
+  Ops1<TypeParam> ops(10);
+
+  // Last value for an index wins
+  std::vector<std::size_t> indices;
+  std::vector<typename TypeParam::value_type> values;
+  if (comm_rank == 0) {
+    indices = {3, 7, 3};
+    values = {1, 2, 3};
+  }
+
+  dr::mhp::scatter(values, indices, ops.dist_vec);
+
+  ops.vec[3] = 3;
+  ops.vec[7] = 2;
+  EXPECT_TRUE(equal(ops.vec, ops.dist_vec));
+}
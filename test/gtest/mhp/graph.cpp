@@ -0,0 +1,133 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+using Matrix = dr::mhp::sparse_matrix<double>;
+using Edges = std::vector<std::pair<std::size_t, std::size_t>>;
+
+// Symmetric adjacency matrix of an undirected graph
+static Matrix adjacency(std::size_t n, const Edges &edges) {
+  std::vector<std::tuple<std::size_t, std::size_t, double>> entries;
+  for (auto [i, j] : edges) {
+    entries.emplace_back(i, j, 1);
+    entries.emplace_back(j, i, 1);
+  }
+  return Matrix({n, n}, entries);
+}
+
+// A ring of the even vertices below 20 with a chord, a ring of the
+// odd vertices below 15, and 6 isolated vertices
+static Edges rings() {
+  Edges edges;
+  for (std::size_t i = 0; i < 10; i++) {
+    edges.emplace_back(2 * i, 2 * ((i + 1) % 10));
+  }
+  edges.emplace_back(0, 10);
+  for (std::size_t i = 0; i < 7; i++) {
+    edges.emplace_back(2 * i + 1, 2 * ((i + 1) % 7) + 1);
+  }
+  return edges;
+}
+
+TEST(MhpTests, GraphBfsPath) {
+  std::size_t n = 31, source = 12;
+  Edges edges;
+  for (std::size_t i = 0; i < n - 1; i++) {
+    edges.emplace_back(i, i + 1);
+  }
+  auto a = adjacency(n, edges);
+  dr::mhp::distributed_vector<std::size_t> levels(n);
+
+  dr::mhp::bfs(a, source, levels);
+  for (std::size_t i = 0; i < n; i++) {
+    EXPECT_EQ(i > source ? i - source : source - i, levels[i])
+        << "vertex: " << i;
+  }
+}
+
+TEST(MhpTests, GraphBfsDense) {
+  // Large frontiers switch to bottom up
+  std::size_t n = 64;
+  Edges edges;
+  for (std::size_t i = 0; i < n; i++) {
+    for (std::size_t j = i + 1; j < n; j++) {
+      if ((i * j) % 5 == 1 || j == i + 1) {
+        edges.emplace_back(i, j);
+      }
+    }
+  }
+  auto a = adjacency(n, edges);
+  dr::mhp::distributed_vector<std::size_t> levels(n);
+  dr::mhp::bfs(a, 0, levels);
+
+  // Serial reference
+  std::vector<std::size_t> ref(n, dr::mhp::bfs_unreached);
+  ref[0] = 0;
+  for (bool changed = true; changed;) {
+    changed = false;
+    for (auto [i, j] : edges) {
+      for (auto [u, v] : {std::pair(i, j), std::pair(j, i)}) {
+        if (ref[u] != dr::mhp::bfs_unreached && ref[u] + 1 < ref[v]) {
+          ref[v] = ref[u] + 1;
+          changed = true;
+        }
+      }
+    }
+  }
+  for (std::size_t i = 0; i < n; i++) {
+    EXPECT_EQ(ref[i], levels[i]) << "vertex: " << i;
+  }
+}
+
+TEST(MhpTests, GraphBfsUnreached) {
+  std::size_t n = 23;
+  auto a = adjacency(n, rings());
+  dr::mhp::distributed_vector<std::size_t> levels(n);
+
+  dr::mhp::bfs(a, 1, levels);
+  EXPECT_EQ(0, levels[1]);
+  EXPECT_EQ(1, levels[3]);
+  EXPECT_EQ(1, levels[13]);
+  EXPECT_EQ(dr::mhp::bfs_unreached, levels[0]);
+  EXPECT_EQ(dr::mhp::bfs_unreached, levels[22]);
+}
+
+TEST(MhpTests, GraphConnectedComponents) {
+  std::size_t n = 23;
+  auto a = adjacency(n, rings());
+  dr::mhp::distributed_vector<std::size_t> components(n);
+
+  EXPECT_EQ(8, dr::mhp::connected_components(a, components));
+  for (std::size_t i = 0; i < n; i++) {
+    std::size_t component = i;
+    if (i % 2 == 0 && i < 20) {
+      component = 0;
+    } else if (i % 2 == 1 && i < 15) {
+      component = 1;
+    }
+    EXPECT_EQ(component, components[i]) << "vertex: " << i;
+  }
+}
+
+TEST(MhpTests, GraphPagerank) {
+  // Star: vertex 0 links to and from every other vertex
+  std::size_t n = 11;
+  Edges edges;
+  for (std::size_t i = 1; i < n; i++) {
+    edges.emplace_back(0, i);
+  }
+  auto a = adjacency(n, edges);
+  dr::mhp::distributed_vector<double> pr(n);
+
+  dr::mhp::pagerank(a, pr, 0.85, 1e-12, 1000);
+
+  // Fixed point of r0 = 0.15 / n + 0.85 * (1 - r0)
+  double center = (0.15 / n + 0.85) / 1.85;
+  double leaf = (1 - center) / (n - 1);
+  EXPECT_NEAR(center, pr[0], 1e-9);
+  for (std::size_t i = 1; i < n; i++) {
+    EXPECT_NEAR(leaf, pr[i], 1e-9);
+  }
+}
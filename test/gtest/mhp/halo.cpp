@@ -92,3 +92,88 @@ TYPED_TEST(Halo, local_is_accessible_in_halo_region_halo_10) {
 TYPED_TEST(Halo, local_is_accessible_in_halo_region_halo_01) {
   local_is_accessible_in_halo_region<TypeParam>(0, 1);
 }
+
+TYPED_TEST(Halo, group_exchange) {
+  if (options.count("device-memory")) {
+    return;
+  }
+  std::size_t segment = 10, n = segment * comm_size;
+  auto dist = dr::mhp::distribution().halo(1);
+  TypeParam a(n, dist), b(n, dist);
+  iota(a, 0);
+  iota(b, 100);
+
+  dr::mhp::halo_group group(a.halo(), b.halo());
+  group.exchange();
+
+  std::size_t first = comm_rank * segment;
+  std::size_t last = std::min(first + segment + 1, n);
+  for (std::size_t i = first == 0 ? 0 : first - 1; i < last; i++) {
+    EXPECT_EQ(int(i), *(a.begin() + i).local());
+    EXPECT_EQ(int(100 + i), *(b.begin() + i).local());
+  }
+}
+
+TYPED_TEST(Halo, reduce_accumulate) {
+  if (options.count("device-memory")) {
+    return;
+  }
+  std::size_t segment = 10, n = segment * comm_size;
+  TypeParam dv(n, dr::mhp::distribution().halo(1));
+  iota(dv, 0);
+  auto &halo = dv.halo();
+  halo.exchange();
+  halo.reduce_accumulate(halo.plus);
+
+  // The halo elements are added to the owned elements they copy
+  std::size_t first = comm_rank * segment, last = first + segment;
+  for (std::size_t i = first; i < last; i++) {
+    bool reduced = (i == first && comm_rank > 0) ||
+                   (i == last - 1 && comm_rank < comm_size - 1);
+    EXPECT_EQ(int(reduced ? 2 * i : i), *(dv.begin() + i).local());
+  }
+}
+
+TYPED_TEST(Halo, mdspan_faces) {
+  if (options.count("device-memory")) {
+    return;
+  }
+  using T = typename TypeParam::value_type;
+  using halo_type = dr::mhp::mdspan_halo<T, 2>;
+  using tag = dr::communicator::tag;
+
+  // Columns are distributed over a ring, with a ghost column on each
+  // side, so the faces are strided
+  std::size_t rows = 3, columns = 4, width = columns + 2;
+  std::size_t prev = (comm_rank + comm_size - 1) % comm_size;
+  std::size_t next = (comm_rank + 1) % comm_size;
+  auto value = [=](std::size_t rank, std::size_t i, std::size_t j) {
+    return T(100 * rank + 10 * i + j);
+  };
+
+  for (bool use_datatype : {true, false}) {
+    std::vector<T> a(rows * width, -1);
+    auto local = md::mdspan(a.data(), rows, width);
+    for (std::size_t i = 0; i < rows; i++) {
+      for (std::size_t j = 1; j <= columns; j++) {
+        local(i, j) = value(comm_rank, i, j);
+      }
+    }
+    auto column = [=](std::size_t j) {
+      return md::submdspan(local, std::tuple(0, rows), std::tuple(j, j + 1));
+    };
+
+    halo_type halo(dr::mhp::default_comm(),
+                   {{prev, column(1), tag::halo_reverse},
+                    {next, column(columns), tag::halo_forward}},
+                   {{prev, column(0), tag::halo_forward},
+                    {next, column(columns + 1), tag::halo_reverse}},
+                   use_datatype);
+    halo.exchange();
+
+    for (std::size_t i = 0; i < rows; i++) {
+      EXPECT_EQ(value(prev, i, columns), local(i, 0));
+      EXPECT_EQ(value(next, i, 1), local(i, columns + 1));
+    }
+  }
+}
@@ -261,6 +261,80 @@ TEST_F(Mdarray, Enumerate) {
   static_assert(dr::distributed_range<decltype(e)>);
 }
 
+static void check_transpose(auto &in, auto &out) {
+  for (std::size_t i = 0; i < in.extent(0); i++) {
+    for (std::size_t j = 0; j < in.extent(1); j++) {
+      EXPECT_EQ(in.mdspan()(i, j), out.mdspan()(j, i))
+          << fmt::format("i: {} j: {}\n", i, j);
+    }
+  }
+}
+
+TEST_F(Mdarray, Transpose) {
+  xhp::distributed_mdarray<T, 2> in(extents2d), out(extents2dt);
+  xhp::iota(in, 100);
+  xhp::fill(out, 0);
+
+  xhp::transpose(in, out);
+  check_transpose(in, out);
+}
+
+TEST_F(Mdarray, TransposeLarge) {
+  // Large enough to split the local tiles
+  std::array<std::size_t, 2> shape = {37, 301}, shape_t = {301, 37};
+  xhp::distributed_mdarray<T, 2> in(shape), out(shape_t), back(shape);
+  xhp::iota(in, 100);
+
+  xhp::transpose(in, out);
+  check_transpose(in, out);
+  xhp::transpose(out, back);
+  EXPECT_EQ(in, back);
+}
+
+TEST_F(Mdarray, ReduceAxis) {
+  xhp::distributed_mdarray<T, 3> in(extents3d);
+  xhp::iota(in, 100);
+  auto md = in.mdspan();
+
+  for (std::size_t axis = 0; axis < 3; axis++) {
+    auto out = xhp::reduce(in, xhp::axis{axis});
+    auto max = xhp::reduce(in, xhp::axis{axis},
+                           [](T a, T b) { return std::max(a, b); });
+    for (std::size_t i = 0; i < out.extent(0); i++) {
+      for (std::size_t j = 0; j < out.extent(1); j++) {
+        T sum = 0;
+        for (std::size_t k = 0; k < in.extent(axis); k++) {
+          std::array<std::size_t, 3> index = {i, j, k};
+          std::rotate(index.begin() + axis, index.begin() + 2, index.end());
+          sum += md(index);
+        }
+        EXPECT_EQ(sum, out.mdspan()(i, j))
+            << fmt::format("axis: {} i: {} j: {}\n", axis, i, j);
+        std::array<std::size_t, 3> last = {i, j, in.extent(axis) - 1};
+        std::rotate(last.begin() + axis, last.begin() + 2, last.end());
+        EXPECT_EQ(md(last), max.mdspan()(i, j));
+      }
+    }
+  }
+}
+
+TEST_F(Mdarray, ScanAxis) {
+  xhp::distributed_mdarray<T, 2> in(extents2d);
+  xhp::iota(in, 100);
+  auto md = in.mdspan();
+
+  auto rows = xhp::scan(in, xhp::axis{0});
+  auto cols = xhp::scan(in, xhp::axis{1});
+  for (std::size_t i = 0; i < xdim; i++) {
+    for (std::size_t j = 0; j < ydim; j++) {
+      T above = i == 0 ? 0 : rows.mdspan()(i - 1, j);
+      T left = j == 0 ? 0 : cols.mdspan()(i, j - 1);
+      EXPECT_EQ(above + md(i, j), rows.mdspan()(i, j));
+      EXPECT_EQ(left + md(i, j), cols.mdspan()(i, j));
+    }
+  }
+}
+
 using Submdspan = Mdspan;
 
 TEST_F(Submdspan, StaticAssert) {
@@ -429,6 +503,38 @@ TEST_F(MdForeach, Indexed) {
   }
 }
 
+TEST_F(MdForeach, Tiled) {
+  // Wide enough to split the rows into several tiles
+  std::array<std::size_t, 2> shape = {13, 4099};
+  xhp::distributed_mdarray<T, 2> a(shape), b(shape);
+  xhp::iota(a, 0);
+  auto op = [](auto index, auto v) {
+    auto &[in, out] = v;
+    out = in - index[0] * 4099 - index[1];
+  };
+
+  xhp::for_each(op, a, b);
+  EXPECT_EQ(0, xhp::reduce(b, 0, [](T x, T y) { return x | y; }));
+}
+
+TEST_F(MdForeach, Indexed3D) {
+  xhp::distributed_mdarray<T, 3> dist(extents3d);
+  auto op = [l = ydim * zdim, m = zdim](auto index, auto v) {
+    auto &[o] = v;
+    o = index[0] * l + index[1] * m + index[2];
+  };
+
+  xhp::for_each(op, dist);
+  for (std::size_t i = 0; i < xdim; i++) {
+    for (std::size_t j = 0; j < ydim; j++) {
+      for (std::size_t k = 0; k < zdim; k++) {
+        EXPECT_EQ(dist.mdspan()(i, j, k), i * ydim * zdim + j * zdim + k)
+            << fmt::format("i: {} j: {} k: {}\n", i, j, k);
+      }
+    }
+  }
+}
+
 using MdStencilForeach = Mdspan;
 
 TEST_F(MdStencilForeach, 2ops) {
@@ -465,6 +571,80 @@ TEST_F(MdStencilForeach, 3ops) {
   EXPECT_EQ(a.mdspan()(2, 2) + b.mdspan()(2, 2), c.mdspan()(2, 2));
 }
 
+TEST_F(MdStencilForeach, Halo3D) {
+  std::array<std::size_t, 3> shape = {xdim, ydim, 4};
+  auto dist = xhp::distribution().halo(1);
+  xhp::distributed_mdarray<T, 3> a(shape, dist), b(shape, dist);
+  xhp::iota(a, 100);
+  xhp::fill(b, 0);
+  std::array<std::size_t, 3> starts = {1, 1, 1};
+  std::array<std::size_t, 3> ends = {shape[0] - 1, shape[1] - 1,
+                                     shape[2] - 1};
+  auto in = xhp::views::submdspan(a.view(), starts, ends);
+  auto out = xhp::views::submdspan(b.view(), starts, ends);
+  // Different weights per dimension, so a wrong offset in any
+  // dimension changes the result
+  auto op = [](auto v) {
+    auto [in, out] = v;
+    out(0, 0, 0) = 100 * (in(1, 0, 0) - in(-1, 0, 0)) +
+                   10 * (in(0, 1, 0) - in(0, -1, 0)) + in(0, 0, 1) -
+                   in(0, 0, -1);
+  };
+
+  xhp::halo(a).exchange();
+  xhp::stencil_for_each(op, in, out);
+  auto mda = a.mdspan();
+  auto mdb = b.mdspan();
+  for (std::size_t i = 0; i < shape[0]; i++) {
+    for (std::size_t j = 0; j < shape[1]; j++) {
+      for (std::size_t k = 0; k < shape[2]; k++) {
+        T expected = 0;
+        if (i > 0 && i < shape[0] - 1 && j > 0 && j < shape[1] - 1 &&
+            k > 0 && k < shape[2] - 1) {
+          expected = 100 * (mda(i + 1, j, k) - mda(i - 1, j, k)) +
+                     10 * (mda(i, j + 1, k) - mda(i, j - 1, k)) +
+                     mda(i, j, k + 1) - mda(i, j, k - 1);
+        }
+        EXPECT_EQ(expected, mdb(i, j, k))
+            << fmt::format("i: {} j: {} k: {}\n", i, j, k);
+      }
+    }
+  }
+}
+
+TEST_F(MdStencilForeach, Temporal) {
+  std::array<std::size_t, 2> shape = {20, 6};
+  std::size_t steps = 5;
+  auto dist = dr::mhp::distribution().halo(2);
+  xhp::distributed_mdarray<T, 2> a(shape, dist), b(shape, dist);
+  xhp::distributed_mdarray<T, 2> c(shape, dist), d(shape, dist);
+  xhp::iota(a, 100);
+  xhp::iota(b, 200);
+  xhp::iota(c, 100);
+  xhp::iota(d, 200);
+  auto op = [](auto v) {
+    auto [in, out] = v;
+    out(0, 0) = (in(-1, 0) + in(0, -1) + in(0, 1) + in(1, 0)) / 4;
+  };
+
+  // Exchange every step
+  std::array<std::size_t, 2> starts = {1, 1};
+  std::array<std::size_t, 2> ends = {shape[0] - 1, shape[1] - 1};
+  auto in = xhp::views::submdspan(c.view(), starts, ends);
+  auto out = xhp::views::submdspan(d.view(), starts, ends);
+  auto in_array = &c, out_array = &d;
+  for (std::size_t s = 0; s < steps; s++) {
+    xhp::halo(*in_array).exchange();
+    xhp::stencil_for_each(op, in, out);
+    std::swap(in, out);
+    std::swap(in_array, out_array);
+  }
+
+  auto &result = xhp::temporal_stencil(op, a, b, steps, 1, 2);
+  EXPECT_EQ(&b, &result);
+  EXPECT_EQ(*in_array, result);
+}
+
 using MdspanUtil = Mdspan;
 
 TEST_F(MdspanUtil, Pack) {
@@ -0,0 +1,105 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+// Fixture
+template <typename T> class MergeMHP : public testing::Test {
+public:
+};
+
+TYPED_TEST_SUITE(MergeMHP, AllTypes);
+
+// a is 100..122, b is 110..132
+void overlap(auto &ops) {
+  dr::mhp::iota(ops.dist_vec1, 110);
+  rng::iota(ops.vec1, 110);
+}
+
+TYPED_TEST(MergeMHP, Merge) {
+  Ops2<TypeParam> ops(23);
+  overlap(ops);
+  TypeParam dist_out(46);
+  LocalVec<TypeParam> out(46);
+
+  std::merge(ops.vec0.begin(), ops.vec0.end(), ops.vec1.begin(),
+             ops.vec1.end(), out.begin());
+  auto dist_end =
+      dr::mhp::merge(ops.dist_vec0, ops.dist_vec1, dist_out.begin());
+  EXPECT_EQ(dist_out.end(), dist_end);
+  EXPECT_EQ(out, dist_out);
+}
+
+TYPED_TEST(MergeMHP, SetOperations) {
+  Ops2<TypeParam> ops(23);
+  overlap(ops);
+  TypeParam dist_out(46);
+  LocalVec<TypeParam> out;
+  auto &a = ops.vec0, &b = ops.vec1;
+
+  std::set_union(a.begin(), a.end(), b.begin(), b.end(),
+                 std::back_inserter(out));
+  auto dist_end =
+      dr::mhp::set_union(ops.dist_vec0, ops.dist_vec1, dist_out.begin());
+  EXPECT_TRUE(is_equal(out, rng::subrange(dist_out.begin(), dist_end)));
+
+  out.clear();
+  std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                        std::back_inserter(out));
+  dist_end =
+      dr::mhp::set_intersection(ops.dist_vec0, ops.dist_vec1, dist_out.begin());
+  EXPECT_TRUE(is_equal(out, rng::subrange(dist_out.begin(), dist_end)));
+
+  out.clear();
+  std::set_difference(a.begin(), a.end(), b.begin(), b.end(),
+                      std::back_inserter(out));
+  dist_end =
+      dr::mhp::set_difference(ops.dist_vec0, ops.dist_vec1, dist_out.begin());
+  EXPECT_TRUE(is_equal(out, rng::subrange(dist_out.begin(), dist_end)));
+}
+
+TYPED_TEST(MergeMHP, Unique) {
+  Ops1<TypeParam> ops(23);
+  auto third = [](auto &x) { x = x / 3; };
+  dr::mhp::for_each(ops.dist_vec, third);
+  rng::for_each(ops.vec, third);
+
+  auto end = std::unique(ops.vec.begin(), ops.vec.end());
+  auto dist_end = dr::mhp::unique(ops.dist_vec);
+  EXPECT_EQ(end - ops.vec.begin(), dist_end - ops.dist_vec.begin());
+  EXPECT_EQ(ops.vec, ops.dist_vec);
+}
+
+TYPED_TEST(MergeMHP, Bounds) {
+  Ops1<TypeParam> ops(23);
+  auto fifth = [](auto &x) { x = x / 5; };
+  dr::mhp::for_each(ops.dist_vec, fifth);
+  rng::for_each(ops.vec, fifth);
+  dr::mhp::sort(ops.dist_vec);
+
+  for (int v : {0, 20, 21, 22, 24, 25}) {
+    auto lower = std::lower_bound(ops.vec.begin(), ops.vec.end(), v);
+    auto upper = std::upper_bound(ops.vec.begin(), ops.vec.end(), v);
+    EXPECT_EQ(lower - ops.vec.begin(),
+              dr::mhp::lower_bound(ops.dist_vec, v) - ops.dist_vec.begin())
+        << v;
+    EXPECT_EQ(upper - ops.vec.begin(),
+              dr::mhp::upper_bound(ops.dist_vec, v) - ops.dist_vec.begin())
+        << v;
+    auto [first, last] = dr::mhp::equal_range(ops.dist_vec, v);
+    EXPECT_EQ(upper - lower, last - first) << v;
+  }
+}
+
+TYPED_TEST(MergeMHP, BoundsAfterUpdate) {
+  Ops1<TypeParam> ops(23);
+  dr::mhp::sort(ops.dist_vec);
+
+  // The cached boundary values are out of date
+  ops.dist_vec[0] = 0;
+  ops.dist_vec[22] = 1000;
+  fence();
+  EXPECT_EQ(0, dr::mhp::lower_bound(ops.dist_vec, 0) - ops.dist_vec.begin());
+  EXPECT_EQ(22, dr::mhp::lower_bound(ops.dist_vec, 200) - ops.dist_vec.begin());
+}
@@ -37,3 +37,33 @@ TYPED_TEST(ReduceMHP, RootIterators) {
         result);
   }
 }
+
+TYPED_TEST(ReduceMHP, TransformReduce) {
+  Ops1<TypeParam> ops(23);
+  auto square = [](auto x) { return x * x; };
+
+  EXPECT_EQ(std::transform_reduce(ops.vec.begin(), ops.vec.end(), 1,
+                                  std::plus{}, square),
+            dr::mhp::transform_reduce(ops.dist_vec, 1, std::plus{}, square));
+}
+
+TYPED_TEST(ReduceMHP, TransformReduceBinary) {
+  Ops2<TypeParam> ops(23);
+
+  EXPECT_EQ(std::transform_reduce(ops.vec0.begin(), ops.vec0.end(),
+                                  ops.vec1.begin(), 5),
+            dr::mhp::transform_reduce(ops.dist_vec0, ops.dist_vec1, 5));
+}
+
+TYPED_TEST(ReduceMHP, TransformReduceMulti) {
+  Ops1<TypeParam> ops(23);
+  auto min = [](auto x, auto y) { return std::min(x, y); };
+  auto max = [](auto x, auto y) { return std::max(x, y); };
+
+  auto [sum, smallest, largest] = dr::mhp::transform_reduce(
+      ops.dist_vec, std::tuple(0, 1000, 0), std::tuple(std::plus{}, min, max),
+      [](auto x) { return x; });
+  EXPECT_EQ(std::reduce(ops.vec.begin(), ops.vec.end()), sum);
+  EXPECT_EQ(100, smallest);
+  EXPECT_EQ(122, largest);
+}
@@ -0,0 +1,149 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+// Fixture
+template <typename T> class ScanByKeyMHP : public testing::Test {
+public:
+};
+
+TYPED_TEST_SUITE(ScanByKeyMHP, AllTypes);
+
+// Keys of vec0 are runs of 5 equal values
+void runs_of_5(auto &ops) {
+  auto fifth = [](auto &x) { x = x / 5; };
+  dr::mhp::for_each(ops.dist_vec0, fifth);
+  rng::for_each(ops.vec0, fifth);
+}
+
+TYPED_TEST(ScanByKeyMHP, InclusiveScanByKey) {
+  Ops2<TypeParam> ops(23);
+  runs_of_5(ops);
+  TypeParam dist_out(23);
+  LocalVec<TypeParam> out(23);
+
+  for (std::size_t i = 0; i < 23; i++) {
+    bool head = i == 0 || ops.vec0[i - 1] != ops.vec0[i];
+    out[i] = head ? ops.vec1[i] : out[i - 1] + ops.vec1[i];
+  }
+  auto dist_end =
+      dr::mhp::inclusive_scan_by_key(ops.dist_vec0, ops.dist_vec1, dist_out);
+  EXPECT_EQ(dist_out.end(), dist_end);
+  EXPECT_EQ(out, dist_out);
+}
+
+// T{} is not an identity of multiplies, so the runs that cross segments
+// must not start from it
+TYPED_TEST(ScanByKeyMHP, InclusiveScanByKeyMultiplies) {
+  std::size_t n = 3 * comm_size;
+  TypeParam dist_keys(n, 0), dist_values(n, 2), dist_out(n);
+  LocalVec<TypeParam> out(n);
+
+  out[0] = 2;
+  for (std::size_t i = 1; i < n; i++) {
+    out[i] = 2 * out[i - 1];
+  }
+  dr::mhp::inclusive_scan_by_key(dist_keys, dist_values, dist_out,
+                                 std::equal_to<>(), std::multiplies<>());
+  EXPECT_EQ(out, dist_out);
+}
+
+// Negative values, so T{} is larger than every value
+TYPED_TEST(ScanByKeyMHP, InclusiveScanByKeyMax) {
+  Ops2<TypeParam> ops(23);
+  runs_of_5(ops);
+  TypeParam dist_out(23);
+  LocalVec<TypeParam> out(23);
+  auto negate = [](auto &x) { x = -x; };
+  dr::mhp::for_each(ops.dist_vec1, negate);
+  rng::for_each(ops.vec1, negate);
+  auto max = [](auto x, auto y) { return std::max(x, y); };
+
+  for (std::size_t i = 0; i < 23; i++) {
+    bool head = i == 0 || ops.vec0[i - 1] != ops.vec0[i];
+    out[i] = head ? ops.vec1[i] : max(out[i - 1], ops.vec1[i]);
+  }
+  dr::mhp::inclusive_scan_by_key(ops.dist_vec0, ops.dist_vec1, dist_out,
+                                 std::equal_to<>(), max);
+  EXPECT_EQ(out, dist_out);
+}
+
+TYPED_TEST(ScanByKeyMHP, ExclusiveScanByKey) {
+  Ops2<TypeParam> ops(23);
+  runs_of_5(ops);
+  LocalVec<TypeParam> out(23);
+
+  for (std::size_t i = 0; i < 23; i++) {
+    bool head = i == 0 || ops.vec0[i - 1] != ops.vec0[i];
+    out[i] = head ? 3 : out[i - 1] + ops.vec1[i - 1];
+  }
+  // In place
+  dr::mhp::exclusive_scan_by_key(ops.dist_vec0, ops.dist_vec1, ops.dist_vec1,
+                                 3);
+  EXPECT_EQ(out, ops.dist_vec1);
+}
+
+TYPED_TEST(ScanByKeyMHP, ReduceByKey) {
+  Ops2<TypeParam> ops(23);
+  runs_of_5(ops);
+  TypeParam dist_keys(23), dist_values(23);
+  LocalVec<TypeParam> keys, values;
+
+  for (std::size_t i = 0; i < 23; i++) {
+    if (i > 0 && ops.vec0[i - 1] == ops.vec0[i]) {
+      values.back() += ops.vec1[i];
+    } else {
+      keys.push_back(ops.vec0[i]);
+      values.push_back(ops.vec1[i]);
+    }
+  }
+  auto [keys_end, values_end] =
+      dr::mhp::reduce_by_key(ops.dist_vec0, ops.dist_vec1, dist_keys.begin(),
+                             dist_values.begin());
+  EXPECT_EQ(rng::distance(keys), keys_end - dist_keys.begin());
+  EXPECT_EQ(rng::distance(values), values_end - dist_values.begin());
+  EXPECT_TRUE(is_equal(keys, rng::subrange(dist_keys.begin(), keys_end)));
+  EXPECT_TRUE(
+      is_equal(values, rng::subrange(dist_values.begin(), values_end)));
+}
+
+// Every segment is several scan chunks long. Runs of 1000 keys cross
+// the chunk boundaries, and the first half of the range is a single
+// run that spans several chunks and segments.
+TYPED_TEST(ScanByKeyMHP, ManyChunks) {
+  std::size_t n = comm_size * (3 * dr::mhp::__detail::scan_chunk() + 100);
+  LocalVec<TypeParam> keys(n), values(n), out(n);
+  for (std::size_t i = 0; i < n; i++) {
+    keys[i] = i < n / 2 ? 0 : i / 1000;
+    values[i] = i % 7;
+  }
+  TypeParam dist_keys(n), dist_values(n), dist_out(n);
+  dr::mhp::copy(0, keys, dist_keys.begin());
+  dr::mhp::copy(0, values, dist_values.begin());
+
+  for (std::size_t i = 0; i < n; i++) {
+    bool head = i == 0 || keys[i - 1] != keys[i];
+    out[i] = head ? values[i] : out[i - 1] + values[i];
+  }
+  dr::mhp::inclusive_scan_by_key(dist_keys, dist_values, dist_out);
+  LocalVec<TypeParam> result(n);
+  dr::mhp::copy(0, dist_out, result.begin());
+  if (comm_rank == 0) {
+    EXPECT_TRUE(out == result);
+  }
+
+  LocalVec<TypeParam> reduced;
+  for (std::size_t i = 0; i < n; i++) {
+    if (i == n - 1 || keys[i] != keys[i + 1]) {
+      reduced.push_back(out[i]);
+    }
+  }
+  TypeParam dist_reduced_keys(n), dist_reduced(n);
+  auto [keys_end, reduced_end] = dr::mhp::reduce_by_key(
+      dist_keys, dist_values, dist_reduced_keys.begin(), dist_reduced.begin());
+  EXPECT_EQ(rng::distance(reduced), keys_end - dist_reduced_keys.begin());
+  EXPECT_TRUE(
+      is_equal(reduced, rng::subrange(dist_reduced.begin(), reduced_end)));
+}
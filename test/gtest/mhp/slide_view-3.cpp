@@ -161,3 +161,61 @@ TYPED_TEST(
     }
   }
 }
+
+TYPED_TEST(Slide3, local_converts_to_correct_pointers_with_asymmetric_halo) {
+  TypeParam dv(6, dr::mhp::distribution().halo(2, 0));
+  iota(dv, 1);
+  dv.halo().exchange();
+
+  // The window ends with the element it belongs to
+  auto dv_sliding_view = xhp::views::sliding(dv, 3);
+  for (auto &&ls : dr::mhp::local_segments(dv_sliding_view)) {
+    switch (dr::mhp::default_comm().rank()) {
+    case 0:
+      EXPECT_EQ(0, rng::size(ls));
+      break;
+    case 1:
+      EXPECT_EQ(2, rng::size(ls));
+      EXPECT_TRUE(equal({1, 2, 3}, ls[0]));
+      EXPECT_TRUE(equal({2, 3, 4}, ls[1]));
+      break;
+    case 2:
+      EXPECT_EQ(2, rng::size(ls));
+      EXPECT_TRUE(equal({3, 4, 5}, ls[0]));
+      EXPECT_TRUE(equal({4, 5, 6}, ls[1]));
+      break;
+    default:
+      EXPECT_TRUE(false);
+    }
+  }
+}
+
+TYPED_TEST(Slide3, local_wraps_with_periodic_halo) {
+  if (options.count("device-memory")) {
+    return;
+  }
+  TypeParam dv(6, dr::mhp::distribution().halo(1).periodic(true));
+  iota(dv, 1);
+  dv.halo().exchange();
+
+  switch (dr::mhp::default_comm().rank()) {
+  case 0: {
+    // The last element is in the prev halo
+    auto p = (dv.begin() + 5).local();
+    EXPECT_EQ(6, p[0]);
+    EXPECT_EQ(1, p[1]);
+    EXPECT_EQ(2, p[2]);
+    break;
+  }
+  case 2: {
+    // The first element is in the next halo
+    auto p = (dv.begin() + 0).local();
+    EXPECT_EQ(1, p[0]);
+    EXPECT_EQ(5, p[-2]);
+    EXPECT_EQ(6, p[-1]);
+    break;
+  }
+  default:
+    break;
+  }
+}
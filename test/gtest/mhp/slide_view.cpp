@@ -255,3 +255,20 @@ TEST(ComplexSlide, transform_works_between_vectors_of_arrays) {
 }
 
 // rest of tests is in the Slide3 suite
+
+TYPED_TEST(Slide, slide_works_with_asymmetric_halo) {
+  TypeParam dv_in(10, dr::mhp::distribution().halo(2, 0));
+  TypeParam dv_out(10, 0);
+  iota(dv_in, 0);
+  dv_in.halo().exchange();
+
+  // Upwind window, the element and the 2 before it
+  xhp::transform(xhp::views::sliding(dv_in, 3), rng::begin(dv_out) + 2,
+                 [](auto &&r) { return rng::accumulate(r, 0); });
+
+  EXPECT_EQ(0, dv_out[0]);
+  EXPECT_EQ(0, dv_out[1]);
+  for (int i = 2; i < 10; i++) {
+    EXPECT_EQ(i - 2 + i - 1 + i, dv_out[i]);
+  }
+}
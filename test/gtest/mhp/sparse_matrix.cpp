@@ -0,0 +1,78 @@
+// SPDX-FileCopyrightText: Intel Corporation
+//
+// SPDX-License-Identifier: BSD-3-Clause
+
+#include "xhp-tests.hpp"
+
+using Matrix = dr::mhp::sparse_matrix<double>;
+using Entries = std::vector<std::tuple<std::size_t, std::size_t, double>>;
+
+// Dense reference for y = A * iota(0)
+static auto dense_gemv(std::size_t m, const Entries &entries) {
+  std::vector<double> y(m, 0);
+  for (auto [i, j, v] : entries) {
+    y[i] += v * j;
+  }
+  return y;
+}
+
+static void check_gemv(std::size_t m, std::size_t n, const Entries &entries) {
+  Matrix a({m, n}, entries);
+  dr::mhp::distributed_vector<double> x(n), y(m);
+  dr::mhp::iota(x, 0);
+  dr::mhp::fill(y, -1);
+
+  dr::mhp::gemv(y, a, x);
+
+  EXPECT_EQ(entries.size(), a.nnz());
+  auto ref = dense_gemv(m, entries);
+  for (std::size_t i = 0; i < m; i++) {
+    EXPECT_EQ(ref[i], y[i]) << "row: " << i;
+  }
+}
+
+TEST(MhpTests, SparseMatrixGemvTridiagonal) {
+  std::size_t n = 17;
+  Entries entries;
+  for (std::size_t i = 0; i < n; i++) {
+    entries.emplace_back(i, i, 2);
+    if (i > 0) {
+      entries.emplace_back(i, i - 1, -1);
+    }
+    if (i < n - 1) {
+      entries.emplace_back(i, i + 1, -1);
+    }
+  }
+  check_gemv(n, n, entries);
+}
+
+TEST(MhpTests, SparseMatrixGemvRectangular) {
+  // Every row reads columns owned by other ranks
+  std::size_t m = 13, n = 29;
+  Entries entries;
+  for (std::size_t i = 0; i < m; i++) {
+    for (std::size_t j = i % 3; j < n; j += 4) {
+      entries.emplace_back(i, j, double(i + 1));
+    }
+  }
+  check_gemv(m, n, entries);
+}
+
+TEST(MhpTests, SparseMatrixGemvRepeated) {
+  std::size_t n = 20;
+  Entries entries;
+  for (std::size_t i = 0; i < n; i++) {
+    entries.emplace_back(i, n - 1 - i, 1);
+  }
+  Matrix a({n, n}, entries);
+  dr::mhp::distributed_vector<double> x(n), y(n);
+  dr::mhp::iota(x, 0);
+
+  // Reverses x, twice
+  dr::mhp::gemv(y, a, x);
+  dr::mhp::gemv(x, a, y);
+  for (std::size_t i = 0; i < n; i++) {
+    EXPECT_EQ(double(n - 1 - i), y[i]);
+    EXPECT_EQ(double(i), x[i]);
+  }
+}